@@ -0,0 +1,211 @@
+//  ***************************************************************************
+/// @file    baked_schedule_check.c
+/// @author  NeoProg
+/// @brief   Host check of baked schedule replay
+/// @note    Build: gcc -O2 -DSTM32F373xC -I../src -I../src/tools -I../src/drivers -I../CMSIS/Include -I../CMSIS/STM32F3xx
+///                 baked_schedule_check.c ../src/kinematic.c ../src/body_pose.c ../src/gait_generator.c
+///                 ../src/trajectory_kernel.c -lm -o baked_schedule_check
+///          Motion core is compiled into tool with baked schedule. Sequence
+///          tables and walk of each gait are played with LOOPS_COUNT main
+///          loops twice: by live calculation (reference) and with baked
+///          schedule. Servo pulse widths are compared on every PWM period,
+///          error should be less MAX_PULSE_WIDTH_ERROR. Idle time is set by
+///          motion core calls per period: without idle time rows are baked
+///          by catch up budget only. Replayed ticks and motions baked on
+///          last main loop (re-bake of looped motions) are reported. Build
+///          with -DMOTION_CORE_BAKED_SCHEDULE_CATCH_UP_ROWS=0 for check
+///          live calculation of ticks without baked rows
+//  ***************************************************************************
+#include "motion_core.c"
+#include "gait_sequences.h"
+#include <stdio.h>
+#include <string.h>
+
+#define EEPROM_SIZE                         (4096)      // 24C32
+#define LOOPS_COUNT                         (3)
+#define MAX_PERIODS_COUNT                   (8192)
+#define PULSE_WIDTH_PER_DEGREE              (2000.0f / 270.0f)  // DS3218MG 270, [us]
+#define MAX_PULSE_WIDTH_ERROR               (4)         // Replay vs live (servo dead band), [us]
+
+
+typedef struct {
+    const char* name;
+    const motion_config_t* motion_list;
+    uint32_t main_motions_begin;
+    uint32_t finalize_motions_begin;
+    uint32_t total_motions_count;
+    const gait_params_t* gait_params;
+} motion_set_t;
+
+typedef struct {
+    uint32_t periods_count;
+    uint32_t replay_ticks_count;
+    uint32_t live_ticks_count;
+    uint32_t rebaked_count;             // Motions baked on last main loop
+    int32_t  max_error;                 // Replay vs live, [us]
+} check_report_t;
+
+
+static uint8_t eeprom_image[EEPROM_SIZE];
+static uint16_t pulse_widths[SUPPORT_SERVO_COUNT];
+static uint16_t live_pulse_widths[MAX_PERIODS_COUNT][SUPPORT_SERVO_COUNT];
+
+
+//
+// Firmware stubs. Geometry is taken from robot description defaults, protection is disabled
+//
+uint64_t synchro = 0;
+uint64_t get_time_ms(void) { return synchro * 1000 / PWM_FREQUENCY_HZ; }
+uint32_t get_cpu_cycles(void) { return 0; }
+uint32_t pwm_get_frequency(void) { return PWM_FREQUENCY_HZ; }
+void sysmon_set_error(uint32_t error) {}
+static uint32_t disabled_modules = 0;
+void sysmon_disable_module(uint32_t module) { disabled_modules |= module; }
+bool sysmon_is_module_disable(uint32_t module) { return (disabled_modules & module) != 0; }
+bool config_read_16(uint32_t address, uint16_t* buffer) {
+    if (address + 2 > EEPROM_SIZE) return false;
+    memcpy(buffer, &eeprom_image[address], 2);
+    return true;
+}
+void servo_driver_init(void) {}
+void servo_driver_power_on(void) {}
+uint32_t servo_driver_convert_angle(uint32_t servo, float angle) { return (uint32_t)lroundf(1500.0f + angle * PULSE_WIDTH_PER_DEGREE); }
+void servo_driver_move(uint32_t servo, float angle) { pulse_widths[servo] = servo_driver_convert_angle(servo, angle); }
+void servo_driver_move_pulse_width(uint32_t servo, uint32_t pulse_width) { pulse_widths[servo] = pulse_width; }
+
+
+//  ***************************************************************************
+/// @brief  Initialize EEPROM image: defaults from robot description, protection is disabled
+//  ***************************************************************************
+static void init_eeprom_image(void) {
+
+    static const uint32_t protection_offsets[] = {
+        MM_LIMB_PROTECTION_COXA_MIN_ANGLE_OFFSET,  MM_LIMB_PROTECTION_COXA_MAX_ANGLE_OFFSET,
+        MM_LIMB_PROTECTION_FEMUR_MIN_ANGLE_OFFSET, MM_LIMB_PROTECTION_FEMUR_MAX_ANGLE_OFFSET,
+        MM_LIMB_PROTECTION_TIBIA_MIN_ANGLE_OFFSET, MM_LIMB_PROTECTION_TIBIA_MAX_ANGLE_OFFSET
+    };
+    memset(eeprom_image, 0xFF, sizeof(eeprom_image));
+    for (uint32_t i = 0; i < sizeof(protection_offsets) / sizeof(protection_offsets[0]); ++i) {
+        int16_t angle = (i & 0x01) ? +720 : -720;
+        memcpy(&eeprom_image[MM_LIMB_CONFIG_BASE_EE_ADDRESS + protection_offsets[i]], &angle, sizeof(angle));
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Play motion set
+/// @param  set: motion set
+/// @param  is_baked: use baked schedule, false - live calculation
+/// @param  idle_calls: motion core calls in idle time per PWM period
+/// @param  report: check report
+/// @return true - success, false - motion core error or too long motion set
+//  ***************************************************************************
+static bool play_motion_set(const motion_set_t* set, bool is_baked, uint32_t idle_calls, check_report_t* report) {
+
+    disabled_modules = 0;
+    motion_core_init(sequence_walk_neutral_positions);
+    motion_core_reset_trajectory_config();
+    motion_core_update_trajectory_config(1, 110);
+    motion_core_set_gait_params(set->gait_params);
+    g_baked_replay_ticks_count = 0;
+    g_baked_live_ticks_count = 0;
+
+    uint32_t main_motions_count = set->finalize_motions_begin - set->main_motions_begin;
+    uint32_t motions_count = set->main_motions_begin + main_motions_count * LOOPS_COUNT + set->total_motions_count - set->finalize_motions_begin;
+    uint32_t allocations_count = 0;
+    uint32_t periods_count = 0;
+    for (uint32_t m = 0; m < motions_count; ++m) {
+
+        uint32_t motion = m;
+        if (m >= set->main_motions_begin + main_motions_count * LOOPS_COUNT) {
+            motion = m - main_motions_count * (LOOPS_COUNT - 1);
+        }
+        else if (m >= set->main_motions_begin) {
+            motion = set->main_motions_begin + (m - set->main_motions_begin) % main_motions_count;
+        }
+        if (m == set->main_motions_begin + main_motions_count * (LOOPS_COUNT - 1)) {
+            allocations_count = g_baked_allocations_count; // Main motions are baked on previous loops
+        }
+        motion_core_start_motion(&set->motion_list[motion]);
+        if (is_baked == false) {
+            g_baked_motion = NULL;
+        }
+
+        while (motion_core_is_motion_complete() == false) {
+            ++synchro;
+            for (uint32_t s = 0; s < 3 + idle_calls; ++s) {
+                motion_core_process();
+            }
+            if (sysmon_is_module_disable(SYSMON_MODULE_MOTION_DRIVER) == true || periods_count >= MAX_PERIODS_COUNT) {
+                return false;
+            }
+            if (is_baked == false) {
+                memcpy(live_pulse_widths[periods_count], pulse_widths, sizeof(pulse_widths));
+            }
+            else {
+                for (uint32_t i = 0; i < SUPPORT_SERVO_COUNT; ++i) {
+                    int32_t error = abs((int32_t)pulse_widths[i] - (int32_t)live_pulse_widths[periods_count][i]);
+                    if (error > report->max_error) {
+                        report->max_error = error;
+                    }
+                }
+            }
+            ++periods_count;
+        }
+        if (m + 1 == set->main_motions_begin + main_motions_count * LOOPS_COUNT) {
+            report->rebaked_count = g_baked_allocations_count - allocations_count;
+        }
+    }
+    report->periods_count = periods_count;
+    report->replay_ticks_count = g_baked_replay_ticks_count;
+    report->live_ticks_count = g_baked_live_ticks_count;
+    return true;
+}
+
+int main(void) {
+
+    init_eeprom_image();
+
+    static motion_config_t gait_motions[SUPPORT_GAIT_COUNT][GAIT_TOTAL_MOTIONS_COUNT];
+    motion_set_t sets[32];
+    uint32_t sets_count = 0;
+
+#define ADD_SEQUENCE(seq)   sets[sets_count++] = (motion_set_t){ #seq, seq.motion_list, seq.main_motions_begin, seq.finalize_motions_begin, seq.total_motions_count, NULL }
+    ADD_SEQUENCE(sequence_up_down);
+    ADD_SEQUENCE(sequence_push_pull);
+    ADD_SEQUENCE(sequence_attack_left);
+    ADD_SEQUENCE(sequence_attack_right);
+    ADD_SEQUENCE(sequence_dance);
+    ADD_SEQUENCE(sequence_rotate_x);
+    ADD_SEQUENCE(sequence_rotate_z);
+#undef ADD_SEQUENCE
+
+    static const char* gait_names[SUPPORT_GAIT_COUNT] = { "walk_tripod", "walk_ripple", "walk_wave" };
+    for (uint32_t g = 0; g < SUPPORT_GAIT_COUNT; ++g) {
+        if (gait_generator_build_sequence((gait_type_t)g, TIME_DIR_DIRECT, 1, 110, sequence_walk_neutral_positions, gait_motions[g]) == false) {
+            printf("%s: build failed\n", gait_names[g]);
+            return 1;
+        }
+        sets[sets_count++] = (motion_set_t){ gait_names[g], gait_motions[g], GAIT_PREPARE_MOTIONS_COUNT,
+                                             GAIT_PREPARE_MOTIONS_COUNT + GAIT_MAIN_MOTIONS_COUNT, GAIT_TOTAL_MOTIONS_COUNT,
+                                             gait_generator_get_params((gait_type_t)g) };
+    }
+
+    bool is_passed = true;
+    printf("motion set            | idle calls | periods | replayed | live | re-baked | max error [us]\n");
+    for (uint32_t s = 0; s < sets_count; ++s) {
+        for (uint32_t idle_calls = 0; idle_calls <= 4; idle_calls += 4) {
+
+            check_report_t live_report = {0};
+            check_report_t report = {0};
+            if (play_motion_set(&sets[s], false, idle_calls, &live_report) == false || play_motion_set(&sets[s], true, idle_calls, &report) == false) {
+                printf("%s: motion core error\n", sets[s].name);
+                return 1;
+            }
+            is_passed = is_passed && report.periods_count == live_report.periods_count && report.max_error <= MAX_PULSE_WIDTH_ERROR;
+            printf("%-21s | %10u | %7u | %8u | %4u | %8u | %u\n", sets[s].name, idle_calls, report.periods_count,
+                   report.replay_ticks_count, report.live_ticks_count, report.rebaked_count, report.max_error);
+        }
+    }
+    printf("%s\n", is_passed ? "baked schedule matches live calculation" : "BAKED SCHEDULE ERROR IS OUT OF TOLERANCE");
+    return is_passed ? 0 : 1;
+}
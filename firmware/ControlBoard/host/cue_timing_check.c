@@ -0,0 +1,175 @@
+//  ***************************************************************************
+/// @file    cue_timing_check.c
+/// @author  NeoProg
+/// @brief   Host check of choreography cue start time
+/// @note    Build: gcc -O2 -DSTM32F373xC -I../src -I../src/tools -I../src/drivers -I../CMSIS/Include -I../CMSIS/STM32F3xx
+///                 cue_timing_check.c ../src/sequences_engine.c ../src/transition_planner.c ../src/sequence_codec.c
+///                 ../src/sequences_storage.c ../src/kinematic.c ../src/body_pose.c ../src/gait_generator.c
+///                 ../src/trajectory_kernel.c -lm -o cue_timing_check
+///          Motion core and cue scheduler are compiled into tool. Show is
+///          played for each gait from down position: sequences are changed
+///          by cues while current sequence is in progress. Start time of
+///          first motion of each cue sequence is found on its first tick
+///          from PWM period, motion tick and motion clock offset, it should
+///          be equal cue time. Wait of first motion (transition is completed
+///          before cue time) is reported
+//  ***************************************************************************
+#include "motion_core.c"
+#include "cue_scheduler.c"
+#include <string.h>
+
+#define EEPROM_SIZE                         (4096)      // 24C32
+#define LOOP_ITERATIONS_PER_PERIOD          (8)         // Main loop iterations per PWM period
+#define MAX_SHOW_PERIODS                    (60 * PWM_FREQUENCY_HZ)
+#define MAX_START_ERROR                     (0.01)      // Max first motion start error, [PWM periods]
+#define SHOW_DELAY                          (1000)      // [ms]
+
+
+typedef struct {
+    uint32_t cue;
+    uint64_t motion_start_period;       // Period of first motion start by sequences engine
+    double   start_error;               // First tick start time - cue time, [PWM periods]
+    uint32_t wait_periods;              // First motion wait of cue time
+} cue_report_t;
+
+
+static uint8_t eeprom_image[EEPROM_SIZE];
+
+static const cue_t show[] = {
+    { .start_time = 200,   .sequence = SEQUENCE_UP },
+    { .start_time = 4003,  .sequence = SEQUENCE_DIRECT, .curvature = 1, .distance = 110 },
+    { .start_time = 9001,  .sequence = SEQUENCE_UP_DOWN },
+    { .start_time = 12502, .sequence = SEQUENCE_PUSH_PULL, .speed = 150 },
+    { .start_time = 16000, .sequence = SEQUENCE_DANCE, .speed = 100 },
+    { .start_time = 22001, .sequence = SEQUENCE_REVERSE, .curvature = 1, .distance = 110 },
+    { .start_time = 26502, .sequence = SEQUENCE_ROTATE_X },
+    { .start_time = 30001, .sequence = SEQUENCE_ATTACK_LEFT },
+    { .start_time = 34003, .sequence = SEQUENCE_DIRECT, .curvature = 1000, .distance = 80 },
+    { .start_time = 38000, .sequence = SEQUENCE_DOWN }
+};
+#define SHOW_CUES_COUNT                     (sizeof(show) / sizeof(show[0]))
+
+
+//
+// Firmware stubs. Geometry is taken from robot description defaults, protection is disabled
+//
+uint64_t synchro = 0;
+uint64_t get_time_ms(void) { return synchro * 1000 / PWM_FREQUENCY_HZ; }
+uint32_t get_cpu_cycles(void) { return 0; }
+uint32_t pwm_get_frequency(void) { return PWM_FREQUENCY_HZ; }
+void sysmon_set_error(uint32_t error) {}
+static uint32_t disabled_modules = 0;
+void sysmon_disable_module(uint32_t module) { disabled_modules |= module; }
+bool sysmon_is_module_disable(uint32_t module) { return (disabled_modules & module) != 0; }
+bool config_read(uint32_t address, uint8_t* buffer, uint32_t bytes_count) {
+    if (address + bytes_count > EEPROM_SIZE) return false;
+    memcpy(buffer, &eeprom_image[address], bytes_count);
+    return true;
+}
+bool config_write(uint32_t address, uint8_t* data, uint32_t bytes_count) { return false; }
+bool config_read_16(uint32_t address, uint16_t* buffer) { return config_read(address, (uint8_t*)buffer, 2); }
+void servo_driver_init(void) {}
+void servo_driver_power_on(void) {}
+void servo_driver_move(uint32_t servo, float angle) {}
+void servo_driver_move_pulse_width(uint32_t servo, uint32_t pulse_width) {}
+uint32_t servo_driver_convert_angle(uint32_t servo, float angle) { return 0; }
+
+
+//  ***************************************************************************
+/// @brief  Initialize EEPROM image: defaults from robot description, protection is disabled
+//  ***************************************************************************
+static void init_eeprom_image(void) {
+
+    static const uint32_t protection_offsets[] = {
+        MM_LIMB_PROTECTION_COXA_MIN_ANGLE_OFFSET,  MM_LIMB_PROTECTION_COXA_MAX_ANGLE_OFFSET,
+        MM_LIMB_PROTECTION_FEMUR_MIN_ANGLE_OFFSET, MM_LIMB_PROTECTION_FEMUR_MAX_ANGLE_OFFSET,
+        MM_LIMB_PROTECTION_TIBIA_MIN_ANGLE_OFFSET, MM_LIMB_PROTECTION_TIBIA_MAX_ANGLE_OFFSET
+    };
+    memset(eeprom_image, 0xFF, sizeof(eeprom_image));
+    for (uint32_t i = 0; i < sizeof(protection_offsets) / sizeof(protection_offsets[0]); ++i) {
+        int16_t angle = (i & 0x01) ? +720 : -720;
+        memcpy(&eeprom_image[MM_LIMB_CONFIG_BASE_EE_ADDRESS + protection_offsets[i]], &angle, sizeof(angle));
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Play show with gait
+/// @param  gait: gait type for walk sequences
+/// @param  reports: report of each started cue
+/// @return started cues count
+//  ***************************************************************************
+static uint32_t play_show(gait_type_t gait, cue_report_t* reports) {
+
+    disabled_modules = 0;
+    synchro = 1;
+    motion_core_set_speed_multiplier(1.0f);
+    sequences_engine_init();
+    sequences_engine_select_gait(gait);
+
+    cue_scheduler_clear();
+    for (uint32_t i = 0; i < SHOW_CUES_COUNT; ++i) {
+        cue_scheduler_write_cue(i, &show[i]);
+    }
+    uint64_t show_period = synchro;
+    cue_scheduler_start(SHOW_DELAY);
+
+    uint32_t started_count = 0;
+    uint64_t motion_start_period = 0;
+    while (is_show_running == true && synchro < show_period + MAX_SHOW_PERIODS) {
+        ++synchro;
+        for (uint32_t s = 0; s < LOOP_ITERATIONS_PER_PERIOD; ++s) {
+
+            cue_scheduler_process();
+
+            bool is_wait_started = (g_motion_start_period != 0);
+            sequences_engine_process();
+            if (is_wait_started == false && g_motion_start_period != 0) {
+                motion_start_period = synchro;
+            }
+
+            bool is_wait = (g_motion_start_period != 0);
+            motion_core_process();
+            if (is_wait == true && g_motion_start_period == 0) {
+
+                // First tick: motion clock is started at (period - tick - motion time offset)
+                const cue_t* cue = &cue_list[next_cue - 1];
+                double cue_period = (double)show_period + (double)(SHOW_DELAY + cue->start_time) * PWM_FREQUENCY_HZ / 1000.0;
+                double offset = (g_motion_time_begin - (float)g_motion_config.motion_time) / g_motion_time_step;
+                reports[started_count].cue = next_cue - 1;
+                reports[started_count].motion_start_period = motion_start_period;
+                reports[started_count].start_error = (double)synchro - (double)g_motion_tick - offset - cue_period;
+                reports[started_count].wait_periods = (uint32_t)(synchro - motion_start_period);
+                ++started_count;
+            }
+            if (disabled_modules != 0) {
+                return started_count;
+            }
+        }
+    }
+    return started_count;
+}
+
+int main(void) {
+
+    init_eeprom_image();
+
+    static const char* gait_names[SUPPORT_GAIT_COUNT] = { "tripod", "ripple", "wave" };
+    bool is_passed = true;
+    printf("gait     | cue | sequence | cue time [ms] | wait [periods] | start error [periods]\n");
+    for (uint32_t g = 0; g < SUPPORT_GAIT_COUNT; ++g) {
+
+        cue_report_t reports[SHOW_CUES_COUNT];
+        uint32_t started_count = play_show((gait_type_t)g, reports);
+        for (uint32_t i = 0; i < started_count; ++i) {
+            const cue_t* cue = &cue_list[reports[i].cue];
+            printf("%-8s | %3u | %8u | %13u | %14u | %+.4f\n", gait_names[g], reports[i].cue, (uint32_t)cue->sequence,
+                   cue->start_time, reports[i].wait_periods, reports[i].start_error);
+            is_passed = is_passed && fabs(reports[i].start_error) <= MAX_START_ERROR;
+        }
+        printf("%-8s | started %u of %u cues, max late %u periods%s\n", gait_names[g], started_count, (uint32_t)SHOW_CUES_COUNT,
+               max_late_periods, (disabled_modules != 0) ? ", MODULE ERROR" : "");
+        is_passed = is_passed && started_count == SHOW_CUES_COUNT && max_late_periods == 0 && disabled_modules == 0;
+    }
+    printf("%s\n", is_passed ? "cue sequences start at cue time" : "CUE START TIME ERROR");
+    return is_passed ? 0 : 1;
+}
@@ -0,0 +1,244 @@
+//  ***************************************************************************
+/// @file    gait_preempt_check.c
+/// @author  NeoProg
+/// @brief   Host check of walk interruption at every gait phase
+/// @note    Build: gcc -O2 -DSTM32F373xC -DMOTION_CORE_BAKED_SCHEDULE_ENABLE=0 -I../src -I../src/tools -I../src/drivers
+///                 -I../CMSIS/Include -I../CMSIS/STM32F3xx gait_preempt_check.c ../src/kinematic.c ../src/body_pose.c
+///                 ../src/gait_generator.c ../src/trajectory_kernel.c -lm -o gait_preempt_check
+///          Motion core is compiled into tool. Walk sequence of each gait is
+///          played and sequence change is requested on every tick of prepare
+///          and main motions. Interruption is handled same as sequences
+///          engine: walk is preempted by first finalize motion if limbs held
+///          by it are not lifted, else walk is continued. Limbs on ground
+///          are counted on every period of finalize motions, at least half
+///          of limbs should be on ground. Check is repeated without lifted
+///          limbs condition for show that unsafe interruptions are detected
+//  ***************************************************************************
+#include "motion_core.c"
+#include "gait_sequences.h"
+#include <stdio.h>
+#include <string.h>
+
+#define EEPROM_SIZE                         (4096)      // 24C32
+#define GROUND_TOLERANCE                    (0.01f)     // Max height of limb on ground (rounding error), [mm]
+#define MIN_SUPPORT_LIMBS_COUNT             (SUPPORT_LIMBS_COUNT / 2)
+#define MAX_PERIODS_PER_MOTION              (20000)
+
+
+typedef struct {
+    uint32_t points_count;              // Interruption requests
+    uint32_t unsafe_count;              // Requests with less MIN_SUPPORT_LIMBS_COUNT limbs on ground while finalize
+    uint32_t min_support_count;         // Min limbs on ground while finalize
+    uint32_t max_wait_periods;          // Max delay of preemption, [PWM periods]
+} check_report_t;
+
+
+static uint8_t eeprom_image[EEPROM_SIZE];
+
+
+//
+// Firmware stubs. Geometry is taken from robot description defaults, protection is disabled
+//
+uint64_t synchro = 0;
+uint64_t get_time_ms(void) { return synchro * 1000 / PWM_FREQUENCY_HZ; }
+uint32_t get_cpu_cycles(void) { return 0; }
+uint32_t pwm_get_frequency(void) { return PWM_FREQUENCY_HZ; }
+void sysmon_set_error(uint32_t error) {}
+static uint32_t disabled_modules = 0;
+void sysmon_disable_module(uint32_t module) { disabled_modules |= module; }
+bool sysmon_is_module_disable(uint32_t module) { return (disabled_modules & module) != 0; }
+bool config_read_16(uint32_t address, uint16_t* buffer) {
+    if (address + 2 > EEPROM_SIZE) return false;
+    memcpy(buffer, &eeprom_image[address], 2);
+    return true;
+}
+void servo_driver_init(void) {}
+void servo_driver_power_on(void) {}
+void servo_driver_move(uint32_t servo, float angle) {}
+void servo_driver_move_pulse_width(uint32_t servo, uint32_t pulse_width) {}
+uint32_t servo_driver_convert_angle(uint32_t servo, float angle) { return 0; }
+
+
+//  ***************************************************************************
+/// @brief  Initialize EEPROM image: defaults from robot description, protection is disabled
+//  ***************************************************************************
+static void init_eeprom_image(void) {
+
+    static const uint32_t protection_offsets[] = {
+        MM_LIMB_PROTECTION_COXA_MIN_ANGLE_OFFSET,  MM_LIMB_PROTECTION_COXA_MAX_ANGLE_OFFSET,
+        MM_LIMB_PROTECTION_FEMUR_MIN_ANGLE_OFFSET, MM_LIMB_PROTECTION_FEMUR_MAX_ANGLE_OFFSET,
+        MM_LIMB_PROTECTION_TIBIA_MIN_ANGLE_OFFSET, MM_LIMB_PROTECTION_TIBIA_MAX_ANGLE_OFFSET
+    };
+    memset(eeprom_image, 0xFF, sizeof(eeprom_image));
+    for (uint32_t i = 0; i < sizeof(protection_offsets) / sizeof(protection_offsets[0]); ++i) {
+        int16_t angle = (i & 0x01) ? +720 : -720;
+        memcpy(&eeprom_image[MM_LIMB_CONFIG_BASE_EE_ADDRESS + protection_offsets[i]], &angle, sizeof(angle));
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Play one PWM period
+//  ***************************************************************************
+static bool play_period(void) {
+    ++synchro;
+    for (uint32_t s = 0; s < 3; ++s) {
+        motion_core_process();
+    }
+    return sysmon_is_module_disable(SYSMON_MODULE_MOTION_DRIVER) == false;
+}
+
+//  ***************************************************************************
+/// @brief  Count limbs on ground
+//  ***************************************************************************
+static uint32_t count_support_limbs(void) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        if (g_limbs.y[i] - sequence_walk_neutral_positions[i].y <= GROUND_TOLERANCE) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+//  ***************************************************************************
+/// @brief  Check preemption condition same as sequences engine
+//  ***************************************************************************
+static bool is_preemptible(const motion_config_t* finalize, bool is_lift_checked) {
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        if (is_lift_checked && finalize->trajectories[i] == TRAJECTORY_XYZ_HOLD && motion_core_is_limb_lifted(i) == true) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Play walk and request sequence change on tick of prepare or main motion
+/// @param  motion_list: walk sequence motions (GAIT_TOTAL_MOTIONS_COUNT items)
+/// @param  request_motion: motion index of request
+/// @param  request_tick: motion tick of request
+/// @param  is_lift_checked: use lifted limbs condition for preemption
+/// @param  report: check report
+/// @return true - success, false - motion core error or request tick is out of motion
+//  ***************************************************************************
+static bool play_walk(const motion_config_t* motion_list, uint32_t request_motion, uint32_t request_tick, bool is_lift_checked, check_report_t* report) {
+
+    disabled_modules = 0;
+    motion_core_init(sequence_walk_neutral_positions);
+    motion_core_reset_trajectory_config();
+
+    const motion_config_t* finalize = &motion_list[GAIT_PREPARE_MOTIONS_COUNT + GAIT_MAIN_MOTIONS_COUNT];
+    uint32_t motion = 0;
+    motion_core_start_motion(&motion_list[motion]);
+
+    // Play to request
+    while (motion < request_motion || g_motion_tick < request_tick) {
+        if (motion_core_is_motion_complete() == true) {
+            if (motion == request_motion) {
+                return false;
+            }
+            motion_core_start_motion(&motion_list[++motion]);
+        }
+        if (play_period() == false) {
+            return false;
+        }
+    }
+
+    // Wait preemption or motion completion (walk main motion goes to finalize after cycle)
+    uint32_t wait_periods = 0;
+    while (true) {
+        if (motion_core_is_motion_complete() == true) {
+            if (motion + 1 < GAIT_PREPARE_MOTIONS_COUNT + GAIT_MAIN_MOTIONS_COUNT) {
+                motion_core_start_motion(&motion_list[++motion]);
+            }
+            else {
+                motion_core_start_motion(finalize);
+                break;
+            }
+        }
+        if (is_preemptible(finalize, is_lift_checked) == true) {
+            motion_core_preempt_motion(finalize);
+            break;
+        }
+        if (play_period() == false || ++wait_periods > MAX_PERIODS_PER_MOTION) {
+            return false;
+        }
+    }
+    if (wait_periods > report->max_wait_periods) {
+        report->max_wait_periods = wait_periods;
+    }
+
+    // Play finalize motions
+    uint32_t min_support_count = SUPPORT_LIMBS_COUNT;
+    for (uint32_t k = 0; k < GAIT_FINALIZE_MOTIONS_COUNT; ++k) {
+        if (k != 0) {
+            motion_core_start_motion(&finalize[k]);
+        }
+        uint32_t periods_count = 0;
+        while (motion_core_is_motion_complete() == false) {
+            if (play_period() == false || ++periods_count > MAX_PERIODS_PER_MOTION) {
+                return false;
+            }
+            uint32_t support_count = count_support_limbs();
+            if (support_count < min_support_count) {
+                min_support_count = support_count;
+            }
+        }
+    }
+
+    ++report->points_count;
+    if (min_support_count < MIN_SUPPORT_LIMBS_COUNT) {
+        ++report->unsafe_count;
+    }
+    if (min_support_count < report->min_support_count) {
+        report->min_support_count = min_support_count;
+    }
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Request sequence change on every tick of prepare and main motions
+//  ***************************************************************************
+static bool check_gait(gait_type_t gait, bool is_lift_checked, check_report_t* report) {
+
+    static motion_config_t motion_list[GAIT_TOTAL_MOTIONS_COUNT];
+    if (gait_generator_build_sequence(gait, TIME_DIR_DIRECT, 1, 110, sequence_walk_neutral_positions, motion_list) == false) {
+        return false;
+    }
+    motion_core_set_speed_multiplier(1.0f);
+    motion_core_update_trajectory_config(1, 110);
+    motion_core_set_gait_params(gait_generator_get_params(gait));
+
+    memset(report, 0, sizeof(check_report_t));
+    report->min_support_count = SUPPORT_LIMBS_COUNT;
+    for (uint32_t m = 0; m < GAIT_PREPARE_MOTIONS_COUNT + GAIT_MAIN_MOTIONS_COUNT; ++m) {
+        for (uint32_t tick = 0; play_walk(motion_list, m, tick, is_lift_checked, report) == true; ++tick);
+        if (sysmon_is_module_disable(SYSMON_MODULE_MOTION_DRIVER) == true) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(void) {
+
+    init_eeprom_image();
+
+    static const char* gait_names[SUPPORT_GAIT_COUNT] = { "tripod", "ripple", "wave" };
+    bool is_passed = true;
+    printf("gait     | requests | unsafe | min support | max wait [periods] | unsafe without lift check\n");
+    for (uint32_t g = 0; g < SUPPORT_GAIT_COUNT; ++g) {
+
+        check_report_t report;
+        check_report_t unchecked_report;
+        if (check_gait((gait_type_t)g, true, &report) == false || check_gait((gait_type_t)g, false, &unchecked_report) == false) {
+            printf("%s: motion core error\n", gait_names[g]);
+            return 1;
+        }
+        is_passed = is_passed && report.points_count != 0 && report.unsafe_count == 0;
+        printf("%-8s | %8u | %6u | %11u | %18u | %u\n", gait_names[g], report.points_count, report.unsafe_count,
+               report.min_support_count, report.max_wait_periods, unchecked_report.unsafe_count);
+    }
+    printf("%s\n", is_passed ? "walk interruption keeps support limbs on ground" : "UNSAFE WALK INTERRUPTION");
+    return is_passed ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+//  ***************************************************************************
+/// @file    ik_benchmark.c
+/// @author  NeoProg
+/// @brief   Host benchmark and accuracy report for IK backends
+/// @note    Build: gcc -O2 -I../src -I../src/tools ik_benchmark.c ../src/kinematic.c -lm -o ik_benchmark
+///          Geometry is taken from robot description defaults (robot_config.h)
+//  ***************************************************************************
+#include "kinematic.h"
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+#define WORKSPACE_STEP_MM                   (5)
+#define BENCHMARK_ROUNDS                    (20)
+
+
+typedef bool (*ik_backend_t)(const limb_geometry_t* limb, const point_3d_t* position, kinematic_result_t* result);
+
+typedef struct {
+    double max_error[3];
+    double sum_error[3];
+    uint32_t points_count;
+    uint32_t mismatch_count;
+} accuracy_report_t;
+
+
+static const int16_t coxa_zero_rotate_list[SUPPORT_LIMBS_COUNT] = ROBOT_DEFAULT_COXA_ZERO_ROTATE;
+static point_3d_t workspace_points[800000];
+static uint32_t workspace_points_count = 0;
+
+
+//  ***************************************************************************
+/// @brief  Initialize limb with robot geometry
+/// @note   Protection is disabled to compare raw angles
+//  ***************************************************************************
+static void init_limb(limb_geometry_t* limb, uint32_t limb_index) {
+
+    memset(limb, 0, sizeof(limb_geometry_t));
+    limb->coxa.length       = ROBOT_DEFAULT_COXA_LENGTH;
+    limb->femur.length      = ROBOT_DEFAULT_FEMUR_LENGTH;
+    limb->tibia.length      = ROBOT_DEFAULT_TIBIA_LENGTH;
+    limb->coxa.zero_rotate  = coxa_zero_rotate_list[limb_index];
+    limb->femur.zero_rotate = ROBOT_DEFAULT_FEMUR_ZERO_ROTATE;
+    limb->tibia.zero_rotate = ROBOT_DEFAULT_TIBIA_ZERO_ROTATE;
+    limb->coxa.prot_min_angle  = limb->femur.prot_min_angle = limb->tibia.prot_min_angle = -720;
+    limb->coxa.prot_max_angle  = limb->femur.prot_max_angle = limb->tibia.prot_max_angle = +720;
+    kinematic_prepare_limb(limb);
+}
+
+//  ***************************************************************************
+/// @brief  Collect points which reachable by reference backend
+//  ***************************************************************************
+static void collect_workspace(const limb_geometry_t* limb) {
+
+    kinematic_result_t result;
+    point_3d_t position;
+    workspace_points_count = 0;
+    for (int32_t x = -300; x <= 300; x += WORKSPACE_STEP_MM) {
+        for (int32_t y = -220; y <= 220; y += WORKSPACE_STEP_MM) {
+            for (int32_t z = -300; z <= 300; z += WORKSPACE_STEP_MM) {
+
+                position.x = (float)x + 0.37f; // Avoid exact axis points
+                position.y = (float)y + 0.21f;
+                position.z = (float)z + 0.13f;
+                if (kinematic_calculate_angles_float(limb, &position, &result) == false || result.is_position_clamped) continue;
+                if (isnan(result.angles[0]) || isnan(result.angles[1]) || isnan(result.angles[2])) continue;
+
+                if (workspace_points_count < sizeof(workspace_points) / sizeof(workspace_points[0])) {
+                    workspace_points[workspace_points_count++] = position;
+                }
+            }
+        }
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Compare fast backend with reference backend
+//  ***************************************************************************
+static void check_accuracy(const limb_geometry_t* limb, accuracy_report_t* report) {
+
+    for (uint32_t i = 0; i < workspace_points_count; ++i) {
+
+        kinematic_result_t ref, fast;
+        bool ref_result = kinematic_calculate_angles_float(limb, &workspace_points[i], &ref);
+        bool fast_result = kinematic_calculate_angles_fast(limb, &workspace_points[i], &fast);
+
+        if (ref_result != fast_result) {
+            ++report->mismatch_count;
+            continue;
+        }
+        for (uint32_t k = 0; k < 3; ++k) {
+            double error = fabs((double)ref.angles[k] - (double)fast.angles[k]);
+            if (error > 180.0) error = 360.0 - error; // Coxa wrap around +-180
+            if (error > report->max_error[k]) report->max_error[k] = error;
+            report->sum_error[k] += error;
+        }
+        ++report->points_count;
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Measure backend execution time
+/// @return ns per call
+//  ***************************************************************************
+static double measure_backend(const limb_geometry_t* limb, ik_backend_t backend) {
+
+    kinematic_result_t result;
+    volatile float sink = 0;
+    struct timespec begin, end;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for (uint32_t round = 0; round < BENCHMARK_ROUNDS; ++round) {
+        for (uint32_t i = 0; i < workspace_points_count; ++i) {
+            backend(limb, &workspace_points[i], &result);
+            sink += result.angles[ROBOT_JOINT_TIBIA];
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    (void)sink;
+
+    double ns = (end.tv_sec - begin.tv_sec) * 1e9 + (end.tv_nsec - begin.tv_nsec);
+    return ns / ((double)BENCHMARK_ROUNDS * workspace_points_count);
+}
+
+int main(void) {
+
+    printf("limb | points  | mismatch | coxa max/avg [deg] | femur max/avg [deg] | tibia max/avg [deg] | float [ns] | fast [ns]\n");
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+
+        limb_geometry_t limb;
+        init_limb(&limb, i);
+        collect_workspace(&limb);
+
+        accuracy_report_t report = {0};
+        check_accuracy(&limb, &report);
+
+        double float_ns = measure_backend(&limb, kinematic_calculate_angles_float);
+        double fast_ns  = measure_backend(&limb, kinematic_calculate_angles_fast);
+
+        uint32_t n = report.points_count ? report.points_count : 1;
+        printf("%4u | %7u | %8u | %8.5f / %7.5f | %8.5f / %8.5f | %8.5f / %8.5f | %10.1f | %9.1f\n",
+               i, report.points_count, report.mismatch_count,
+               report.max_error[0], report.sum_error[0] / n,
+               report.max_error[1], report.sum_error[1] / n,
+               report.max_error[2], report.sum_error[2] / n,
+               float_ns, fast_ns);
+    }
+    return 0;
+}
@@ -0,0 +1,382 @@
+//  ***************************************************************************
+/// @file    pwm_waveform_model.c
+/// @author  NeoProg
+/// @brief   Host model of PWM driver with DMA waveform backend
+/// @note    Build: gcc -O2 -DSTM32F373xC -DPWM_DMA_WAVEFORM_ENABLE=1 -I../src -I../src/drivers -I../CMSIS/Include
+///                 -I../CMSIS/STM32F3xx pwm_waveform_model.c -o pwm_waveform_model
+///          Run:   ./pwm_waveform_model [--periods <N>] [--seed <N>] [--frequency <Hz>]
+///          Build with PWM_DMA_WAVEFORM_ENABLE=0 checks edge schedule backend
+///          PWM driver is compiled into tool with model of GPIO ports, TIM17,
+///          TIM5 and DMA2 channels (1 tick = 1 us). Random pulse widths are
+///          loaded each period by same lock/set/unlock sequence as servo
+///          driver, rising and falling edge times of each channel are
+///          compared with expected (pulse start offset from robot description
+///          and start offset + width). DMA edges can be 1 tick earlier
+///          (merged edges), ISR edges should be exact. Model applies GPIO
+///          writes after ISR call (last BSRR write of port is visible only),
+///          then ISR channels edges are not generated 1 tick apart
+//  ***************************************************************************
+#include "stm32f373xc.h"
+#include "pwm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static GPIO_TypeDef gpio_ports[PWM_MAX_GPIO_PORTS_COUNT];
+static TIM_TypeDef tim17;
+static TIM_TypeDef tim5;
+static DMA_Channel_TypeDef dma2_channels[5];
+static DWT_Type dwt;
+static CoreDebug_Type core_debug;
+static RCC_TypeDef rcc;
+
+#undef GPIOA
+#undef GPIOB
+#undef GPIOC
+#undef GPIOD
+#undef GPIOE
+#undef GPIOF
+#undef TIM17
+#undef TIM5
+#undef DMA2_Channel1
+#undef DMA2_Channel2
+#undef DMA2_Channel4
+#undef DMA2_Channel5
+#undef DWT
+#undef CoreDebug
+#undef RCC
+#undef NVIC_EnableIRQ
+#undef NVIC_SetPriority
+#undef __DMB
+#define GPIOA                       (&gpio_ports[0])
+#define GPIOB                       (&gpio_ports[1])
+#define GPIOC                       (&gpio_ports[2])
+#define GPIOD                       (&gpio_ports[3])
+#define GPIOE                       (&gpio_ports[4])
+#define GPIOF                       (&gpio_ports[5])
+#define TIM17                       (&tim17)
+#define TIM5                        (&tim5)
+#define DMA2_Channel1               (&dma2_channels[0])
+#define DMA2_Channel2               (&dma2_channels[1])
+#define DMA2_Channel4               (&dma2_channels[3])
+#define DMA2_Channel5               (&dma2_channels[4])
+#define DWT                         (&dwt)
+#define CoreDebug                   (&core_debug)
+#define RCC                         (&rcc)
+#define NVIC_EnableIRQ(irq)
+#define NVIC_SetPriority(irq, priority)
+#define __DMB()
+
+#include "pwm.c"
+
+#define MIN_PULSE_WIDTH             (500)
+#define MAX_PULSE_WIDTH             (2500)
+#define NOT_CHANGED                 (0xFFFFFFFF)
+
+
+typedef struct {
+    DMA_Channel_TypeDef* channel;
+    uint32_t request_mask;              // TIM5 DIER bit of DMA request
+    uint32_t initial_count;             // CNDTR value on channel enable
+} dma_request_t;
+
+typedef struct {
+    uint32_t periods_count;
+    uint32_t errors_count;
+    uint32_t isr_edges_count;           // TIM17 compare interrupts
+    uint32_t isr_edges_max;
+    uint32_t schedule_edges_max;        // Compare interrupts of edge schedule backend (all channels by ISR)
+    uint32_t dma_transfers_count;
+    uint32_t merged_edges_count;        // DMA edges moved 1 tick earlier
+    uint32_t not_finished_streams;      // DMA streams with words left at end of PWM period
+} model_stat_t;
+
+
+static dma_request_t dma_requests[] = {
+    { &dma2_channels[4], TIM_DIER_CC1DE, 0 },
+    { &dma2_channels[3], TIM_DIER_CC2DE, 0 },
+    { &dma2_channels[1], TIM_DIER_CC3DE, 0 },
+    { &dma2_channels[0], TIM_DIER_CC4DE, 0 },
+};
+static uint32_t port_levels[PWM_MAX_GPIO_PORTS_COUNT];
+static uint32_t rise_time[SUPPORT_PWM_CHANNELS_COUNT];
+static uint32_t fall_time[SUPPORT_PWM_CHANNELS_COUNT];
+static uint32_t tim5_counter = 0;
+static uint32_t tim5_reload = 0;        // ARR shadow register
+static model_stat_t stat = {0};
+
+
+//  ***************************************************************************
+/// @brief  Apply GPIO writes and capture rising and falling edges
+/// @param  time: current time from PWM period begin, [tick]
+//  ***************************************************************************
+static void apply_gpio_writes(uint32_t time) {
+
+    for (uint32_t i = 0; i < PWM_MAX_GPIO_PORTS_COUNT; ++i) {
+        port_levels[i] |= gpio_ports[i].BSRR & 0xFFFF;
+        port_levels[i] &= ~(gpio_ports[i].BRR | (gpio_ports[i].BSRR >> 16));
+        gpio_ports[i].BSRR = 0;
+        gpio_ports[i].BRR = 0;
+    }
+    for (uint32_t i = 0; i < SUPPORT_PWM_CHANNELS_COUNT; ++i) {
+        uint32_t port = channels_list[i].gpio_port - gpio_ports;
+        bool is_high = (port_levels[port] & (0x01 << channels_list[i].gpio_pin)) != 0;
+        if (rise_time[i] == NOT_CHANGED && is_high == true) {
+            rise_time[i] = time;
+        }
+        if (rise_time[i] != NOT_CHANGED && fall_time[i] == NOT_CHANGED && is_high == false) {
+            fall_time[i] = time;
+        }
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Resolve DMA memory address to schedule array
+/// @note   Firmware writes 32-bit addresses, host pointers are compared by
+///         low 32 bits
+//  ***************************************************************************
+static const void* resolve_memory_address(uint32_t address) {
+
+#if PWM_DMA_WAVEFORM_ENABLE
+    for (uint32_t s = 0; s < 2; ++s) {
+        if ((uint32_t)(uintptr_t)&schedules[s].dma_reload_list[1] == address) {
+            return &schedules[s].dma_reload_list[1];
+        }
+        for (uint32_t p = 0; p < PWM_DMA_PORTS_COUNT; ++p) {
+            if ((uint32_t)(uintptr_t)schedules[s].dma_words_list[p] == address) {
+                return schedules[s].dma_words_list[p];
+            }
+        }
+    }
+#endif
+    return NULL;
+}
+
+//  ***************************************************************************
+/// @brief  Process timer registers writes of ISR (update generation)
+//  ***************************************************************************
+static void process_timer_writes(void) {
+
+    if (tim5.EGR & TIM_EGR_UG) {
+        tim5_counter = 0;
+        tim5_reload = tim5.ARR;
+        tim5.EGR = 0;
+        for (uint32_t i = 0; i < sizeof(dma_requests) / sizeof(dma_requests[0]); ++i) {
+            dma_requests[i].initial_count = dma_requests[i].channel->CNDTR;
+        }
+    }
+}
+
+//  ***************************************************************************
+/// @brief  TIM5 tick: counter, update and compare DMA requests
+//  ***************************************************************************
+static void tim5_tick(void) {
+
+    if ((tim5.CR1 & TIM_CR1_CEN) == 0) {
+        return;
+    }
+    if (++tim5_counter > tim5_reload) {
+        tim5_counter = 0;
+        tim5_reload = tim5.ARR;
+    }
+    if (tim5_counter != tim5.CCR1) {
+        return;
+    }
+
+    // Compare event: DMA transfers of enabled requests
+    for (uint32_t i = 0; i < sizeof(dma_requests) / sizeof(dma_requests[0]); ++i) {
+
+        dma_request_t* request = &dma_requests[i];
+        DMA_Channel_TypeDef* channel = request->channel;
+        if ((tim5.DIER & request->request_mask) == 0 || (channel->CCR & DMA_CCR_EN) == 0 || channel->CNDTR == 0) {
+            continue;
+        }
+
+        uint32_t index = request->initial_count - channel->CNDTR;
+        const void* memory = resolve_memory_address(channel->CMAR);
+        uint32_t value = (((channel->CCR & DMA_CCR_MSIZE) >> DMA_CCR_MSIZE_Pos) == 0x01) ? ((const uint16_t*)memory)[index]
+                                                                                          : ((const uint32_t*)memory)[index];
+        if (channel->CPAR == (uint32_t)(uintptr_t)&tim5.ARR) {
+            tim5.ARR = value;
+        } else {
+            for (uint32_t p = 0; p < PWM_MAX_GPIO_PORTS_COUNT; ++p) {
+                if (channel->CPAR == (uint32_t)(uintptr_t)&gpio_ports[p].BSRR) {
+                    gpio_ports[p].BSRR = value;
+                }
+            }
+        }
+        --channel->CNDTR;
+        ++stat.dma_transfers_count;
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Load random pulse widths
+/// @note   Equal widths and 1-2 ticks apart widths are generated for check
+///         edges merging
+//  ***************************************************************************
+static void load_random_widths(uint32_t* widths) {
+
+    for (uint32_t i = 0; i < SUPPORT_PWM_CHANNELS_COUNT; ++i) {
+        widths[i] = MIN_PULSE_WIDTH + rand() % (MAX_PULSE_WIDTH - MIN_PULSE_WIDTH);
+        if (i > 0 && rand() % 4 == 0) {
+            widths[i] = widths[rand() % i] + rand() % 3;
+        }
+    }
+    for (uint32_t i = 0; i < SUPPORT_PWM_CHANNELS_COUNT; ++i) {
+        if (shadow_buffer[i].port_index < isr_first_port) {
+            continue;
+        }
+        // Falling edge 1 tick apart of other ISR edge is moved to it
+        uint32_t fall = shadow_buffer[i].start_offset + widths[i] - PWM_CHANNEL_PULSE_TRIM;
+        for (uint32_t j = 0; j < SUPPORT_PWM_CHANNELS_COUNT; ++j) {
+            if (j == i || shadow_buffer[j].port_index < isr_first_port) {
+                continue;
+            }
+            uint32_t other_rise = shadow_buffer[j].start_offset;
+            uint32_t other_fall = shadow_buffer[j].start_offset + widths[j] - PWM_CHANNEL_PULSE_TRIM;
+            if (fall == other_rise + 1 || other_rise == fall + 1) {
+                widths[i] = other_rise - shadow_buffer[i].start_offset + PWM_CHANNEL_PULSE_TRIM;
+            }
+            else if (j < i && (fall == other_fall + 1 || other_fall == fall + 1)) {
+                widths[i] = widths[j] + shadow_buffer[j].start_offset - shadow_buffer[i].start_offset;
+            }
+            fall = shadow_buffer[i].start_offset + widths[i] - PWM_CHANNEL_PULSE_TRIM;
+        }
+    }
+
+    pwm_set_shadow_buffer_lock_state(true);
+    for (uint32_t i = 0; i < SUPPORT_PWM_CHANNELS_COUNT; ++i) {
+        pwm_set_width(i, widths[i]);
+    }
+    pwm_set_shadow_buffer_lock_state(false);
+}
+
+//  ***************************************************************************
+/// @brief  Check edge time
+/// @return true - edge is valid
+//  ***************************************************************************
+static bool check_edge(uint32_t channel, const char* name, uint32_t time, uint32_t expected) {
+
+    bool is_dma = shadow_buffer[channel].port_index < isr_first_port;
+    bool is_valid = (time == expected) || (is_dma && time + 1 == expected);
+    if (is_valid == false) {
+        ++stat.errors_count;
+        fprintf(stderr, "period %u: channel %u (%s) %s at %u, expected %u\n", stat.periods_count, channel,
+                is_dma ? "DMA" : "ISR", name, time, expected);
+    }
+    if (is_dma && time != expected) {
+        ++stat.merged_edges_count;
+    }
+    return is_valid;
+}
+
+//  ***************************************************************************
+/// @brief  Add edge time to distinct times list
+//  ***************************************************************************
+static void add_distinct_ticks(uint32_t* distinct_ticks, uint32_t* distinct_count, uint32_t ticks) {
+
+    uint32_t j = 0;
+    while (j < *distinct_count && distinct_ticks[j] != ticks) {
+        ++j;
+    }
+    if (j == *distinct_count) {
+        distinct_ticks[(*distinct_count)++] = ticks;
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Check rising and falling edges of PWM period
+//  ***************************************************************************
+static void check_period(const uint32_t* widths) {
+
+    uint32_t distinct_ticks[PWM_MAX_EDGES_COUNT];
+    uint32_t distinct_count = 0;
+    for (uint32_t i = 0; i < SUPPORT_PWM_CHANNELS_COUNT; ++i) {
+
+        uint32_t offset = shadow_buffer[i].start_offset;
+        uint32_t ticks = offset + widths[i] - PWM_CHANNEL_PULSE_TRIM;
+        check_edge(i, "rise", rise_time[i], offset);
+        check_edge(i, "fall", fall_time[i], ticks);
+
+        if (offset != 0) {
+            add_distinct_ticks(distinct_ticks, &distinct_count, offset);
+        }
+        add_distinct_ticks(distinct_ticks, &distinct_count, ticks);
+    }
+    if (distinct_count > stat.schedule_edges_max) {
+        stat.schedule_edges_max = distinct_count;
+    }
+    for (uint32_t i = 0; i < isr_first_port; ++i) {
+        if (dma_requests[i].channel->CNDTR != 0) {
+            ++stat.not_finished_streams;
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    uint32_t periods_count = 10000;
+    uint32_t seed = 1;
+    uint32_t frequency = PWM_FREQUENCY_HZ;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--periods") == 0)   periods_count = strtoul(argv[i + 1], NULL, 10);
+        else if (strcmp(argv[i], "--seed") == 0) seed = strtoul(argv[i + 1], NULL, 10);
+        else if (strcmp(argv[i], "--frequency") == 0) frequency = strtoul(argv[i + 1], NULL, 10);
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    srand(seed);
+
+    if (pwm_set_frequency(frequency, MAX_PULSE_WIDTH) == false) {
+        fprintf(stderr, "PWM frequency %u Hz is not supported\n", frequency);
+        return 1;
+    }
+    pwm_init();
+    pwm_enable();
+    memset(gpio_ports, 0, sizeof(gpio_ports)); // Outputs reset by GPIO initialization
+    printf("frequency: %u Hz, ports: %u, DMA ports: %u, ISR ports: %u\n", pwm_frequency_hz, ports_count, isr_first_port, ports_count - isr_first_port);
+
+    uint32_t widths[SUPPORT_PWM_CHANNELS_COUNT];
+    for (stat.periods_count = 0; stat.periods_count < periods_count; ++stat.periods_count) {
+
+        // Main loop loads widths, schedule is taken on PWM period begin
+        load_random_widths(widths);
+        tim17.CNT = 0;
+        tim17.SR = TIM_SR_UIF;
+        TIM17_IRQHandler();
+        process_timer_writes();
+        memset(rise_time, 0xFF, sizeof(rise_time));
+        memset(fall_time, 0xFF, sizeof(fall_time));
+        apply_gpio_writes(0);
+
+        uint32_t isr_edges_count = 0;
+        for (uint32_t time = 0; time < pwm_period_us; ++time) {
+            if (time != 0) {
+                tim5_tick();
+            }
+            tim17.CNT = time;
+            if (tim17.CCR1 == time) {
+                tim17.SR = TIM_SR_CC1IF;
+                TIM17_IRQHandler();
+                ++isr_edges_count;
+            }
+            apply_gpio_writes(time);
+        }
+        check_period(widths);
+
+        stat.isr_edges_count += isr_edges_count;
+        if (isr_edges_count > stat.isr_edges_max) {
+            stat.isr_edges_max = isr_edges_count;
+        }
+    }
+
+    printf("periods: %u, errors: %u\n", stat.periods_count, stat.errors_count);
+    printf("compare interrupts per period: avg %.2f, max %u (edge schedule backend: max %u)\n",
+           (double)stat.isr_edges_count / stat.periods_count, stat.isr_edges_max, stat.schedule_edges_max);
+    printf("DMA transfers per period: %.2f, merged edges: %u, not finished streams: %u\n",
+           (double)stat.dma_transfers_count / stat.periods_count, stat.merged_edges_count, stat.not_finished_streams);
+    return (stat.errors_count == 0 && stat.not_finished_streams == 0) ? 0 : 1;
+}
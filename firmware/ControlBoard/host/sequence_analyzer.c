@@ -0,0 +1,420 @@
+//  ***************************************************************************
+/// @file    sequence_analyzer.c
+/// @author  NeoProg
+/// @brief   Host analyzer of joints speed and time step optimizer for sequences
+/// @note    Build: gcc -O2 -DSTM32F373xC -DMOTION_CORE_BAKED_SCHEDULE_ENABLE=0 -I../src -I../src/tools -I../src/drivers
+///                 -I../CMSIS/Include -I../CMSIS/STM32F3xx sequence_analyzer.c ../src/kinematic.c ../src/body_pose.c
+///                 ../src/gait_generator.c ../src/trajectory_kernel.c -lm -o sequence_analyzer
+///          Run:   ./sequence_analyzer [--eeprom <image.bin>] [--jobs <N>] [--rated-speed <deg/s>] > optimized.txt
+///          Motion core is compiled into tool, sequences are played by same
+///          trajectory and IK code as firmware. Geometry is read from EEPROM
+///          image (CLI "config read" dump, address 0 at file offset 0),
+///          robot description defaults are used without image. Largest
+///          time_step of each motion which keeps all joints under rated
+///          servo speed is searched by parallel workers. Motion core state is
+///          static, workers are processes (fork) instead of threads.
+///          Optimized table is printed to stdout, report to stderr. Exit
+///          code is 1 if any motion has positions jump (discontinuity)
+//  ***************************************************************************
+#include "motion_core.c"
+#include "gait_sequences.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define EEPROM_SIZE                         (4096)      // 24C32
+#define DEFAULT_RATED_SPEED                 (375.0)     // DS3218MG at 5V: 0.16 s / 60 degree, [degree/s]
+#define SPEED_MARGIN                        (0.90)      // Part of rated speed available for sequences
+#define MAX_MOTIONS_COUNT                   (16)
+#define MAX_SEQUENCES_COUNT                 (16)
+#define MAX_PERIODS_PER_MOTION              (20000)
+
+
+typedef struct {
+    const char* name;
+    const sequence_info_t* info;        // NULL - walk sequence (gait generator)
+    gait_type_t gait;
+    int32_t curvature;                  // Trajectory configuration for advanced trajectories
+    int32_t distance;
+    const point_3d_t* start_positions;
+} sequence_entry_t;
+
+typedef struct {
+    uint32_t main_motions_begin;
+    uint32_t finalize_motions_begin;
+    uint32_t total_motions_count;
+    bool     is_sequence_looped;
+    motion_config_t motion_list[MAX_MOTIONS_COUNT];
+} sequence_view_t;
+
+typedef struct {
+    double   peak_speed;                // [degree/s]
+    double   peak_accel;                // [degree/s^2]
+    uint32_t peak_servo;                // Servo with peak speed
+    uint32_t periods_count;
+} motion_stat_t;
+
+typedef struct {
+    uint32_t sequence;
+    uint32_t motion;
+    int32_t  time_step;                 // Optimized time step
+    motion_stat_t source;
+    motion_stat_t optimized;
+    bool     is_valid;                  // Sequence is played without motion core errors
+    bool     is_discontinuity;          // Speed limit is exceeded with min time step (positions jump between motions)
+} job_result_t;
+
+
+static const sequence_entry_t sequences_list[] = {
+    { "sequence_down",         &sequence_down,         GAIT_TRIPOD, 0, 0,   sequence_walk_neutral_positions       },
+    { "sequence_up",           &sequence_up,           GAIT_TRIPOD, 0, 0,   NULL                                  },
+    { "sequence_up_down",      &sequence_up_down,      GAIT_TRIPOD, 0, 0,   sequence_walk_neutral_positions       },
+    { "sequence_push_pull",    &sequence_push_pull,    GAIT_TRIPOD, 1, 110, sequence_walk_neutral_positions       },
+    { "sequence_attack_left",  &sequence_attack_left,  GAIT_TRIPOD, 0, 0,   sequence_walk_neutral_positions       },
+    { "sequence_attack_right", &sequence_attack_right, GAIT_TRIPOD, 0, 0,   sequence_walk_neutral_positions       },
+    { "sequence_dance",        &sequence_dance,        GAIT_TRIPOD, 0, 0,   sequence_walk_neutral_positions       },
+    { "sequence_rotate_x",     &sequence_rotate_x,     GAIT_TRIPOD, 0, 0,   sequence_walk_neutral_positions       },
+    { "sequence_rotate_z",     &sequence_rotate_z,     GAIT_TRIPOD, 0, 0,   sequence_walk_neutral_positions       },
+    { "walk_tripod",           NULL,                   GAIT_TRIPOD, 1, 110, sequence_walk_neutral_positions       },
+    { "walk_ripple",           NULL,                   GAIT_RIPPLE, 1, 110, sequence_walk_neutral_positions       },
+    { "walk_wave",             NULL,                   GAIT_WAVE,   1, 110, sequence_walk_neutral_positions       },
+};
+
+static uint8_t eeprom_image[EEPROM_SIZE];
+static float servo_angles[ROBOT_SERVO_COUNT];
+static double speed_limit = DEFAULT_RATED_SPEED * SPEED_MARGIN;
+
+
+//
+// Firmware stubs. Motion core reads geometry from EEPROM image, servo angles are captured
+//
+uint64_t synchro = 0;
+uint64_t get_time_ms(void) { return synchro * 1000 / PWM_FREQUENCY_HZ; }
+uint32_t get_cpu_cycles(void) { return 0; }
+uint32_t pwm_get_frequency(void) { return PWM_FREQUENCY_HZ; }
+void sysmon_set_error(uint32_t error) {}
+static uint32_t disabled_modules = 0;
+void sysmon_disable_module(uint32_t module) { disabled_modules |= module; }
+bool sysmon_is_module_disable(uint32_t module) { return (disabled_modules & module) != 0; }
+bool config_read_16(uint32_t address, uint16_t* buffer) {
+    if (address + 2 > EEPROM_SIZE) return false;
+    memcpy(buffer, &eeprom_image[address], 2);
+    return true;
+}
+void servo_driver_init(void) {}
+void servo_driver_power_on(void) {}
+void servo_driver_move(uint32_t servo, float angle) { servo_angles[servo] = angle; }
+void servo_driver_move_pulse_width(uint32_t servo, uint32_t pulse_width) {}
+uint32_t servo_driver_convert_angle(uint32_t servo, float angle) { return 0; }
+
+
+//  ***************************************************************************
+/// @brief  Load EEPROM image
+/// @note   Without image geometry cells are not programmed (defaults from
+///         robot description are used) and protection is disabled
+//  ***************************************************************************
+static bool load_eeprom_image(const char* file_name) {
+
+    memset(eeprom_image, 0xFF, sizeof(eeprom_image));
+    if (file_name == NULL) {
+        static const uint32_t protection_offsets[] = {
+            MM_LIMB_PROTECTION_COXA_MIN_ANGLE_OFFSET,  MM_LIMB_PROTECTION_COXA_MAX_ANGLE_OFFSET,
+            MM_LIMB_PROTECTION_FEMUR_MIN_ANGLE_OFFSET, MM_LIMB_PROTECTION_FEMUR_MAX_ANGLE_OFFSET,
+            MM_LIMB_PROTECTION_TIBIA_MIN_ANGLE_OFFSET, MM_LIMB_PROTECTION_TIBIA_MAX_ANGLE_OFFSET
+        };
+        for (uint32_t i = 0; i < sizeof(protection_offsets) / sizeof(protection_offsets[0]); ++i) {
+            int16_t angle = (i & 0x01) ? +720 : -720;
+            memcpy(&eeprom_image[MM_LIMB_CONFIG_BASE_EE_ADDRESS + protection_offsets[i]], &angle, sizeof(angle));
+        }
+        return true;
+    }
+
+    FILE* file = fopen(file_name, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    size_t size = fread(eeprom_image, 1, sizeof(eeprom_image), file);
+    fclose(file);
+    return size >= MM_LIMB_CONFIG_BASE_EE_ADDRESS + MM_LIMB_PROTECTION_TIBIA_MAX_ANGLE_OFFSET + 2;
+}
+
+//  ***************************************************************************
+/// @brief  Load sequence motions
+/// @note   Walk sequences are built by gait generator same as sequences engine
+//  ***************************************************************************
+static bool load_sequence(const sequence_entry_t* entry, sequence_view_t* view) {
+
+    if (entry->info == NULL) {
+        view->is_sequence_looped     = true;
+        view->main_motions_begin     = GAIT_PREPARE_MOTIONS_COUNT;
+        view->finalize_motions_begin = GAIT_PREPARE_MOTIONS_COUNT + GAIT_MAIN_MOTIONS_COUNT;
+        view->total_motions_count    = GAIT_TOTAL_MOTIONS_COUNT;
+        return gait_generator_build_sequence(entry->gait, TIME_DIR_DIRECT, entry->curvature, entry->distance,
+                                             sequence_walk_neutral_positions, view->motion_list);
+    }
+    if (entry->info->total_motions_count > MAX_MOTIONS_COUNT) {
+        return false;
+    }
+    view->is_sequence_looped     = entry->info->is_sequence_looped;
+    view->main_motions_begin     = entry->info->main_motions_begin;
+    view->finalize_motions_begin = entry->info->finalize_motions_begin;
+    view->total_motions_count    = entry->info->total_motions_count;
+    memcpy(view->motion_list, entry->info->motion_list, view->total_motions_count * sizeof(motion_config_t));
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Play sequence by motion core and collect joints statistic
+/// @note   Looped main motions are played twice (spline trajectories of
+///         first main motion depend on previous motion), statistic of motion
+///         is max of all plays
+//  ***************************************************************************
+static bool play_sequence(const sequence_entry_t* entry, const sequence_view_t* view, motion_stat_t* stats) {
+
+    // Play order: prepare, main (twice for looped), finalize
+    uint32_t order[MAX_MOTIONS_COUNT * 3];
+    uint32_t order_count = 0;
+    for (uint32_t m = 0; m < view->main_motions_begin; ++m) order[order_count++] = m;
+    for (uint32_t k = 0; k < (view->is_sequence_looped ? 2u : 1u); ++k) {
+        for (uint32_t m = view->main_motions_begin; m < view->finalize_motions_begin; ++m) order[order_count++] = m;
+    }
+    for (uint32_t m = view->finalize_motions_begin; m < view->total_motions_count; ++m) order[order_count++] = m;
+
+    // Initialize motion core same as sequences engine
+    const point_3d_t* start_positions = entry->start_positions;
+    if (start_positions == NULL) {
+        start_positions = sequence_down.motion_list[sequence_down.total_motions_count - 1].dest_positions; // Sequence up starts from down
+    }
+    disabled_modules = 0;
+    motion_core_set_speed_multiplier(1.0f);
+    motion_core_update_trajectory_config(entry->curvature, entry->distance);
+    motion_core_init(start_positions);
+    motion_core_reset_trajectory_config();
+    if (entry->info == NULL) {
+        motion_core_set_gait_params(gait_generator_get_params(entry->gait));
+    }
+
+    memset(stats, 0, sizeof(motion_stat_t) * MAX_MOTIONS_COUNT);
+    float prev_angles[ROBOT_SERVO_COUNT];
+    double prev_speeds[ROBOT_SERVO_COUNT] = {0};
+    memcpy(prev_angles, servo_angles, sizeof(prev_angles));
+
+    for (uint32_t k = 0; k < order_count; ++k) {
+
+        uint32_t m = order[k];
+        motion_core_set_next_motion((k + 1 < order_count) ? &view->motion_list[order[k + 1]] : NULL);
+        motion_core_start_motion(&view->motion_list[m]);
+
+        uint32_t periods_count = 0;
+        while (motion_core_is_motion_complete() == false) {
+
+            // One PWM period: sync, calculation and time shift states
+            ++synchro;
+            for (uint32_t s = 0; s < 3; ++s) {
+                motion_core_process();
+            }
+            if (sysmon_is_module_disable(SYSMON_MODULE_MOTION_DRIVER) == true || ++periods_count > MAX_PERIODS_PER_MOTION) {
+                return false;
+            }
+
+            motion_stat_t* stat = &stats[m];
+            for (uint32_t i = 0; i < ROBOT_SERVO_COUNT; ++i) {
+                double speed = (servo_angles[i] - prev_angles[i]) * PWM_FREQUENCY_HZ;
+                double accel = (speed - prev_speeds[i]) * PWM_FREQUENCY_HZ;
+                if (fabs(speed) > stat->peak_speed) {
+                    stat->peak_speed = fabs(speed);
+                    stat->peak_servo = i;
+                }
+                if (fabs(accel) > stat->peak_accel) {
+                    stat->peak_accel = fabs(accel);
+                }
+                prev_angles[i] = servo_angles[i];
+                prev_speeds[i] = speed;
+            }
+        }
+        if (periods_count > stats[m].periods_count) {
+            stats[m].periods_count = periods_count;
+        }
+    }
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Search largest time step of motion
+/// @note   Peak speed grows with time step, binary search is used. Motions
+///         without joints movement are pauses, their time is not changed.
+///         Time step is not changed if limit is exceeded with min time step
+//  ***************************************************************************
+static void optimize_motion(uint32_t sequence, uint32_t motion, job_result_t* result) {
+
+    const sequence_entry_t* entry = &sequences_list[sequence];
+    static sequence_view_t view;
+    static motion_stat_t stats[MAX_MOTIONS_COUNT];
+
+    memset(result, 0, sizeof(job_result_t));
+    result->sequence = sequence;
+    result->motion = motion;
+    if (load_sequence(entry, &view) == false || play_sequence(entry, &view, stats) == false) {
+        return;
+    }
+    result->is_valid = true;
+    result->source = stats[motion];
+    result->optimized = stats[motion];
+
+    motion_config_t* config = &view.motion_list[motion];
+    int32_t source_time_step = config->time_step;
+    result->time_step = source_time_step;
+    if (result->source.peak_speed == 0) {
+        return;
+    }
+
+    int32_t low = 1;
+    int32_t high = abs(config->time_stop - config->motion_time);
+    while (low < high) {
+
+        int32_t time_step = (low + high + 1) / 2;
+        config->time_step = time_step;
+        if (play_sequence(entry, &view, stats) == true && stats[motion].peak_speed <= speed_limit) {
+            low = time_step;
+            result->optimized = stats[motion];
+        }
+        else {
+            high = time_step - 1;
+        }
+    }
+    result->time_step = low;
+    if (low == 1) {
+        config->time_step = low;
+        if (play_sequence(entry, &view, stats) == false || stats[motion].peak_speed > speed_limit) {
+            result->is_discontinuity = true;
+            result->time_step = source_time_step;
+            result->optimized = result->source;
+        }
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Get motion stage name
+//  ***************************************************************************
+static const char* get_stage_name(const sequence_view_t* view, uint32_t motion) {
+    if (motion < view->main_motions_begin) return "prepare";
+    if (motion < view->finalize_motions_begin) return "main";
+    return "finalize";
+}
+
+int main(int argc, char* argv[]) {
+
+    const char* eeprom_file = NULL;
+    long jobs_count = sysconf(_SC_NPROCESSORS_ONLN);
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--eeprom") == 0)           eeprom_file = argv[i + 1];
+        else if (strcmp(argv[i], "--jobs") == 0)        jobs_count = atol(argv[i + 1]);
+        else if (strcmp(argv[i], "--rated-speed") == 0) speed_limit = atof(argv[i + 1]) * SPEED_MARGIN;
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (jobs_count < 1) {
+        jobs_count = 1;
+    }
+    if (load_eeprom_image(eeprom_file) == false) {
+        fprintf(stderr, "%s: cannot read EEPROM image\n", eeprom_file);
+        return 1;
+    }
+
+    // Job list: each motion of each sequence
+    uint32_t sequences_count = sizeof(sequences_list) / sizeof(sequences_list[0]);
+    static sequence_view_t views[MAX_SEQUENCES_COUNT];
+    static job_result_t results[MAX_SEQUENCES_COUNT * MAX_MOTIONS_COUNT];
+    uint32_t results_count = 0;
+    for (uint32_t s = 0; s < sequences_count; ++s) {
+        if (load_sequence(&sequences_list[s], &views[s]) == false) {
+            fprintf(stderr, "%s: sequence can not be loaded\n", sequences_list[s].name);
+            return 1;
+        }
+        results_count += views[s].total_motions_count;
+    }
+
+    // Workers take jobs by index modulo workers count and send results over pipe (result size is less PIPE_BUF, writes are atomic)
+    int fds[2];
+    if (pipe(fds) != 0) {
+        perror("pipe");
+        return 1;
+    }
+    for (long w = 0; w < jobs_count; ++w) {
+        if (fork() == 0) {
+            close(fds[0]);
+            uint32_t job = 0;
+            for (uint32_t s = 0; s < sequences_count; ++s) {
+                for (uint32_t m = 0; m < views[s].total_motions_count; ++m, ++job) {
+                    if (job % jobs_count == (uint32_t)w) {
+                        job_result_t result;
+                        optimize_motion(s, m, &result);
+                        if (write(fds[1], &result, sizeof(result)) != sizeof(result)) {
+                            _exit(1);
+                        }
+                    }
+                }
+            }
+            _exit(0);
+        }
+    }
+    close(fds[1]);
+
+    job_result_t result;
+    uint32_t received_count = 0;
+    while (read(fds[0], &result, sizeof(result)) == sizeof(result)) {
+        uint32_t index = 0;
+        for (uint32_t s = 0; s < result.sequence; ++s) {
+            index += views[s].total_motions_count;
+        }
+        results[index + result.motion] = result;
+        ++received_count;
+    }
+    while (wait(NULL) > 0);
+    if (received_count != results_count) {
+        fprintf(stderr, "workers failed: %u of %u results\n", received_count, results_count);
+        return 1;
+    }
+
+    // Optimized table and report
+    printf("# Optimized time_step (speed limit %.0f degree/s, %u Hz motion clock)\n", speed_limit, PWM_FREQUENCY_HZ);
+    printf("# sequence               motion  stage     time_step\n");
+    fprintf(stderr, "%-22s %6s %-8s %9s %9s %10s %5s %10s %12s %7s\n", "sequence", "motion", "stage", "step", "optimized",
+            "speed", "servo", "opt speed", "opt accel", "periods");
+
+    uint32_t index = 0;
+    uint32_t discontinuities_count = 0;
+    for (uint32_t s = 0; s < sequences_count; ++s) {
+
+        uint32_t source_periods = 0;
+        uint32_t optimized_periods = 0;
+        for (uint32_t m = 0; m < views[s].total_motions_count; ++m, ++index) {
+
+            const job_result_t* r = &results[index];
+            const motion_config_t* motion = &views[s].motion_list[m];
+            if (r->is_valid == false) {
+                fprintf(stderr, "%-22s %6u %-8s motion core error (position is not attainable)\n", sequences_list[s].name, m, get_stage_name(&views[s], m));
+                continue;
+            }
+            printf("%-24s %6u  %-8s  %9d\n", sequences_list[s].name, m, get_stage_name(&views[s], m), r->time_step);
+            fprintf(stderr, "%-22s %6u %-8s %9d %9d %10.0f %5u %10.0f %12.0f %3u->%-3u%s\n", sequences_list[s].name, m, get_stage_name(&views[s], m),
+                    motion->time_step, r->time_step, r->source.peak_speed, r->source.peak_servo, r->optimized.peak_speed, r->optimized.peak_accel,
+                    r->source.periods_count, r->optimized.periods_count, r->is_discontinuity ? " discontinuity" : (r->source.peak_speed > speed_limit ? " over limit" : ""));
+            discontinuities_count += r->is_discontinuity ? 1 : 0;
+            source_periods += r->source.periods_count;
+            optimized_periods += r->optimized.periods_count;
+        }
+        if (optimized_periods != 0) {
+            fprintf(stderr, "%-22s duration %u -> %u periods (x%.2f)\n", sequences_list[s].name, source_periods, optimized_periods,
+                    (double)source_periods / optimized_periods);
+        }
+    }
+    if (discontinuities_count != 0) {
+        fprintf(stderr, "%u motions have discontinuity\n", discontinuities_count);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,234 @@
+//  ***************************************************************************
+/// @file    sequence_packer.c
+/// @author  NeoProg
+/// @brief   Host generator of packed sequences
+/// @note    Build: gcc -O2 -I../src -I../src/tools sequence_packer.c ../src/sequence_codec.c -o sequence_packer
+///          Run:   ./sequence_packer > ../src/gait_sequences_packed.h
+///          Quadruped tables: build with -DROBOT_CONFIG_QUADRUPED, run
+///                 ./sequence_packer > ../src/gait_sequences_packed_quadruped.h
+///          Source tables are gait_sequences.h. Each motion is checked by
+///          decode after encode, flash report is printed to stderr
+///          Upload: ./sequence_packer --upload <name> [<name> ...] > upload.txt
+///          Prints CLI commands for upload sequence image to device (send
+///          line by line). New sequences can be added without rebuild of
+///          firmware: -DUSER_SEQUENCES_HEADER=\"my_sequences.h\", header
+///          defines USER_SEQUENCES_LIST entries (same as sequences_list)
+//  ***************************************************************************
+#include "sequence_codec.h"
+#include "gait_sequences.h"
+#ifdef USER_SEQUENCES_HEADER
+#include USER_SEQUENCES_HEADER
+#endif
+#include <stdio.h>
+#include <string.h>
+
+#define TARGET_POINTER_SIZE                 (4)         // Cortex-M4
+#define UPLOAD_CHUNK_SIZE                   (24)        // Bytes count of one CLI write command
+
+#if ROBOT_LIMBS_COUNT == 6
+#define PACKED_FILE_NAME                    "gait_sequences_packed.h"
+#define PACKED_FILE_GUARD                   "GAIT_SEQUENCES_PACKED_H_"
+#define PACKED_ROBOT_NAME                   "hexapod"
+#else
+#define PACKED_FILE_NAME                    "gait_sequences_packed_quadruped.h"
+#define PACKED_FILE_GUARD                   "GAIT_SEQUENCES_PACKED_QUADRUPED_H_"
+#define PACKED_ROBOT_NAME                   "quadruped"
+#endif
+
+
+typedef struct {
+    const char* name;
+    const sequence_info_t* info;
+} sequence_entry_t;
+
+
+static const sequence_entry_t sequences_list[] = {
+    { "sequence_down",         &sequence_down         },
+    { "sequence_up",           &sequence_up           },
+#if ROBOT_LIMBS_COUNT == 6
+    { "sequence_up_down",      &sequence_up_down      },
+    { "sequence_push_pull",    &sequence_push_pull    },
+    { "sequence_attack_left",  &sequence_attack_left  },
+    { "sequence_attack_right", &sequence_attack_right },
+    { "sequence_dance",        &sequence_dance        },
+    { "sequence_rotate_x",     &sequence_rotate_x     },
+    { "sequence_rotate_z",     &sequence_rotate_z     },
+#endif
+#ifdef USER_SEQUENCES_LIST
+    USER_SEQUENCES_LIST
+#endif
+};
+
+
+//  ***************************************************************************
+/// @brief  Check decoded motion is same as source motion
+/// @note   Start positions are runtime field, they are not compared
+//  ***************************************************************************
+static bool is_motion_equal(const motion_config_t* a, const motion_config_t* b) {
+
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        if (a->dest_positions[i].x != b->dest_positions[i].x || a->dest_positions[i].y != b->dest_positions[i].y ||
+            a->dest_positions[i].z != b->dest_positions[i].z) return false;
+        if (a->trajectories[i] != b->trajectories[i]) return false;
+        if (a->time_directions[i] != b->time_directions[i]) return false;
+    }
+    return a->motion_time == b->motion_time && a->time_stop == b->time_stop && a->time_update == b->time_update &&
+           a->time_step == b->time_step && a->is_need_init_start_position == b->is_need_init_start_position;
+}
+
+//  ***************************************************************************
+/// @brief  Print packed motion as C initializer
+//  ***************************************************************************
+static void print_motion(const packed_motion_t* packed) {
+
+    printf("    {\n        .dest_positions = {");
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        printf("%s{%d, %d, %d}", i ? ", " : "", packed->dest_positions[i][0], packed->dest_positions[i][1], packed->dest_positions[i][2]);
+    }
+    printf("},\n");
+    printf("        .limbs_modes = 0x%08X, .motion_time = %d, .time_stop = %d, .time_update = %d, .time_step = %d\n",
+           (unsigned)packed->limbs_modes, packed->motion_time, packed->time_stop, packed->time_update, packed->time_step);
+    printf("    },\n");
+}
+
+//  ***************************************************************************
+/// @brief  Find sequence by name
+/// @return sequence or NULL if sequence is not found
+//  ***************************************************************************
+static const sequence_info_t* find_sequence(const char* name) {
+
+    for (uint32_t s = 0; s < sizeof(sequences_list) / sizeof(sequences_list[0]); ++s) {
+        if (strcmp(sequences_list[s].name, name) == 0) {
+            return sequences_list[s].info;
+        }
+    }
+    return NULL;
+}
+
+//  ***************************************************************************
+/// @brief  Build sequence image and print CLI upload commands
+/// @note   Image format is checked here, limbs positions are validated by
+///         device on commit
+//  ***************************************************************************
+static int print_upload(int argc, char* argv[]) {
+
+    static sequence_image_t image;
+    memset(&image, 0, sizeof(image));
+    image.magic = SEQUENCE_CODEC_IMAGE_MAGIC;
+    if (argc > SEQUENCE_CODEC_IMAGE_MAX_SEQUENCES) {
+        fprintf(stderr, "too many sequences, max %u\n", SEQUENCE_CODEC_IMAGE_MAX_SEQUENCES);
+        return 1;
+    }
+
+    for (int i = 0; i < argc; ++i) {
+
+        const sequence_info_t* info = find_sequence(argv[i]);
+        if (info == NULL) {
+            fprintf(stderr, "%s: sequence is not found\n", argv[i]);
+            return 1;
+        }
+        if (image.motions_count + info->total_motions_count > SEQUENCE_CODEC_IMAGE_MAX_MOTIONS) {
+            fprintf(stderr, "%s: too many motions, max %u\n", argv[i], SEQUENCE_CODEC_IMAGE_MAX_MOTIONS);
+            return 1;
+        }
+
+        packed_sequence_header_t* header = &image.sequences[image.sequences_count++];
+        header->flags                  = info->is_sequence_looped ? SEQUENCE_CODEC_IMAGE_LOOPED_FLAG : 0;
+        header->main_motions_begin     = info->main_motions_begin;
+        header->finalize_motions_begin = info->finalize_motions_begin;
+        header->total_motions_count    = info->total_motions_count;
+        for (uint32_t m = 0; m < info->total_motions_count; ++m) {
+            if (sequence_codec_encode_motion(&info->motion_list[m], &image.motions[image.motions_count++]) == false) {
+                fprintf(stderr, "%s: motion %u can not be packed\n", argv[i], m);
+                return 1;
+            }
+        }
+    }
+    image.image_size = SEQUENCE_CODEC_IMAGE_SIZE(image.motions_count);
+    image.checksum = sequence_codec_calc_image_checksum(&image);
+    if (sequence_codec_check_image(&image) == false) {
+        fprintf(stderr, "wrong image format (sequence layout or motion time parameters)\n");
+        return 1;
+    }
+
+    const uint8_t* data = (const uint8_t*)&image;
+    printf("sequence begin\n");
+    for (uint32_t offset = 0; offset < image.image_size; offset += UPLOAD_CHUNK_SIZE) {
+        printf("sequence write %04X ", offset);
+        for (uint32_t k = offset; k < offset + UPLOAD_CHUNK_SIZE && k < image.image_size; ++k) {
+            printf("%02X", data[k]);
+        }
+        printf("\n");
+    }
+    printf("sequence commit\n");
+    fprintf(stderr, "sequences: %u, motions: %u, image: %u bytes\n", image.sequences_count, image.motions_count, image.image_size);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+
+    if (argc > 2 && strcmp(argv[1], "--upload") == 0) {
+        return print_upload(argc - 2, &argv[2]);
+    }
+
+    printf("//  ***************************************************************************\n");
+    printf("/// @file    %s\n", PACKED_FILE_NAME);
+    printf("/// @author  NeoProg\n");
+    printf("/// @brief   Packed gait sequences\n");
+    printf("/// @note    Generated by host/sequence_packer.c from gait_sequences.h, do not edit\n");
+    printf("//  ***************************************************************************\n");
+    printf("#ifndef %s\n", PACKED_FILE_GUARD);
+    printf("#define %s\n\n", PACKED_FILE_GUARD);
+    printf("#include \"sequence_codec.h\"\n\n");
+    printf("#if ROBOT_LIMBS_COUNT != %u\n", ROBOT_LIMBS_COUNT);
+    printf("#error \"Sequences tables are written for %s\"\n", PACKED_ROBOT_NAME);
+    printf("#endif\n\n\n");
+
+    printf("static const point_3d_t sequence_walk_neutral_positions[SUPPORT_LIMBS_COUNT] = {\n    ");
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        const point_3d_t* p = &sequence_walk_neutral_positions[i];
+        printf("%s{%d, %d, %d}", i ? ", " : "", (int)p->x, (int)p->y, (int)p->z);
+    }
+    printf("\n};\n\n");
+
+    uint32_t sequences_count = sizeof(sequences_list) / sizeof(sequences_list[0]);
+    uint32_t motions_count = 0;
+    for (uint32_t s = 0; s < sequences_count; ++s) {
+
+        const sequence_info_t* info = sequences_list[s].info;
+        printf("static const packed_motion_t %s_motions[%u] = {\n", sequences_list[s].name, info->total_motions_count);
+        for (uint32_t m = 0; m < info->total_motions_count; ++m) {
+
+            packed_motion_t packed;
+            motion_config_t decoded;
+            if (sequence_codec_encode_motion(&info->motion_list[m], &packed) == false) {
+                fprintf(stderr, "%s: motion %u can not be packed\n", sequences_list[s].name, m);
+                return 1;
+            }
+            sequence_codec_decode_motion(&packed, &decoded);
+            if (is_motion_equal(&info->motion_list[m], &decoded) == false) {
+                fprintf(stderr, "%s: motion %u decode mismatch\n", sequences_list[s].name, m);
+                return 1;
+            }
+            print_motion(&packed);
+        }
+        printf("};\n");
+        printf("static const packed_sequence_t %s = {\n", sequences_list[s].name);
+        printf("    .is_sequence_looped     = %s,\n", info->is_sequence_looped ? "true" : "false");
+        printf("    .main_motions_begin     = %u,\n", info->main_motions_begin);
+        printf("    .finalize_motions_begin = %u,\n", info->finalize_motions_begin);
+        printf("    .total_motions_count    = %u,\n", info->total_motions_count);
+        printf("    .motion_list            = %s_motions\n", sequences_list[s].name);
+        printf("};\n\n");
+        motions_count += info->total_motions_count;
+    }
+    printf("\n#endif /* %s */\n", PACKED_FILE_GUARD);
+
+    uint32_t packed_header_size = sizeof(packed_sequence_t) - sizeof(void*) + TARGET_POINTER_SIZE;
+    uint32_t before = sequences_count * (uint32_t)sizeof(sequence_info_t);
+    uint32_t after = sequences_count * packed_header_size + motions_count * (uint32_t)sizeof(packed_motion_t);
+    fprintf(stderr, "sequences: %u, motions: %u\n", sequences_count, motions_count);
+    fprintf(stderr, "motion:    %u -> %u bytes\n", (uint32_t)sizeof(motion_config_t), (uint32_t)sizeof(packed_motion_t));
+    fprintf(stderr, "flash:     %u -> %u bytes\n", before, after);
+    return 0;
+}
@@ -0,0 +1,170 @@
+//  ***************************************************************************
+/// @file    trajectory_kernel_check.c
+/// @author  NeoProg
+/// @brief   Host check of batched linear trajectory kernel
+/// @note    Build: gcc -O2 -I../src -I../src/tools trajectory_kernel_check.c ../src/trajectory_kernel.c ../src/gait_generator.c -lm -o trajectory_kernel_check
+///          Kernel is compared with legacy per-limb interpolation for all
+///          sequence tables and generated gaits, max error should be less
+///          LEGACY_MAX_ERROR. Limbs should reach end of motion on last tick
+///          when motion time is stretched to it. Kernel speed is not
+///          measured on host: see "linear cycles" of "motion status" CLI
+///          command (DWT CPU cycles on target)
+//  ***************************************************************************
+#include "trajectory_kernel.h"
+#include "gait_generator.h"
+#include "gait_sequences.h"
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+
+#define TIME_STEPS_COUNT                    (1000)
+#define LEGACY_MAX_ERROR                    (0.001)     // Kernel vs legacy interpolation, [mm]
+#define LAST_TICK_TIME                      (0.975f)    // Last tick of motion with time step 25
+
+
+typedef struct {
+    const char* name;
+    const motion_config_t* motion_list;
+    uint32_t motions_count;
+} motion_set_t;
+
+typedef struct {
+    uint32_t points_count;
+    double   max_legacy_error;      // Kernel vs legacy, [mm]
+    double   max_landing_error;     // Last tick vs legacy end of motion, [mm]
+} check_report_t;
+
+
+// Stubs for gait generator (arc geometry is not used by linear trajectories)
+bool motion_core_calculate_arc_geometry(const point_3d_t* start_positions, int32_t curvature, int32_t distance, float* curvature_radius,
+                                        float* trajectory_radius, float* start_angle_rad, float* max_arc_angle) {
+    *curvature_radius = 0;
+    *max_arc_angle = 0;
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        trajectory_radius[i] = sqrtf(start_positions[i].x * start_positions[i].x + start_positions[i].z * start_positions[i].z);
+        start_angle_rad[i] = atan2f(start_positions[i].z, start_positions[i].x);
+    }
+    return true;
+}
+
+
+//  ***************************************************************************
+/// @brief  Legacy implementation: interpolation with inverted motion time
+//  ***************************************************************************
+static void legacy_process_linear(const motion_config_t* config, float motion_time, float* x, float* y, float* z) {
+
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+
+        trajectory_t trajectory = config->trajectories[i];
+        if (trajectory == TRAJECTORY_XYZ_HOLD) {
+            x[i] = config->start_positions[i].x;
+            y[i] = config->start_positions[i].y;
+            z[i] = config->start_positions[i].z;
+            continue;
+        }
+        if (trajectory != TRAJECTORY_XYZ_LINEAR && trajectory != TRAJECTORY_XYZ_LINEAR_LIFT && trajectory != TRAJECTORY_JOINT_LINEAR) {
+            continue;
+        }
+        float t = (config->time_directions[i] == TIME_DIR_REVERSE) ? 1.0f - motion_time : motion_time;
+        const point_3d_t* a = &config->start_positions[i];
+        const point_3d_t* b = &config->dest_positions[i];
+        x[i] = a->x + t * (b->x - a->x);
+        y[i] = a->y + t * (b->y - a->y);
+        z[i] = a->z + t * (b->z - a->z);
+        if (trajectory == TRAJECTORY_XYZ_LINEAR_LIFT) {
+            y[i] += LIMB_STEP_HEIGHT * sinf(t * 3.14159265f);
+        }
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Check motion set. Start positions are chained from previous motion
+//  ***************************************************************************
+static void check_motion_set(const motion_set_t* set, point_3d_t* positions, check_report_t* report) {
+
+    for (uint32_t m = 0; m < set->motions_count; ++m) {
+
+        motion_config_t config = set->motion_list[m];
+        if (config.is_need_init_start_position) {
+            memcpy(config.start_positions, positions, sizeof(config.start_positions));
+        }
+        linear_kernel_t kernel;
+        trajectory_kernel_build_linear(&config, 1.0f, &kernel);
+
+        float kx[SUPPORT_LIMBS_COUNT], ky[SUPPORT_LIMBS_COUNT], kz[SUPPORT_LIMBS_COUNT];
+        float lx[SUPPORT_LIMBS_COUNT], ly[SUPPORT_LIMBS_COUNT], lz[SUPPORT_LIMBS_COUNT];
+        for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+            kx[i] = lx[i] = positions[i].x;
+            ky[i] = ly[i] = positions[i].y;
+            kz[i] = lz[i] = positions[i].z;
+        }
+        for (uint32_t step = 0; step <= TIME_STEPS_COUNT; ++step) {
+
+            float t = (float)step / TIME_STEPS_COUNT;
+            trajectory_kernel_process_linear(&kernel, t, kx, ky, kz);
+            legacy_process_linear(&config, t, lx, ly, lz);
+
+            for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+                double error = fmax(fabs(kx[i] - lx[i]), fmax(fabs(ky[i] - ly[i]), fabs(kz[i] - lz[i])));
+                if (error > report->max_legacy_error) report->max_legacy_error = error;
+                ++report->points_count;
+            }
+        }
+
+        // Motion time stretched to last tick: last tick positions are same as legacy end of motion
+        trajectory_kernel_build_linear(&config, LAST_TICK_TIME, &kernel);
+        trajectory_kernel_process_linear(&kernel, LAST_TICK_TIME, kx, ky, kz);
+        legacy_process_linear(&config, 1.0f, lx, ly, lz);
+        for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+            double error = fmax(fabs(kx[i] - lx[i]), fmax(fabs(ky[i] - ly[i]), fabs(kz[i] - lz[i])));
+            if (error > report->max_landing_error) report->max_landing_error = error;
+        }
+        for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+            positions[i] = config.dest_positions[i];
+        }
+    }
+}
+
+int main(void) {
+
+    static motion_config_t gait_motions[SUPPORT_GAIT_COUNT * 2][GAIT_TOTAL_MOTIONS_COUNT];
+    motion_set_t sets[32];
+    uint32_t sets_count = 0;
+
+#define ADD_SEQUENCE(seq)   sets[sets_count++] = (motion_set_t){ #seq, seq.motion_list, seq.total_motions_count }
+    ADD_SEQUENCE(sequence_up);
+    ADD_SEQUENCE(sequence_up_down);
+    ADD_SEQUENCE(sequence_push_pull);
+    ADD_SEQUENCE(sequence_attack_left);
+    ADD_SEQUENCE(sequence_attack_right);
+    ADD_SEQUENCE(sequence_dance);
+    ADD_SEQUENCE(sequence_rotate_x);
+    ADD_SEQUENCE(sequence_rotate_z);
+    ADD_SEQUENCE(sequence_down);
+#undef ADD_SEQUENCE
+
+    static const char* gait_names[SUPPORT_GAIT_COUNT * 2] = { "tripod", "tripod reverse", "ripple", "ripple reverse", "wave", "wave reverse" };
+    for (uint32_t g = 0; g < SUPPORT_GAIT_COUNT * 2; ++g) {
+        time_dir_t direction = (g & 1) ? TIME_DIR_REVERSE : TIME_DIR_DIRECT;
+        if (gait_generator_build_sequence((gait_type_t)(g / 2), direction, 0, 110, sequence_walk_neutral_positions, gait_motions[g]) == false) {
+            printf("gait %s build failed\n", gait_names[g]);
+            return 1;
+        }
+        sets[sets_count++] = (motion_set_t){ gait_names[g], gait_motions[g], GAIT_TOTAL_MOTIONS_COUNT };
+    }
+
+    printf("motion set            | points  | legacy max error [mm] | landing error [mm]\n");
+    bool is_passed = true;
+    point_3d_t positions[SUPPORT_LIMBS_COUNT];
+    memcpy(positions, sequence_walk_neutral_positions, sizeof(positions));
+    for (uint32_t s = 0; s < sets_count; ++s) {
+
+        check_report_t report = {0};
+        check_motion_set(&sets[s], positions, &report);
+        is_passed = is_passed && report.max_legacy_error <= LEGACY_MAX_ERROR && report.max_landing_error <= LEGACY_MAX_ERROR;
+
+        printf("%-21s | %7u | %21.6f | %18.6f\n", sets[s].name, report.points_count, report.max_legacy_error, report.max_landing_error);
+    }
+    printf("%s\n", is_passed ? "kernel matches legacy interpolation" : "KERNEL ERROR IS OUT OF TOLERANCE");
+    return is_passed ? 0 : 1;
+}
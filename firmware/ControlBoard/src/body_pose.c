@@ -0,0 +1,222 @@
+//  ***************************************************************************
+/// @file    body_pose.c
+/// @author  NeoProg
+//  ***************************************************************************
+#include "body_pose.h"
+#include "pwm.h"
+#include <math.h>
+
+#define DEG_TO_RAD(deg)                     ((deg) * 3.14159265f / 180.0f)
+
+
+static void build_transform(const body_pose_t* pose, body_pose_transform_t* transform);
+static bool ramp_value(float* value, float target, float rate);
+
+
+static body_pose_t g_target_pose = {0};
+static body_pose_t g_current_pose = {0};
+static body_pose_transform_t g_transform = {0};
+
+
+//  ***************************************************************************
+/// @brief  Body pose initialization
+/// @param  none
+/// @return none
+//  ***************************************************************************
+void body_pose_init(void) {
+    body_pose_t pose = {0};
+    g_target_pose = pose;
+    g_current_pose = pose;
+    build_transform(&g_current_pose, &g_transform);
+}
+
+//  ***************************************************************************
+/// @brief  Set target body pose
+/// @note   Current pose ramp to target in body_pose_process()
+/// @param  pose: target pose. Values are limited by BODY_POSE_MAX_ANGLE and BODY_POSE_MAX_OFFSET
+/// @return none
+//  ***************************************************************************
+void body_pose_set_target(const body_pose_t* pose) {
+    
+    float* dst[6] = { &g_target_pose.roll, &g_target_pose.pitch, &g_target_pose.yaw, 
+                      &g_target_pose.offset.x, &g_target_pose.offset.y, &g_target_pose.offset.z };
+    float src[6] = { pose->roll, pose->pitch, pose->yaw, pose->offset.x, pose->offset.y, pose->offset.z };
+    
+    for (uint32_t i = 0; i < 6; ++i) {
+        float limit = (i < 3) ? BODY_POSE_MAX_ANGLE : BODY_POSE_MAX_OFFSET;
+        if (src[i] > +limit) src[i] = +limit;
+        if (src[i] < -limit) src[i] = -limit;
+        *dst[i] = src[i];
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Ramp current pose to target pose
+/// @note   Call once per PWM period. Ramp rates are scaled for current PWM
+///         frequency
+/// @param  none
+/// @return true - transform changed, false - no
+//  ***************************************************************************
+bool body_pose_process(void) {
+    
+    float rate_scale = (float)PWM_FREQUENCY_HZ / (float)pwm_get_frequency();
+    float angle_rate = BODY_POSE_ANGLE_RATE * rate_scale;
+    float offset_rate = BODY_POSE_OFFSET_RATE * rate_scale;
+
+    bool is_changed = false;
+    is_changed |= ramp_value(&g_current_pose.roll,     g_target_pose.roll,     angle_rate);
+    is_changed |= ramp_value(&g_current_pose.pitch,    g_target_pose.pitch,    angle_rate);
+    is_changed |= ramp_value(&g_current_pose.yaw,      g_target_pose.yaw,      angle_rate);
+    is_changed |= ramp_value(&g_current_pose.offset.x, g_target_pose.offset.x, offset_rate);
+    is_changed |= ramp_value(&g_current_pose.offset.y, g_target_pose.offset.y, offset_rate);
+    is_changed |= ramp_value(&g_current_pose.offset.z, g_target_pose.offset.z, offset_rate);
+    
+    if (is_changed) {
+        build_transform(&g_current_pose, &g_transform);
+    }
+    return is_changed;
+}
+
+//  ***************************************************************************
+/// @brief  Get current body pose transform
+/// @param  none
+/// @return transform
+//  ***************************************************************************
+const body_pose_transform_t* body_pose_get_transform(void) {
+    return &g_transform;
+}
+
+//  ***************************************************************************
+/// @brief  Apply body pose transform to limbs points
+/// @note   Points are in structure-of-arrays layout. Input and output can be 
+///         same arrays
+/// @param  transform: transform. @ref body_pose_transform_t
+/// @param  x, y, z: points coordinates
+/// @param  out_x, out_y, out_z: transformed points coordinates
+/// @param  count: points count
+/// @retval out_x, out_y, out_z
+/// @return none
+//  ***************************************************************************
+void body_pose_apply(const body_pose_transform_t* transform, const float* x, const float* y, const float* z,
+                     float* out_x, float* out_y, float* out_z, uint32_t count) {
+    
+    if (transform->is_identity) {
+        for (uint32_t i = 0; i < count; ++i) {
+            out_x[i] = x[i];
+            out_y[i] = y[i];
+            out_z[i] = z[i];
+        }
+        return;
+    }
+    
+    const float (*m)[3] = transform->matrix;
+    for (uint32_t i = 0; i < count; ++i) {
+        float px = x[i];
+        float py = y[i];
+        float pz = z[i];
+        out_x[i] = m[0][0] * px + m[0][1] * py + m[0][2] * pz + transform->offset.x;
+        out_y[i] = m[1][0] * px + m[1][1] * py + m[1][2] * pz + transform->offset.y;
+        out_z[i] = m[2][0] * px + m[2][1] * py + m[2][2] * pz + transform->offset.z;
+    }
+}
+
+
+
+//  ***************************************************************************
+/// @brief  Apply inverse body pose transform to limbs points
+/// @note   Matrix is rotation, so inverse is p = M^T * (p' - offset). Input 
+///         and output can be same arrays
+/// @param  transform: transform. @ref body_pose_transform_t
+/// @param  x, y, z: transformed points coordinates
+/// @param  out_x, out_y, out_z: points coordinates
+/// @param  count: points count
+/// @retval out_x, out_y, out_z
+/// @return none
+//  ***************************************************************************
+void body_pose_apply_inverse(const body_pose_transform_t* transform, const float* x, const float* y, const float* z,
+                             float* out_x, float* out_y, float* out_z, uint32_t count) {
+    
+    if (transform->is_identity) {
+        for (uint32_t i = 0; i < count; ++i) {
+            out_x[i] = x[i];
+            out_y[i] = y[i];
+            out_z[i] = z[i];
+        }
+        return;
+    }
+    
+    const float (*m)[3] = transform->matrix;
+    for (uint32_t i = 0; i < count; ++i) {
+        float px = x[i] - transform->offset.x;
+        float py = y[i] - transform->offset.y;
+        float pz = z[i] - transform->offset.z;
+        out_x[i] = m[0][0] * px + m[1][0] * py + m[2][0] * pz;
+        out_y[i] = m[0][1] * px + m[1][1] * py + m[2][1] * pz;
+        out_z[i] = m[0][2] * px + m[1][2] * py + m[2][2] * pz;
+    }
+}
+
+
+
+//  ***************************************************************************
+/// @brief  Build transform for pose
+/// @note   Body pose is R = Ry(yaw) * Rx(pitch) * Rz(roll) and translation T.
+///         Limbs points are fixed on ground, so points in body coordinate system
+///         are p' = R^T * (p - T). Matrix is R^T, offset is -R^T * T
+/// @param  pose: body pose
+/// @param  transform: transform
+/// @retval transform
+/// @return none
+//  ***************************************************************************
+static void build_transform(const body_pose_t* pose, body_pose_transform_t* transform) {
+    
+    transform->is_identity = (pose->roll == 0 && pose->pitch == 0 && pose->yaw == 0 && 
+                              pose->offset.x == 0 && pose->offset.y == 0 && pose->offset.z == 0);
+    
+    float cr = cosf(DEG_TO_RAD(pose->roll)),  sr = sinf(DEG_TO_RAD(pose->roll));
+    float cp = cosf(DEG_TO_RAD(pose->pitch)), sp = sinf(DEG_TO_RAD(pose->pitch));
+    float cy = cosf(DEG_TO_RAD(pose->yaw)),   sy = sinf(DEG_TO_RAD(pose->yaw));
+    
+    // R = Ry * Rx * Rz
+    float r[3][3] = {
+        { cy * cr + sy * sp * sr,  -cy * sr + sy * sp * cr,  sy * cp },
+        { cp * sr,                  cp * cr,                -sp      },
+        { -sy * cr + cy * sp * sr,  sy * sr + cy * sp * cr,  cy * cp }
+    };
+    
+    // Matrix = R^T
+    for (uint32_t i = 0; i < 3; ++i) {
+        for (uint32_t k = 0; k < 3; ++k) {
+            transform->matrix[i][k] = r[k][i];
+        }
+    }
+    
+    // Offset = -R^T * T
+    const float (*m)[3] = transform->matrix;
+    transform->offset.x = -(m[0][0] * pose->offset.x + m[0][1] * pose->offset.y + m[0][2] * pose->offset.z);
+    transform->offset.y = -(m[1][0] * pose->offset.x + m[1][1] * pose->offset.y + m[1][2] * pose->offset.z);
+    transform->offset.z = -(m[2][0] * pose->offset.x + m[2][1] * pose->offset.y + m[2][2] * pose->offset.z);
+}
+
+//  ***************************************************************************
+/// @brief  Move value to target with limited rate
+/// @param  value: value
+/// @param  target: target value
+/// @param  rate: max change
+/// @retval value
+/// @return true - value changed, false - no
+//  ***************************************************************************
+static bool ramp_value(float* value, float target, float rate) {
+    
+    float delta = target - *value;
+    if (delta == 0) {
+        return false;
+    }
+    if (fabsf(delta) <= rate) {
+        *value = target;
+    }
+    else {
+        *value += (delta > 0) ? rate : -rate;
+    }
+    return true;
+}
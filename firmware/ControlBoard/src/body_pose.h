@@ -0,0 +1,44 @@
+//  ***************************************************************************
+/// @file    body_pose.h
+/// @author  NeoProg
+/// @brief   Body pose transform (rotation and translation of body over limbs)
+/// @note    Host compilable (no hardware dependencies)
+//  ***************************************************************************
+#ifndef _BODY_POSE_H_
+#define _BODY_POSE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "motion_core.h"
+
+#define BODY_POSE_MAX_ANGLE                 (15)        // Max roll/pitch/yaw, [degree]
+#define BODY_POSE_MAX_OFFSET                (30)        // Max translation, [mm]
+#define BODY_POSE_ANGLE_RATE                (0.11f)     // Pose ramp per PWM period at PWM_FREQUENCY_HZ, [degree] (~30 deg/s)
+#define BODY_POSE_OFFSET_RATE               (0.22f)     // Pose ramp per PWM period at PWM_FREQUENCY_HZ, [mm] (~60 mm/s)
+
+
+typedef struct {
+    float roll;                     // Rotate on axis Z, [degree]
+    float pitch;                    // Rotate on axis X, [degree]
+    float yaw;                      // Rotate on axis Y, [degree]
+    point_3d_t offset;              // Body translation, [mm]
+} body_pose_t;
+
+typedef struct {
+    bool is_identity;
+    float matrix[3][3];
+    point_3d_t offset;
+} body_pose_transform_t;
+
+
+extern void body_pose_init(void);
+extern void body_pose_set_target(const body_pose_t* pose);
+extern bool body_pose_process(void);
+extern const body_pose_transform_t* body_pose_get_transform(void);
+extern void body_pose_apply(const body_pose_transform_t* transform, const float* x, const float* y, const float* z,
+                            float* out_x, float* out_y, float* out_z, uint32_t count);
+extern void body_pose_apply_inverse(const body_pose_transform_t* transform, const float* x, const float* y, const float* z,
+                                    float* out_x, float* out_y, float* out_z, uint32_t count);
+
+
+#endif // _BODY_POSE_H_
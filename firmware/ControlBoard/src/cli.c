@@ -10,6 +10,8 @@
 #include "configurator.h"
 #include "servo_driver.h"
 #include "motion_core.h"
+#include "sequences_storage.h"
+#include "cue_scheduler.h"
 #include "indication.h"
 #include "version.h"
 
@@ -127,6 +129,21 @@ static bool process_command(const char* module, const char* cmd, char (*argv)[CL
                           CLI_HELP("    - calibration <pulse_width>           - start servo calibration")
                           CLI_HELP("    - set_override_level <servo> <level>  - set override level")
                           CLI_HELP("    - set_override_value <servo> <value>  - set override value")
+                          CLI_HELP("    - stat                                - get recalculated channels per second")
+                          CLI_HELP("")
+                          CLI_HELP("\"motion\" core commands description")
+                          CLI_HELP("    - status                              - get motion status")
+                          CLI_HELP("    - reach                               - get reachability envelope and clamps")
+                          CLI_HELP("    - set-speed <percent>                 - set motion speed (25-400%%)")
+                          CLI_HELP("")
+                          CLI_HELP("\"sequence\" storage commands description")
+                          CLI_HELP("    - begin, write <offset> <HEX data>    - upload sequence image")
+                          CLI_HELP("    - commit                              - validate and store image")
+                          CLI_HELP("    - list, erase, select <index>         - manage uploaded sequences")
+                          CLI_HELP("")
+                          CLI_HELP("\"cue\" scheduler commands description")
+                          CLI_HELP("    - add <ms> <seq> [spd] [curv] [dist]  - append cue to show")
+                          CLI_HELP("    - start [delay], stop, list, clear    - manage show")
                           CLI_HELP("")
                           CLI_HELP("\"config\" module commands description")
                           CLI_HELP("    - read <page>                         - read page (256 bytes)")
@@ -155,8 +172,10 @@ static bool process_command(const char* module, const char* cmd, char (*argv)[CL
             sprintf(response, CLI_OK("system status report")
                               CLI_OK("    - system_status: 0x%04X")
                               CLI_OK("    - module_status: 0x%04X")
-                              CLI_OK("    - battery voltage: %d mV"),
-                    sysmon_system_status, sysmon_module_status, sysmon_battery_voltage);
+                              CLI_OK("    - battery voltage: %d mV")
+                              CLI_OK("    - voltage droop: last %d mV, max %d mV"),
+                    sysmon_system_status, sysmon_module_status, sysmon_battery_voltage,
+                    sysmon_voltage_droop, sysmon_max_voltage_droop);
         }
         else if (strcmp(cmd, "reset") == 0) {
             servo_driver_power_off();
@@ -170,9 +189,15 @@ static bool process_command(const char* module, const char* cmd, char (*argv)[CL
     else if (strcmp(module, "servo") == 0) {
         return servo_driver_cli_command_process(cmd, argv, argc, response);
     }
-    /*else if (strcmp(module, "motion") == 0) {
+    else if (strcmp(module, "motion") == 0) {
         return motion_core_cli_command_process(cmd, argv, argc, response);
-    }*/
+    }
+    else if (strcmp(module, "sequence") == 0) {
+        return sequences_storage_cli_command_process(cmd, argv, argc, response);
+    }
+    else if (strcmp(module, "cue") == 0) {
+        return cue_scheduler_cli_command_process(cmd, argv, argc, response);
+    }
     else if (strcmp(module, "config") == 0) {
         return config_cli_command_process(cmd, argv, argc, response);
     }
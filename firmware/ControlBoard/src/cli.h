@@ -21,7 +21,7 @@
 #define CLI_COLOR_WHITE         "\x1B[37m"
 #define CLI_COLOR_RESET         "\x1B[0m"
 
-#define CLI_ARG_COUNT           (3)
+#define CLI_ARG_COUNT           (5)
 #define CLI_ARG_MAX_SIZE        (64)
 
 
@@ -17,7 +17,9 @@
 #define CONFIG_SECTION_SIZE                 (CONFIG_SECTION_PAGE_SIZE * CONFIG_SECTION_PAGE_COUNT)
 
 #define CONFIG_SECTION_MAX_READ_SIZE        (128)
-#define CONFIG_SECTION_MAX_WRITE_SIZE       (32)
+#define CONFIG_SECTION_MAX_WRITE_SIZE       (32)        // EEPROM page size (write should not cross page boundary)
+
+#define STORAGE_SIZE                        (MM_SEQUENCES_BASE_EE_ADDRESS + MM_SEQUENCES_SECTION_SIZE) // 24C32 or bigger
 
 
 static uint8_t cli_buffer[CONFIG_SECTION_PAGE_SIZE] = {0};
@@ -58,7 +60,8 @@ bool config_check_intergity(void) {
 }
 
 //  ***************************************************************************
-/// @brief  Read data from configuration section
+/// @brief  Read data from storage
+/// @note   Configuration section and uploaded sequences section
 /// @param  address: data block address
 /// @param  buffer: buffer for data
 /// @param  bytes_count: bytes count for read
@@ -74,7 +77,7 @@ bool config_read(uint32_t address, uint8_t* buffer, uint32_t bytes_count) {
     }
 
 
-    if (address + bytes_count > CONFIG_SECTION_SIZE) {
+    if (address + bytes_count > STORAGE_SIZE) {
         sysmon_set_error(SYSMON_FATAL_ERROR);
         sysmon_disable_module(SYSMON_MODULE_CONFIGURATOR);
         return false;
@@ -91,14 +94,15 @@ bool config_read(uint32_t address, uint8_t* buffer, uint32_t bytes_count) {
         }
         
         bytes_count -= block_size;
-        address += bytes_count;
-        buffer += bytes_count;
+        address += block_size;
+        buffer += block_size;
     }
     return true;
 }
 
 //  ***************************************************************************
-/// @brief  Write data to configuration section
+/// @brief  Write data to storage
+/// @note   Configuration section and uploaded sequences section
 /// @param  address: data block address
 /// @param  data: data for write
 /// @param  bytes_count: bytes count for write
@@ -111,7 +115,7 @@ bool config_write(uint32_t address, uint8_t* data, uint32_t bytes_count) {
     }
 
 
-    if (address + bytes_count > CONFIG_SECTION_SIZE) {
+    if (address + bytes_count > STORAGE_SIZE) {
         sysmon_set_error(SYSMON_FATAL_ERROR);
         sysmon_disable_module(SYSMON_MODULE_CONFIGURATOR);
         return false;
@@ -119,7 +123,8 @@ bool config_write(uint32_t address, uint8_t* data, uint32_t bytes_count) {
     
     while (bytes_count != 0) {
         
-        uint32_t block_size = (bytes_count < CONFIG_SECTION_MAX_WRITE_SIZE) ? bytes_count : CONFIG_SECTION_MAX_WRITE_SIZE;
+        uint32_t page_free_size = CONFIG_SECTION_MAX_WRITE_SIZE - (address % CONFIG_SECTION_MAX_WRITE_SIZE);
+        uint32_t block_size = (bytes_count < page_free_size) ? bytes_count : page_free_size;
    
         if (i2c1_write(STORAGE_DEVICE_ADDRESS, address, 2, data, block_size) == false) {
             sysmon_set_error(SYSMON_I2C_ERROR | SYSMON_MEMORY_ERROR);
@@ -129,8 +134,8 @@ bool config_write(uint32_t address, uint8_t* data, uint32_t bytes_count) {
         delay_ms(10);
         
         bytes_count -= block_size;
-        address += bytes_count;
-        data += bytes_count;
+        address += block_size;
+        data += block_size;
     }
     return true;
 }
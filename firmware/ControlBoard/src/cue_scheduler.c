@@ -0,0 +1,228 @@
+//  ***************************************************************************
+/// @file    cue_scheduler.c
+/// @author  NeoProg
+//  ***************************************************************************
+#include "cue_scheduler.h"
+#include "project_base.h"
+#include "sequences_engine.h"
+#include "motion_core.h"
+#include "pwm.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+
+static cue_t cue_list[CUE_SCHEDULER_MAX_CUES] = {0};
+static uint32_t cues_count = 0;
+
+static bool is_show_running = false;
+static uint64_t show_start_period = 0;      // Motion clock value of show start command, [PWM periods]
+static uint32_t show_delay = 0;             // Show start delay, [ms]
+static uint32_t next_cue = 0;
+static uint32_t max_late_periods = 0;       // Max first motion delay of cue sequence of last show, [PWM periods]
+
+
+static uint64_t get_cue_period(uint32_t time, float* offset);
+
+
+//  ***************************************************************************
+/// @brief  Cue scheduler process
+/// @note   Call before sequences engine process. Cue is passed to sequences
+///         engine after start of previous cue sequence, engine selects it
+///         ahead of cue time. Expired cues are skipped if next cue is
+///         expired too, last expired cue is used
+/// @param  none
+/// @return none
+//  ***************************************************************************
+void cue_scheduler_process(void) {
+
+    if (is_show_running == false) return;
+
+    // Lateness is measured on first tick of cue sequence
+    uint32_t late_periods = 0;
+    if (motion_core_get_start_late(&late_periods) == true && late_periods > max_late_periods) {
+        max_late_periods = late_periods;
+    }
+    if (sequences_engine_is_sequence_scheduled() == true) {
+        return; // Previous cue sequence is not started yet
+    }
+    if (next_cue >= cues_count) {
+        is_show_running = false;
+        return;
+    }
+
+    float offset = 0;
+    while (next_cue + 1 < cues_count && show_start_period + get_cue_period(show_delay + cue_list[next_cue + 1].start_time, &offset) <= synchro) {
+        ++next_cue;
+    }
+    const cue_t* cue = &cue_list[next_cue];
+    uint64_t cue_period = show_start_period + get_cue_period(show_delay + cue->start_time, &offset);
+    float speed = (float)cue->speed / 100.0f;
+    sequences_engine_schedule_sequence((sequence_id_t)cue->sequence, cue->curvature, cue->distance, speed, cue_period, offset);
+    ++next_cue;
+}
+
+//  ***************************************************************************
+/// @brief  Write cue to queue
+/// @note   Queue can not be changed while show is running. Cues should be
+///         sorted by start time
+/// @param  index: cue index. Index equal to cues count appends cue
+/// @param  cue: cue. @ref cue_t
+/// @return true - success, false - wrong index or cue
+//  ***************************************************************************
+bool cue_scheduler_write_cue(uint32_t index, const cue_t* cue) {
+
+    if (is_show_running == true || index > cues_count || index >= CUE_SCHEDULER_MAX_CUES) {
+        return false;
+    }
+    if (cue->sequence >= SUPPORT_SEQUENCE_COUNT) {
+        return false;
+    }
+    if (index > 0 && cue->start_time < cue_list[index - 1].start_time) {
+        return false;
+    }
+    if (index + 1 < cues_count && cue->start_time > cue_list[index + 1].start_time) {
+        return false;
+    }
+
+    cue_list[index] = *cue;
+    if (index == cues_count) {
+        ++cues_count;
+    }
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Clear cue queue
+/// @param  none
+/// @return true - success, false - show is running
+//  ***************************************************************************
+bool cue_scheduler_clear(void) {
+
+    if (is_show_running == true) {
+        return false;
+    }
+    cues_count = 0;
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Start show
+/// @param  delay: show start delay, [ms]
+/// @return true - success, false - queue is empty
+//  ***************************************************************************
+bool cue_scheduler_start(uint32_t delay) {
+
+    if (cues_count == 0) {
+        return false;
+    }
+    sequences_engine_cancel_schedule();
+    show_start_period = synchro;
+    show_delay = delay;
+    next_cue = 0;
+    max_late_periods = 0;
+    is_show_running = true;
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Stop show
+/// @note   Current sequence is not changed, scheduled sequence start is
+///         cancelled
+/// @param  none
+/// @return none
+//  ***************************************************************************
+void cue_scheduler_stop(void) {
+    if (is_show_running == true) {
+        sequences_engine_cancel_schedule();
+        is_show_running = false;
+    }
+}
+
+//  ***************************************************************************
+/// @brief  CLI command process
+/// @param  cmd: command string
+/// @param  argv: argument list
+/// @param  argc: arguments count
+/// @param  response: response
+/// @retval response
+/// @return true - success, false - fail
+//  ***************************************************************************
+bool cue_scheduler_cli_command_process(const char* cmd, const char (*argv)[CLI_ARG_MAX_SIZE], uint32_t argc, char* response) {
+
+    if (strcmp(cmd, "add") == 0 && argc >= 2) {
+
+        // Arguments are checked before narrowing to cue fields
+        int32_t sequence  = atoi(argv[1]);
+        int32_t speed     = (argc >= 3) ? atoi(argv[2]) : 0;
+        int32_t curvature = (argc >= 4) ? atoi(argv[3]) : 0;
+        int32_t distance  = (argc >= 5) ? atoi(argv[4]) : 0;
+        if (sequence < 0 || sequence >= SUPPORT_SEQUENCE_COUNT || speed < 0 || speed > UINT16_MAX ||
+            curvature < INT16_MIN || curvature > INT16_MAX || distance < 0 || distance > UINT8_MAX) {
+            strcpy(response, CLI_ERROR("Cue argument is out of range"));
+            return false;
+        }
+
+        cue_t cue = {0};
+        cue.start_time = strtoul(argv[0], NULL, 10);
+        cue.sequence   = (uint8_t)sequence;
+        cue.speed      = (uint16_t)speed;
+        cue.curvature  = (int16_t)curvature;
+        cue.distance   = (uint8_t)distance;
+        if (cue_scheduler_write_cue(cues_count, &cue) == false) {
+            strcpy(response, CLI_ERROR("Cannot add cue (queue is full, show is running or wrong sequence or time)"));
+            return false;
+        }
+    }
+    else if (strcmp(cmd, "clear") == 0 && argc == 0) {
+        if (cue_scheduler_clear() == false) {
+            strcpy(response, CLI_ERROR("Show is running"));
+            return false;
+        }
+    }
+    else if (strcmp(cmd, "start") == 0 && argc <= 1) {
+        uint32_t delay = (argc == 1) ? strtoul(argv[0], NULL, 10) : 0;
+        if (cue_scheduler_start(delay) == false) {
+            strcpy(response, CLI_ERROR("Cue queue is empty"));
+            return false;
+        }
+    }
+    else if (strcmp(cmd, "stop") == 0 && argc == 0) {
+        cue_scheduler_stop();
+    }
+    else if (strcmp(cmd, "list") == 0 && argc == 0) {
+
+        response += sprintf(response, CLI_OK("cues: %lu, show: %s, next cue: %lu, max late: %lu periods"), cues_count,
+                            is_show_running ? "running" : "stopped", next_cue, max_late_periods);
+        for (uint32_t i = 0; i < cues_count; ++i) {
+            const cue_t* cue = &cue_list[i];
+            response += sprintf(response, CLI_OK("    - %lu: %lu ms, sequence %lu, speed %lu, curvature %ld, distance %lu"), i, cue->start_time,
+                                (uint32_t)cue->sequence, (uint32_t)cue->speed, (int32_t)cue->curvature, (uint32_t)cue->distance);
+        }
+    }
+    else {
+        strcpy(response, CLI_ERROR("Unknown command or format for cue"));
+        return false;
+    }
+    return true;
+}
+
+
+
+
+
+//  ***************************************************************************
+/// @brief  Convert time to motion clock periods
+/// @note   Time is rounded up to PWM period boundary, elapsed part of period
+///         is carried to motion clock of first motion
+/// @param  time: time, [ms]
+/// @param  offset: part of PWM period elapsed from time on returned period [0; 1)
+/// @retval offset
+/// @return PWM periods count
+//  ***************************************************************************
+static uint64_t get_cue_period(uint32_t time, float* offset) {
+    uint64_t scaled_time = (uint64_t)time * pwm_get_frequency(); // [periods / 1000]
+    uint64_t period = (scaled_time + 999) / 1000;
+    *offset = (float)(period * 1000 - scaled_time) / 1000.0f;
+    return period;
+}
@@ -0,0 +1,41 @@
+//  ***************************************************************************
+/// @file    cue_scheduler.h
+/// @author  NeoProg
+/// @brief   Choreography cue scheduler
+/// @note    Cue queue is uploaded ahead of show over SWLP or CLI. Cues are
+///          executed against PWM periods counter (motion clock): first
+///          motion of cue sequence starts at cue time. Sequences engine 
+///          selects sequence ahead (transition from current sequence is 
+///          estimated) and first motion waits cue time in motion core. Cue
+///          time is rounded up to PWM period, elapsed part of period is
+///          carried to motion clock. Lateness is measured on first motion tick
+//  ***************************************************************************
+#ifndef _CUE_SCHEDULER_H_
+#define _CUE_SCHEDULER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cli.h"
+
+#define CUE_SCHEDULER_MAX_CUES              (32)
+
+
+typedef struct {
+    uint32_t start_time;    // Cue start time from show start, [ms]
+    uint8_t  sequence;      // Sequence for select. @ref sequence_id_t
+    uint8_t  distance;      // Step length for walk sequences
+    int16_t  curvature;     // Curvature for walk sequences
+    uint16_t speed;         // Motion speed [%]. 0 - do not change
+} cue_t;
+
+
+extern void cue_scheduler_process(void);
+extern bool cue_scheduler_write_cue(uint32_t index, const cue_t* cue);
+extern bool cue_scheduler_clear(void);
+extern bool cue_scheduler_start(uint32_t delay);
+extern void cue_scheduler_stop(void);
+
+extern bool cue_scheduler_cli_command_process(const char* cmd, const char (*argv)[CLI_ARG_MAX_SIZE], uint32_t argc, char* response);
+
+
+#endif // _CUE_SCHEDULER_H_
@@ -9,63 +9,165 @@
 
 #define PWM_CHANNEL_DISABLE_VALUE       (0xFFFF)
 #define PWM_CHANNEL_PULSE_TRIM          (3)
+#define PWM_MIN_LOW_LEVEL_US            (100)   // Min LOW level time of channel before next PWM period
 
-#define PWM_FREQUENCY_HZ                (270)
-#define PWM_PERIOD_US                   (1000000 / PWM_FREQUENCY_HZ)
+#define PWM_DMA_EDGE_OFFSET             (1)     // TIM5 compare value: edge is written on 1 tick after TIM5 update
+#define PWM_DMA_MIN_EDGE_TICKS          (PWM_DMA_EDGE_OFFSET + 2)
+#define PWM_MAX_EDGES_COUNT             (SUPPORT_PWM_CHANNELS_COUNT * 2)   // Rising and falling edge for each channel
+#define PWM_DMA_MAX_WORDS_COUNT         (PWM_MAX_EDGES_COUNT + 1)
 
-#if PWM_PERIOD_US > 65535
-#error "PWM period should be less 65535, check PWM_FREQUENCY_HZ value"
-#endif // PWM_PERIOD_US
+#if 1000000 / PWM_MIN_FREQUENCY_HZ > 65535
+#error "PWM period should be less 65535, check PWM_MIN_FREQUENCY_HZ value"
+#endif
 
 
 typedef struct {
     uint32_t ticks;
     GPIO_TypeDef* gpio_port;
     uint32_t gpio_pin;
+    uint32_t port_index;        // Index in used GPIO ports list
+    uint32_t start_offset;      // Pulse start time, [us]
 } pwm_channel_t;
 
+typedef struct {
+    uint16_t ticks;             // Event time, [us]
+    uint8_t  channel;
+    uint8_t  is_rising;
+} pwm_event_t;
+
+typedef struct {
+    uint32_t ticks;                                 // Edge time, [us]
+    uint32_t bsrr_values[PWM_MAX_GPIO_PORTS_COUNT]; // BSRR values for each used GPIO port: rising edges in low half, falling in high
+} pwm_edge_t;
+
+typedef struct {
+    uint32_t edges_count;
+    pwm_edge_t edges[PWM_MAX_EDGES_COUNT];          // Sorted by time, one edge per distinct time
+    uint16_t set_masks[PWM_MAX_GPIO_PORTS_COUNT];   // BSRR values for each used GPIO port on PWM period begin
+#if PWM_DMA_WAVEFORM_ENABLE
+    uint32_t dma_words_count;                                               // Words count for each DMA port stream
+    uint32_t dma_reload_list[PWM_DMA_MAX_WORDS_COUNT];                      // TIM5 ARR values, one per TIM5 cycle
+    uint32_t dma_words_list[PWM_DMA_PORTS_COUNT][PWM_DMA_MAX_WORDS_COUNT];  // BSRR values, one per TIM5 cycle
+#endif
+} pwm_schedule_t;
+
+
+#if PWM_EDGE_SCHEDULE_ENABLE
+static pwm_schedule_t schedules[2];
+static pwm_schedule_t* volatile active_schedule = &schedules[0];    // Schedule is walking by ISR
+static pwm_schedule_t* volatile pending_schedule = NULL;            // Schedule is ready for load on next PWM period
+#endif
+static GPIO_TypeDef* ports_list[PWM_MAX_GPIO_PORTS_COUNT];          // Used GPIO ports
+static uint32_t ports_count = 0;
+static uint32_t isr_first_port = 0;                                 // Ports from this index are processed by ISR
+#if PWM_DMA_WAVEFORM_ENABLE
+static DMA_Channel_TypeDef* const dma_port_channels[PWM_DMA_PORTS_COUNT] = { DMA2_Channel5, DMA2_Channel4, DMA2_Channel2 };
+static DMA_Channel_TypeDef* const dma_reload_channel = DMA2_Channel1; // TIM5 CC4
+#endif
+static volatile uint32_t isr_edge_max_cycles = 0;                   // Worst case of compare event process, [CPU cycles]
+static volatile uint32_t isr_period_max_cycles = 0;                 // Worst case of PWM period begin process, [CPU cycles]
 
 static pwm_channel_t* active_buffer_ptr[SUPPORT_PWM_CHANNELS_COUNT]; // Array of pointers to active buffer. For fast sorting
 static pwm_channel_t active_buffer[SUPPORT_PWM_CHANNELS_COUNT];      // Mirror of shadow buffer
-static pwm_channel_t shadow_buffer[SUPPORT_PWM_CHANNELS_COUNT] = {   // Not sorted buffer. Using for write data from user.
-    { .gpio_port = GPIOD, .gpio_pin =  8, .ticks = PWM_CHANNEL_DISABLE_VALUE },
-    { .gpio_port = GPIOB, .gpio_pin = 15, .ticks = PWM_CHANNEL_DISABLE_VALUE },
-    { .gpio_port = GPIOB, .gpio_pin = 14, .ticks = PWM_CHANNEL_DISABLE_VALUE },
-    { .gpio_port = GPIOE, .gpio_pin =  9, .ticks = PWM_CHANNEL_DISABLE_VALUE },
-    { .gpio_port = GPIOE, .gpio_pin =  8, .ticks = PWM_CHANNEL_DISABLE_VALUE },
-    { .gpio_port = GPIOB, .gpio_pin =  2, .ticks = PWM_CHANNEL_DISABLE_VALUE },
-    { .gpio_port = GPIOB, .gpio_pin =  1, .ticks = PWM_CHANNEL_DISABLE_VALUE },
-    { .gpio_port = GPIOB, .gpio_pin =  0, .ticks = PWM_CHANNEL_DISABLE_VALUE },
-    { .gpio_port = GPIOC, .gpio_pin =  5, .ticks = PWM_CHANNEL_DISABLE_VALUE },
-    
-    { .gpio_port = GPIOA, .gpio_pin =  0, .ticks = PWM_CHANNEL_DISABLE_VALUE },
-    { .gpio_port = GPIOA, .gpio_pin =  1, .ticks = PWM_CHANNEL_DISABLE_VALUE },
-    { .gpio_port = GPIOA, .gpio_pin =  2, .ticks = PWM_CHANNEL_DISABLE_VALUE },
-    { .gpio_port = GPIOA, .gpio_pin =  3, .ticks = PWM_CHANNEL_DISABLE_VALUE },
-    { .gpio_port = GPIOA, .gpio_pin =  4, .ticks = PWM_CHANNEL_DISABLE_VALUE },
-    { .gpio_port = GPIOA, .gpio_pin =  5, .ticks = PWM_CHANNEL_DISABLE_VALUE },
-    { .gpio_port = GPIOA, .gpio_pin =  6, .ticks = PWM_CHANNEL_DISABLE_VALUE },
-    { .gpio_port = GPIOA, .gpio_pin =  7, .ticks = PWM_CHANNEL_DISABLE_VALUE },
-    { .gpio_port = GPIOC, .gpio_pin =  4, .ticks = PWM_CHANNEL_DISABLE_VALUE },
-};
-static bool shadow_buffer_is_lock = false;
+static pwm_channel_t shadow_buffer[SUPPORT_PWM_CHANNELS_COUNT];      // Not sorted buffer. Using for write data from user.
+static const struct {
+    GPIO_TypeDef* gpio_port;
+    uint32_t gpio_pin;
+} channels_list[SUPPORT_PWM_CHANNELS_COUNT] = ROBOT_PWM_CHANNELS_LIST;  // Channels outputs from robot description
+static const uint16_t limb_start_offsets[ROBOT_LIMBS_COUNT] = ROBOT_PWM_LIMB_START_OFFSETS;
+static uint32_t pwm_frequency_hz = PWM_FREQUENCY_HZ;
+static uint32_t pwm_period_us = 1000000 / PWM_FREQUENCY_HZ;
+static uint32_t pwm_max_width = 0;                                  // Max pulse width of channels, [us]. 0 - unknown
+static volatile bool shadow_buffer_is_lock = false;
+static volatile bool shadow_buffer_is_changed = false;              // Shadow buffer has changes which not loaded to active buffer
 static bool pwm_disable_is_requested = false;
 
 uint64_t synchro = 0;
 
 
+static void init_ports_list(void);
+static uint32_t get_port_index(GPIO_TypeDef* gpio_port);
+#if PWM_EDGE_SCHEDULE_ENABLE
+static void build_schedule(void);
+#endif
+#if PWM_DMA_WAVEFORM_ENABLE
+static void build_waveform(pwm_schedule_t* schedule, const pwm_event_t* events, uint32_t events_count);
+static void start_waveform(const pwm_schedule_t* schedule);
+#endif
+
+//  ***************************************************************************
+/// @brief  Set PWM frequency (servo frame rate)
+/// @note   Call before PWM driver initialization. PWM period is motion clock
+///         period, default is PWM_FREQUENCY_HZ
+/// @param  frequency_hz: PWM frequency, [Hz]
+/// @param  max_width: max pulse width of channels, [us]
+/// @return true - success, false - frequency is out of range or max pulse
+///         is not fit to PWM period
+//  ***************************************************************************
+bool pwm_set_frequency(uint32_t frequency_hz, uint32_t max_width) {
+
+    if (frequency_hz < PWM_MIN_FREQUENCY_HZ || frequency_hz > PWM_MAX_FREQUENCY_HZ) {
+        return false;
+    }
+    if (max_width + PWM_MIN_LOW_LEVEL_US >= 1000000 / frequency_hz) {
+        return false;
+    }
+    pwm_frequency_hz = frequency_hz;
+    pwm_period_us = 1000000 / frequency_hz;
+    pwm_max_width = max_width;
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Get PWM frequency (motion clock frequency)
+/// @param  none
+/// @return PWM frequency, [Hz]
+//  ***************************************************************************
+uint32_t pwm_get_frequency(void) {
+    return pwm_frequency_hz;
+}
+
 //  ***************************************************************************
 /// @brief  PWM driver initialization
+/// @note   Pulse start offsets are compressed if max pulse width with max
+///         offset is not fit to PWM period
 /// @param  none
 /// @return none
 //  ***************************************************************************
 void pwm_init(void) {
+
+    uint32_t max_offset = 0;
+    for (uint32_t i = 0; i < ROBOT_LIMBS_COUNT; ++i) {
+        if (max_offset < limb_start_offsets[i]) {
+            max_offset = limb_start_offsets[i];
+        }
+    }
+    uint32_t offset_range = pwm_period_us - pwm_max_width - PWM_MIN_LOW_LEVEL_US;
     
-    // Initialization active buffer
+    // Initialization shadow and active buffers
+    init_ports_list();
     for (uint32_t i = 0; i < SUPPORT_PWM_CHANNELS_COUNT; ++i) {
+        shadow_buffer[i].gpio_port = channels_list[i].gpio_port;
+        shadow_buffer[i].gpio_pin  = channels_list[i].gpio_pin;
+        shadow_buffer[i].ticks     = PWM_CHANNEL_DISABLE_VALUE;
+        shadow_buffer[i].port_index = get_port_index(channels_list[i].gpio_port);
+        shadow_buffer[i].start_offset = limb_start_offsets[i / ROBOT_JOINTS_PER_LIMB];
+        if (max_offset > offset_range) {
+            shadow_buffer[i].start_offset = shadow_buffer[i].start_offset * offset_range / max_offset;
+        }
         active_buffer[i] = shadow_buffer[i];
         active_buffer_ptr[i] = &active_buffer[i];
     }
+#if PWM_EDGE_SCHEDULE_ENABLE
+    build_schedule();
+    active_schedule = pending_schedule;
+    pending_schedule = NULL;
+#endif
+
+    // Enable CPU cycles counter for ISR statistic
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 
     
     //
@@ -89,9 +191,32 @@ void pwm_init(void) {
     TIM17->CR1   = TIM_CR1_OPM | TIM_CR1_URS; 
     TIM17->DIER  = TIM_DIER_CC1IE | TIM_DIER_UIE;
     TIM17->PSC   = APB2_CLOCK_FREQUENCY / 1000000 - 1; // 1 tick = 1 us
-    TIM17->ARR   = PWM_PERIOD_US;
+    TIM17->ARR   = pwm_period_us;
     NVIC_EnableIRQ(TIM17_IRQn);
     NVIC_SetPriority(TIM17_IRQn, TIM17_IRQ_PRIORITY);
+
+#if PWM_DMA_WAVEFORM_ENABLE
+    //
+    // Setup waveform timer and DMA: each TIM5 cycle is one edge, CC events
+    // on PWM_DMA_EDGE_OFFSET tick of cycle write BSRR values and next cycle length
+    //
+    RCC->APB1RSTR |= RCC_APB1RSTR_TIM5RST;
+    RCC->APB1RSTR &= ~RCC_APB1RSTR_TIM5RST;
+
+    TIM5->CR1   = TIM_CR1_ARPE;
+    TIM5->PSC   = APB1_CLOCK_FREQUENCY * 2 / 1000000 - 1; // 1 tick = 1 us, APB1 timers clock is doubled
+    TIM5->CCR1  = PWM_DMA_EDGE_OFFSET;
+    TIM5->CCR2  = PWM_DMA_EDGE_OFFSET;
+    TIM5->CCR3  = PWM_DMA_EDGE_OFFSET;
+    TIM5->CCR4  = PWM_DMA_EDGE_OFFSET;
+
+    for (uint32_t i = 0; i < isr_first_port; ++i) {
+        dma_port_channels[i]->CCR  = (0x03 << DMA_CCR_PL_Pos) | (0x02 << DMA_CCR_MSIZE_Pos) | (0x02 << DMA_CCR_PSIZE_Pos) | DMA_CCR_MINC | DMA_CCR_DIR;
+        dma_port_channels[i]->CPAR = (uint32_t)(&ports_list[i]->BSRR);
+    }
+    dma_reload_channel->CCR  = (0x03 << DMA_CCR_PL_Pos) | (0x02 << DMA_CCR_MSIZE_Pos) | (0x02 << DMA_CCR_PSIZE_Pos) | DMA_CCR_MINC | DMA_CCR_DIR;
+    dma_reload_channel->CPAR = (uint32_t)(&TIM5->ARR);
+#endif // PWM_DMA_WAVEFORM_ENABLE
 }
 
 //  ***************************************************************************
@@ -123,29 +248,65 @@ void pwm_disable(void) {
 
 //  ***************************************************************************
 /// @brief  Lock shadow buffer
-/// @note   If buffer is lock, then data from shadow buffer not load to active
+/// @note   If buffer is lock, then data from shadow buffer not load to active.
+///         With edge schedule unlock builds schedule from shadow buffer in
+///         caller context, schedule is loaded on next PWM period
 /// @param  is_locked: true - buffer is lock, false - buffer is unlock
 /// @return none
 //  ***************************************************************************
 void pwm_set_shadow_buffer_lock_state(bool is_locked) {
 
     shadow_buffer_is_lock = is_locked;
+#if PWM_EDGE_SCHEDULE_ENABLE
+    if (is_locked == false && shadow_buffer_is_changed == true) {
+        shadow_buffer_is_changed = false;
+        build_schedule();
+    }
+#endif
 }
 
 //  ***************************************************************************
 /// @brief  Set PWM channel pulse width
+/// @note   Call while shadow buffer is lock
 /// @param  channel: PWM channel index
 /// @param  width: pulse width
-/// @return none
+/// @return true - channel pulse width changed, false - no
 //  ***************************************************************************
-void pwm_set_width(uint32_t channel, uint32_t width) {
+bool pwm_set_width(uint32_t channel, uint32_t width) {
     
     int32_t ticks = (int32_t)width - PWM_CHANNEL_PULSE_TRIM;
     if (ticks < 0) {
         ticks = 0;
     }
     
+    if (shadow_buffer[channel].ticks == (uint32_t)ticks) {
+        return false;
+    }
     shadow_buffer[channel].ticks = ticks;
+    shadow_buffer_is_changed = true;
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Get PWM timer ISR worst case execution time
+/// @param  edge_max_cycles: compare event process time, [CPU cycles]
+/// @param  period_max_cycles: PWM period begin process time, [CPU cycles]
+/// @retval edge_max_cycles, period_max_cycles
+/// @return none
+//  ***************************************************************************
+void pwm_get_isr_statistic(uint32_t* edge_max_cycles, uint32_t* period_max_cycles) {
+    *edge_max_cycles = isr_edge_max_cycles;
+    *period_max_cycles = isr_period_max_cycles;
+}
+
+//  ***************************************************************************
+/// @brief  Reset PWM timer ISR worst case execution time
+/// @param  none
+/// @return none
+//  ***************************************************************************
+void pwm_reset_isr_statistic(void) {
+    isr_edge_max_cycles = 0;
+    isr_period_max_cycles = 0;
 }
 
 
@@ -157,9 +318,11 @@ void pwm_set_width(uint32_t channel, uint32_t width) {
 /// @param  none
 /// @return none
 //  ***************************************************************************
+#if PWM_EDGE_SCHEDULE_ENABLE == 0
 void TIM17_IRQHandler(void) {
     
     static uint32_t ch_cursor = 0;
+    uint32_t begin_cycles = DWT->CYCCNT;
 
     // Read and clear status register
     uint32_t status = TIM17->SR;
@@ -184,6 +347,11 @@ void TIM17_IRQHandler(void) {
             // Go to next PWM channel
             ++ch_cursor;
         }
+
+        uint32_t cycles = DWT->CYCCNT - begin_cycles;
+        if (cycles > isr_edge_max_cycles) {
+            isr_edge_max_cycles = cycles;
+        }
     }
     if (status & TIM_SR_UIF) {  // We are reached end of PWM period
         
@@ -192,20 +360,22 @@ void TIM17_IRQHandler(void) {
             return;
         }
 
-        // Sync shadow buffer with active buffer if it unlock
-        if (shadow_buffer_is_lock == false) {
+        // Sync shadow buffer with active buffer if it unlock and changed. 
+        // Active buffer is sorted already if it not changed
+        if (shadow_buffer_is_lock == false && shadow_buffer_is_changed == true) {
             memcpy(active_buffer, shadow_buffer, sizeof(active_buffer));
-        }
+            shadow_buffer_is_changed = false;
 
-        // Sorting PWM channels: bubble sorting method
-        for (uint32_t i = 0; i < SUPPORT_PWM_CHANNELS_COUNT - 1; ++i) {
+            // Sorting PWM channels: bubble sorting method
+            for (uint32_t i = 0; i < SUPPORT_PWM_CHANNELS_COUNT - 1; ++i) {
 
-            for (uint32_t j = 0; j < SUPPORT_PWM_CHANNELS_COUNT - i - 1; ++j) {
+                for (uint32_t j = 0; j < SUPPORT_PWM_CHANNELS_COUNT - i - 1; ++j) {
 
-                if (active_buffer_ptr[j]->ticks > active_buffer_ptr[j + 1]->ticks) {
-                    pwm_channel_t* temp = active_buffer_ptr[j];
-                    active_buffer_ptr[j] = active_buffer_ptr[j + 1];
-                    active_buffer_ptr[j + 1] = temp;
+                    if (active_buffer_ptr[j]->ticks > active_buffer_ptr[j + 1]->ticks) {
+                        pwm_channel_t* temp = active_buffer_ptr[j];
+                        active_buffer_ptr[j] = active_buffer_ptr[j + 1];
+                        active_buffer_ptr[j + 1] = temp;
+                    }
                 }
             }
         }
@@ -221,5 +391,288 @@ void TIM17_IRQHandler(void) {
         TIM17->CR1 |= TIM_CR1_CEN;
 
         ++synchro;
+
+        uint32_t cycles = DWT->CYCCNT - begin_cycles;
+        if (cycles > isr_period_max_cycles) {
+            isr_period_max_cycles = cycles;
+        }
+    }
+}
+#else
+void TIM17_IRQHandler(void) {
+
+    static uint32_t edge_cursor = 0;
+    uint32_t begin_cycles = DWT->CYCCNT;
+
+    // Read and clear status register
+    uint32_t status = TIM17->SR;
+    TIM17->SR = 0;
+
+    //
+    // Process events
+    //
+    const pwm_schedule_t* schedule = active_schedule;
+    if ((status & TIM_SR_CC1IF) && edge_cursor < schedule->edges_count) {
+
+        // Set levels for PWM outputs of current edge. Next edges can be
+        // passed while processing - them are processed immediately
+        do {
+            const pwm_edge_t* edge = &schedule->edges[edge_cursor++];
+            for (uint32_t i = isr_first_port; i < ports_count; ++i) {
+                ports_list[i]->BSRR = edge->bsrr_values[i];
+            }
+        } while (edge_cursor < schedule->edges_count && schedule->edges[edge_cursor].ticks <= TIM17->CNT + 1);
+
+        // Load time for next edge
+        if (edge_cursor < schedule->edges_count) {
+            TIM17->CCR1 = schedule->edges[edge_cursor].ticks;
+        }
+
+        uint32_t cycles = DWT->CYCCNT - begin_cycles;
+        if (cycles > isr_edge_max_cycles) {
+            isr_edge_max_cycles = cycles;
+        }
+    }
+    if (status & TIM_SR_UIF) {  // We are reached end of PWM period
+
+        // Check disable PWM request
+        if (pwm_disable_is_requested == true) {
+#if PWM_DMA_WAVEFORM_ENABLE
+            TIM5->CR1 &= ~TIM_CR1_CEN;
+#endif
+            return;
+        }
+
+        // Load new schedule if it ready
+        if (pending_schedule != NULL) {
+            active_schedule = pending_schedule;
+            pending_schedule = NULL;
+            schedule = active_schedule;
+        }
+
+        // Set HIGH level for PWM outputs without start offset
+        for (uint32_t i = 0; i < ports_count; ++i) {
+            ports_list[i]->BSRR = schedule->set_masks[i];
+        }
+
+        // Reset and enable PWM timer
+        edge_cursor = 0;
+        TIM17->CCR1 = (schedule->edges_count != 0) ? schedule->edges[0].ticks : PWM_CHANNEL_DISABLE_VALUE;
+        TIM17->CR1 |= TIM_CR1_CEN;
+#if PWM_DMA_WAVEFORM_ENABLE
+        start_waveform(schedule);
+#endif
+
+        ++synchro;
+
+        uint32_t cycles = DWT->CYCCNT - begin_cycles;
+        if (cycles > isr_period_max_cycles) {
+            isr_period_max_cycles = cycles;
+        }
+    }
+}
+#endif // PWM_EDGE_SCHEDULE_ENABLE
+
+
+
+
+
+
+//  ***************************************************************************
+/// @brief  Initialization used GPIO ports list
+/// @note   Ports are sorted by channels count, first PWM_DMA_PORTS_COUNT
+///         ports are processed by DMA if DMA waveform is enabled
+/// @param  none
+/// @return none
+//  ***************************************************************************
+static void init_ports_list(void) {
+
+    uint32_t channels_count[PWM_MAX_GPIO_PORTS_COUNT] = {0};
+    for (uint32_t i = 0; i < SUPPORT_PWM_CHANNELS_COUNT; ++i) {
+        uint32_t port_index = 0;
+        while (port_index < ports_count && ports_list[port_index] != channels_list[i].gpio_port) {
+            ++port_index;
+        }
+        if (port_index == ports_count) {
+            ports_list[ports_count++] = channels_list[i].gpio_port;
+        }
+        ++channels_count[port_index];
     }
+
+    // Sorting ports by channels count: insertion sorting method
+    for (uint32_t i = 1; i < ports_count; ++i) {
+        GPIO_TypeDef* gpio_port = ports_list[i];
+        uint32_t count = channels_count[i];
+        uint32_t j = i;
+        while (j > 0 && channels_count[j - 1] < count) {
+            ports_list[j] = ports_list[j - 1];
+            channels_count[j] = channels_count[j - 1];
+            --j;
+        }
+        ports_list[j] = gpio_port;
+        channels_count[j] = count;
+    }
+
+#if PWM_DMA_WAVEFORM_ENABLE
+    isr_first_port = (ports_count < PWM_DMA_PORTS_COUNT) ? ports_count : PWM_DMA_PORTS_COUNT;
+#endif
+}
+
+//  ***************************************************************************
+/// @brief  Get GPIO port index in used GPIO ports list
+/// @param  gpio_port: GPIO port
+/// @return port index
+//  ***************************************************************************
+static uint32_t get_port_index(GPIO_TypeDef* gpio_port) {
+
+    uint32_t port_index = 0;
+    while (ports_list[port_index] != gpio_port) {
+        ++port_index;
+    }
+    return port_index;
+}
+
+#if PWM_EDGE_SCHEDULE_ENABLE
+//  ***************************************************************************
+/// @brief  Build edge schedule from shadow buffer and pass it to ISR
+/// @note   Schedule is built in buffer which is not used by ISR. Pending
+///         schedule is reset before build, then ISR can not take buffer while
+///         it is building. Schedule is published by single pointer write
+/// @param  none
+/// @return none
+//  ***************************************************************************
+static void build_schedule(void) {
+
+    pending_schedule = NULL;
+    pwm_schedule_t* schedule = (active_schedule == &schedules[0]) ? &schedules[1] : &schedules[0];
+
+    // Collect edges of channels. Rising edges of channels without start
+    // offset are set on PWM period begin, disabled channels are not fall
+    memset(schedule, 0, sizeof(pwm_schedule_t));
+    pwm_event_t events[PWM_MAX_EDGES_COUNT];
+    uint32_t events_count = 0;
+    for (uint32_t i = 0; i < SUPPORT_PWM_CHANNELS_COUNT; ++i) {
+        const pwm_channel_t* channel = &shadow_buffer[i];
+        if (channel->start_offset == 0) {
+            schedule->set_masks[channel->port_index] |= (0x01 << channel->gpio_pin);
+        }
+        else {
+            events[events_count].ticks = channel->start_offset;
+            events[events_count].channel = i;
+            events[events_count].is_rising = true;
+            ++events_count;
+        }
+        if (channel->ticks != PWM_CHANNEL_DISABLE_VALUE) {
+            uint32_t ticks = channel->start_offset + channel->ticks;
+            events[events_count].ticks = (ticks < pwm_period_us) ? ticks : pwm_period_us - 1;
+            events[events_count].channel = i;
+            events[events_count].is_rising = false;
+            ++events_count;
+        }
+    }
+
+    // Sorting edges: insertion sorting method
+    for (uint32_t i = 1; i < events_count; ++i) {
+        pwm_event_t event = events[i];
+        uint32_t j = i;
+        while (j > 0 && events[j - 1].ticks > event.ticks) {
+            events[j] = events[j - 1];
+            --j;
+        }
+        events[j] = event;
+    }
+
+    // Merge edges with equal time to single edge
+    for (uint32_t i = 0; i < events_count; ++i) {
+        const pwm_channel_t* channel = &shadow_buffer[events[i].channel];
+        if (channel->port_index < isr_first_port) {
+            continue; // Channel is processed by DMA
+        }
+        if (schedule->edges_count == 0 || schedule->edges[schedule->edges_count - 1].ticks != events[i].ticks) {
+            schedule->edges[schedule->edges_count].ticks = events[i].ticks;
+            ++schedule->edges_count;
+        }
+        uint32_t pin_mask = (0x01 << channel->gpio_pin);
+        schedule->edges[schedule->edges_count - 1].bsrr_values[channel->port_index] |= events[i].is_rising ? pin_mask : (pin_mask << 16);
+    }
+#if PWM_DMA_WAVEFORM_ENABLE
+    build_waveform(schedule, events, events_count);
+#endif
+
+    __DMB(); // Schedule should be written before publish
+    pending_schedule = schedule;
+}
+#endif // PWM_EDGE_SCHEDULE_ENABLE
+
+#if PWM_DMA_WAVEFORM_ENABLE
+//  ***************************************************************************
+/// @brief  Build DMA waveform for DMA ports
+/// @note   Cycle 0 is begin of PWM period and has not edges, cycle N begins
+///         PWM_DMA_EDGE_OFFSET ticks before edge N - 1. TIM5 cycle can not be
+///         shorter 2 ticks, then edges closer 2 ticks are merged to previous
+///         edge and edges are not earlier PWM_DMA_MIN_EDGE_TICKS
+/// @param  schedule: schedule for build
+/// @param  events: channels edges sorted by time
+/// @param  events_count: edges count
+/// @return none
+//  ***************************************************************************
+static void build_waveform(pwm_schedule_t* schedule, const pwm_event_t* events, uint32_t events_count) {
+
+    uint32_t words_count = 1;
+    uint32_t cycle_begin = 0;
+    for (uint32_t i = 0; i < events_count; ++i) {
+
+        const pwm_channel_t* channel = &shadow_buffer[events[i].channel];
+        if (channel->port_index >= isr_first_port) {
+            continue; // Channel is processed by ISR
+        }
+
+        uint32_t ticks = (events[i].ticks < PWM_DMA_MIN_EDGE_TICKS) ? PWM_DMA_MIN_EDGE_TICKS : events[i].ticks;
+        if (ticks - PWM_DMA_EDGE_OFFSET - cycle_begin >= 2) {
+            schedule->dma_reload_list[words_count - 1] = ticks - PWM_DMA_EDGE_OFFSET - cycle_begin - 1;
+            cycle_begin = ticks - PWM_DMA_EDGE_OFFSET;
+            ++words_count;
+        }
+        uint32_t pin_mask = (0x01 << channel->gpio_pin);
+        schedule->dma_words_list[channel->port_index][words_count - 1] |= events[i].is_rising ? pin_mask : (pin_mask << 16);
+    }
+    schedule->dma_reload_list[words_count - 1] = pwm_period_us; // Last cycle is not finished in PWM period
+    schedule->dma_words_count = words_count;
+}
+
+//  ***************************************************************************
+/// @brief  Start DMA waveform for PWM period
+/// @note   Call from PWM timer ISR on begin of PWM period. Cycle 0 length is
+///         loaded directly, next cycles lengths are loaded by DMA to ARR
+///         preload register one cycle ahead
+/// @param  schedule: active schedule
+/// @return none
+//  ***************************************************************************
+static void start_waveform(const pwm_schedule_t* schedule) {
+
+    // Stop timer and reset DMA requests
+    TIM5->CR1 &= ~TIM_CR1_CEN;
+    TIM5->DIER = 0;
+
+    // Reload DMA streams
+    for (uint32_t i = 0; i < isr_first_port; ++i) {
+        dma_port_channels[i]->CCR  &= ~DMA_CCR_EN;
+        dma_port_channels[i]->CMAR  = (uint32_t)schedule->dma_words_list[i];
+        dma_port_channels[i]->CNDTR = schedule->dma_words_count;
+        dma_port_channels[i]->CCR  |= DMA_CCR_EN;
+    }
+    dma_reload_channel->CCR  &= ~DMA_CCR_EN;
+    dma_reload_channel->CMAR  = (uint32_t)&schedule->dma_reload_list[1];
+    dma_reload_channel->CNDTR = schedule->dma_words_count - 1;
+    if (schedule->dma_words_count > 1) {
+        dma_reload_channel->CCR |= DMA_CCR_EN;
+    }
+
+    // Load cycle 0 length, reset and enable timer
+    TIM5->ARR  = schedule->dma_reload_list[0];
+    TIM5->EGR  = TIM_EGR_UG;
+    TIM5->SR   = 0;
+    TIM5->DIER = TIM_DIER_CC1DE | TIM_DIER_CC2DE | TIM_DIER_CC3DE | TIM_DIER_CC4DE;
+    TIM5->CR1 |= TIM_CR1_CEN;
 }
+#endif // PWM_DMA_WAVEFORM_ENABLE
@@ -1,26 +1,53 @@
 //  ***************************************************************************
 /// @file    pwm.h
 /// @author  NeoProg
-/// @brief   Interface for 18-channel PWM driver
+/// @brief   Interface for multichannel PWM driver (channels by robot description)
 //  ***************************************************************************
 #ifndef _PWM_H_
 #define _PWM_H_
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "robot_config.h"
 
-#define SUPPORT_PWM_CHANNELS_COUNT                  (18)
+#define SUPPORT_PWM_CHANNELS_COUNT                  (ROBOT_SERVO_COUNT)
+#define PWM_FREQUENCY_HZ                            (270)   // Default PWM frequency. Motion time steps and rates are set for this motion clock
+#define PWM_MIN_FREQUENCY_HZ                        (50)    // PWM period is motion clock period, frequency is selected by servo types
+#define PWM_MAX_FREQUENCY_HZ                        (400)
+
+// Edge schedule: sorted PWM edges are built in main loop, ISR only walks table. 0 - legacy sorting in ISR
+// (pulse start offsets from robot description are not supported by legacy ISR)
+#ifndef PWM_EDGE_SCHEDULE_ENABLE
+#define PWM_EDGE_SCHEDULE_ENABLE                    (1)
+#endif
+#define PWM_MAX_GPIO_PORTS_COUNT                    (6)     // GPIOA - GPIOF
+
+// DMA waveform: BSRR words with rising and falling edges of GPIO ports with most channels are written
+// by DMA2 on TIM5 events, channels of other ports are processed by edge schedule ISR. Requires edge schedule
+#ifndef PWM_DMA_WAVEFORM_ENABLE
+#define PWM_DMA_WAVEFORM_ENABLE                     (0)
+#endif
+#define PWM_DMA_PORTS_COUNT                         (3)     // TIM5 CC1 - CC3 -> DMA2 channels 5, 4, 2
+                                                            // Hexapod: ports A, B, E by DMA (15 channels), C4, C5, D8 by ISR
+
+#if PWM_DMA_WAVEFORM_ENABLE && !PWM_EDGE_SCHEDULE_ENABLE
+#error "PWM DMA waveform requires PWM edge schedule"
+#endif
 
 
 // PWM period counter for synchronize
 extern uint64_t synchro;
 
 
+extern bool pwm_set_frequency(uint32_t frequency_hz, uint32_t max_width);
+extern uint32_t pwm_get_frequency(void);
 extern void pwm_init(void);
 extern void pwm_enable(void);
 extern void pwm_disable(void);
 extern void pwm_set_shadow_buffer_lock_state(bool is_locked);
-extern void pwm_set_width(uint32_t channel, uint32_t width);
+extern bool pwm_set_width(uint32_t channel, uint32_t width);
+extern void pwm_get_isr_statistic(uint32_t* edge_max_cycles, uint32_t* period_max_cycles);
+extern void pwm_reset_isr_statistic(void);
 
 
 #endif // _PWM_H_
@@ -38,6 +38,16 @@ uint64_t get_time_ms(void) {
     return systime_ms;
 }
 
+//  ***************************************************************************
+/// @brief  Get CPU cycles counter
+/// @note   DWT cycles counter is enabled by PWM driver initialization
+/// @param  none
+/// @return CPU cycles counter value
+//  ***************************************************************************
+uint32_t get_cpu_cycles(void) {
+    return DWT->CYCCNT;
+}
+
 //  ***************************************************************************
 /// @brief  Synchronous delay
 /// @param  ms: time delay [ms]
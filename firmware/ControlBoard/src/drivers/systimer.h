@@ -12,6 +12,7 @@
 extern void systimer_init(void);
 extern uint64_t get_time_ms(void);
 extern void delay_ms(uint32_t ms);
+extern uint32_t get_cpu_cycles(void);
 
 
 #endif // _SYSTIMER_H_
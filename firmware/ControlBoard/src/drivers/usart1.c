@@ -9,7 +9,7 @@
 #define USART_RX_PIN                    (10) // PA10
 
 
-static uint8_t  tx_buffer[3072] = {0};
+static uint8_t  tx_buffer[3584] = {0};
 static uint8_t  rx_buffer[512]  = {0};
 static uint8_t* tx_buffer_cursor = NULL;
 static uint32_t tx_bytes_count = 0;
@@ -0,0 +1,191 @@
+//  ***************************************************************************
+/// @file    gait_generator.c
+/// @author  NeoProg
+/// @note    Gait cycle is one motion (motion time [0; 1] is cycle phase). Leg 
+///          phase is (cycle phase + phase offset). Leg is on ground while leg 
+///          phase < duty factor and moves along arc from -0.5 to +0.5, after 
+///          that leg is in air and returns from +0.5 to -0.5 by sinus height.
+///          Phase offsets and support groups are taken from robot description
+//  ***************************************************************************
+#include "gait_generator.h"
+#include <stddef.h>
+#include <math.h>
+
+#define M_PI_F                              (3.14159265f)
+
+
+static const gait_params_t gait_params_list[SUPPORT_GAIT_COUNT] = {
+    
+    // Tripod: legs 0, 2, 4 and 1, 3, 5 swing by turns (hexapod)
+    { .phase_offsets = ROBOT_GAIT_TRIPOD_PHASE_OFFSETS, .duty_factor = ROBOT_GAIT_TRIPOD_DUTY_FACTOR, .step_height = LIMB_STEP_HEIGHT, .time_step = 5 },
+    
+    // Ripple: swings of one side are shifted by 1/3, sides are shifted by 1/2 (hexapod). Leg starts swing when (phase + offset) == duty factor
+    { .phase_offsets = ROBOT_GAIT_RIPPLE_PHASE_OFFSETS, .duty_factor = ROBOT_GAIT_RIPPLE_DUTY_FACTOR, .step_height = LIMB_STEP_HEIGHT, .time_step = 3 },
+    
+    // Wave: one leg in air, from rear to front - left side, after that right side (hexapod)
+    { .phase_offsets = ROBOT_GAIT_WAVE_PHASE_OFFSETS, .duty_factor = ROBOT_GAIT_WAVE_DUTY_FACTOR, .step_height = LIMB_STEP_HEIGHT, .time_step = 2 },
+};
+
+
+static bool calculate_arc_points(int32_t curvature, int32_t distance, const point_3d_t* neutral_positions, 
+                                 const float* arc_positions, point_3d_t* points);
+
+
+//  ***************************************************************************
+/// @brief  Get gait parameters
+/// @param  gait: gait type
+/// @return gait parameters or NULL if gait not support
+//  ***************************************************************************
+const gait_params_t* gait_generator_get_params(gait_type_t gait) {
+    if (gait >= SUPPORT_GAIT_COUNT) {
+        return NULL;
+    }
+    return &gait_params_list[gait];
+}
+
+//  ***************************************************************************
+/// @brief  Calculate leg state for cycle phase
+/// @param  params: gait parameters
+/// @param  leg: leg index
+/// @param  cycle_phase: gait cycle phase [0; 1]
+/// @param  arc_position: position on step arc [-0.5; +0.5]
+/// @param  height: step height [mm]
+/// @retval arc_position, height
+/// @return none
+//  ***************************************************************************
+void gait_generator_calculate_leg(const gait_params_t* params, uint32_t leg, float cycle_phase, float* arc_position, float* height) {
+    
+    float leg_phase = cycle_phase + params->phase_offsets[leg];
+    if (leg_phase >= 1.0f) {
+        leg_phase -= 1.0f;
+    }
+    
+    if (leg_phase < params->duty_factor) {
+        *arc_position = -0.5f + leg_phase / params->duty_factor;
+        *height = 0;
+    }
+    else {
+        float swing_phase = (leg_phase - params->duty_factor) / (1.0f - params->duty_factor);
+        *arc_position = 0.5f - swing_phase;
+        *height = params->step_height * sinf(swing_phase * M_PI_F);
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Build walk sequence motions
+/// @note   Prepare and finalize motions move legs between neutral positions
+///         and gait cycle start positions by two support groups (hexapod 
+///         tripods 0, 2, 4 and 1, 3, 5, see ROBOT_GAIT_SUPPORT_GROUP_MASK), 
+///         so robot always stands on one group at least. Other group
+///         holds current positions, so finalize motions can start from any 
+///         point of gait cycle (preemption)
+/// @param  gait: gait type
+/// @param  direction: walk direction
+/// @param  curvature: curvature (parameter of trajectory)
+/// @param  distance: step length (parameter of trajectory)
+/// @param  neutral_positions: limbs neutral positions
+/// @param  motion_list: motions list (GAIT_TOTAL_MOTIONS_COUNT items)
+/// @retval motion_list
+/// @return true - success, false - no
+//  ***************************************************************************
+bool gait_generator_build_sequence(gait_type_t gait, time_dir_t direction, int32_t curvature, int32_t distance,
+                                   const point_3d_t* neutral_positions, motion_config_t* motion_list) {
+    
+    const gait_params_t* params = gait_generator_get_params(gait);
+    if (params == NULL) {
+        return false;
+    }
+    
+    // Calculate cycle start positions
+    float arc_positions[SUPPORT_LIMBS_COUNT];
+    float heights[SUPPORT_LIMBS_COUNT];
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        gait_generator_calculate_leg(params, i, 0, &arc_positions[i], &heights[i]);
+        if (direction == TIME_DIR_REVERSE) {
+            arc_positions[i] = -arc_positions[i];
+        }
+    }
+    point_3d_t start_positions[SUPPORT_LIMBS_COUNT];
+    if (calculate_arc_points(curvature, distance, neutral_positions, arc_positions, start_positions) == false) {
+        return false;
+    }
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        start_positions[i].y += heights[i];
+    }
+    
+    // Prepare motions: move support groups to cycle start positions.
+    // Finalize motions: move support groups back to neutral positions
+    for (uint32_t k = 0; k < GAIT_PREPARE_MOTIONS_COUNT; ++k) {
+        motion_config_t* prepare = &motion_list[k];
+        motion_config_t* finalize = &motion_list[GAIT_PREPARE_MOTIONS_COUNT + GAIT_MAIN_MOTIONS_COUNT + k];
+        for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+            
+            uint32_t group = (ROBOT_GAIT_SUPPORT_GROUP_MASK & (1 << i)) ? 0 : 1;
+            bool is_moved_limb = group == k;
+            bool is_moved_before = group < k;
+            
+            prepare->dest_positions[i]   = (is_moved_limb || is_moved_before) ? start_positions[i] : neutral_positions[i];
+            prepare->trajectories[i]     = is_moved_limb ? TRAJECTORY_XYZ_LINEAR_LIFT : TRAJECTORY_XYZ_HOLD;
+            prepare->time_directions[i]  = TIME_DIR_DIRECT;
+            finalize->dest_positions[i]  = (is_moved_limb || is_moved_before) ? neutral_positions[i] : start_positions[i];
+            finalize->trajectories[i]    = is_moved_limb ? TRAJECTORY_XYZ_LINEAR_LIFT : TRAJECTORY_XYZ_HOLD;
+            finalize->time_directions[i] = TIME_DIR_DIRECT;
+        }
+        prepare->motion_time  = finalize->motion_time  = MTIME_MIN_VALUE;
+        prepare->time_stop    = finalize->time_stop    = MTIME_MAX_VALUE;
+        prepare->time_update  = finalize->time_update  = MTIME_NO_UPDATE;
+        prepare->time_step    = finalize->time_step    = 25;
+        prepare->is_need_init_start_position = finalize->is_need_init_start_position = true;
+    }
+    
+    // Main motion: one gait cycle
+    motion_config_t* main = &motion_list[GAIT_PREPARE_MOTIONS_COUNT];
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        main->dest_positions[i]  = neutral_positions[i]; // Not used for TRAJECTORY_XZ_ADV_Y_GAIT
+        main->start_positions[i] = neutral_positions[i];
+        main->trajectories[i]    = TRAJECTORY_XZ_ADV_Y_GAIT;
+        main->time_directions[i] = direction;
+    }
+    main->motion_time = MTIME_MIN_VALUE;
+    main->time_stop   = MTIME_MAX_VALUE;
+    main->time_update = MTIME_MID_VALUE;
+    main->time_step   = params->time_step;
+    main->is_need_init_start_position = false;
+    return true;
+}
+
+
+
+
+
+//  ***************************************************************************
+/// @brief  Calculate points on step arcs
+/// @note   Same geometry as advanced trajectory of motion core
+/// @param  curvature: curvature (parameter of trajectory)
+/// @param  distance: step length (parameter of trajectory)
+/// @param  neutral_positions: limbs neutral positions (arc centers)
+/// @param  arc_positions: positions on arcs [-0.5; +0.5]
+/// @param  points: points
+/// @retval points
+/// @return true - success, false - no
+//  ***************************************************************************
+static bool calculate_arc_points(int32_t curvature, int32_t distance, const point_3d_t* neutral_positions, 
+                                 const float* arc_positions, point_3d_t* points) {
+    
+    float curvature_radius = 0;
+    float trajectory_radius[SUPPORT_LIMBS_COUNT];
+    float start_angle_rad[SUPPORT_LIMBS_COUNT];
+    float max_arc_angle = 0;
+    if (motion_core_calculate_arc_geometry(neutral_positions, curvature, distance, 
+                                           &curvature_radius, trajectory_radius, start_angle_rad, &max_arc_angle) == false) {
+        return false;
+    }
+    
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        float arc_angle_rad = arc_positions[i] * max_arc_angle + start_angle_rad[i];
+        points[i].x = curvature_radius + trajectory_radius[i] * cosf(arc_angle_rad);
+        points[i].y = neutral_positions[i].y;
+        points[i].z =                    trajectory_radius[i] * sinf(arc_angle_rad);
+    }
+    return true;
+}
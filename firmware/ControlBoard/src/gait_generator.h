@@ -0,0 +1,41 @@
+//  ***************************************************************************
+/// @file    gait_generator.h
+/// @author  NeoProg
+/// @brief   Parametric gait generator (tripod, ripple, wave)
+/// @note    Host compilable (no hardware dependencies)
+//  ***************************************************************************
+#ifndef _GAIT_GENERATOR_H_
+#define _GAIT_GENERATOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "motion_core.h"
+
+#define GAIT_PREPARE_MOTIONS_COUNT          (2)
+#define GAIT_MAIN_MOTIONS_COUNT             (1)
+#define GAIT_FINALIZE_MOTIONS_COUNT         (2)
+#define GAIT_TOTAL_MOTIONS_COUNT            (GAIT_PREPARE_MOTIONS_COUNT + GAIT_MAIN_MOTIONS_COUNT + GAIT_FINALIZE_MOTIONS_COUNT)
+
+
+typedef enum {
+    GAIT_TRIPOD,                    // 3 legs on ground, fast
+    GAIT_RIPPLE,                    // 4 legs on ground
+    GAIT_WAVE,                      // 5 legs on ground, most stable
+    SUPPORT_GAIT_COUNT
+} gait_type_t;
+
+typedef struct gait_params_s {
+    float   phase_offsets[SUPPORT_LIMBS_COUNT];     // Leg phase offset in gait cycle [0; 1)
+    float   duty_factor;                            // Stance part of gait cycle (0; 1)
+    float   step_height;                            // [mm]
+    int32_t time_step;                              // Motion time step for one gait cycle
+} gait_params_t;
+
+
+extern const gait_params_t* gait_generator_get_params(gait_type_t gait);
+extern void gait_generator_calculate_leg(const gait_params_t* params, uint32_t leg, float cycle_phase, float* arc_position, float* height);
+extern bool gait_generator_build_sequence(gait_type_t gait, time_dir_t direction, int32_t curvature, int32_t distance,
+                                          const point_3d_t* neutral_positions, motion_config_t* motion_list);
+
+
+#endif // _GAIT_GENERATOR_H_
@@ -2,16 +2,21 @@
 /// @file    gait_sequences.h
 /// @author  NeoProg
 /// @brief   Gait sequences
+/// @note    Source tables of sequences. Firmware uses packed tables from 
+///          gait_sequences_packed.h, regenerate them by host/sequence_packer.c
+///          after change
 //  ***************************************************************************
 #ifndef GAIT_SEQUENCES_H_
 #define GAIT_SEQUENCES_H_
 
 #include "motion_core.h"
 
-
 #define LIMB_UP_Y                       (LIMB_DOWN_Y + LIMB_STEP_HEIGHT)
 #define LIMB_DOWN_Y                     (-85)
 
+// Posture changes (up, down) use joint space trajectories: foot path shape 
+// is not important for them, IK is solved on motion start only
+
 
 typedef struct {
     bool     is_sequence_looped;
@@ -22,6 +27,11 @@ typedef struct {
 } sequence_info_t;
 
 
+// Static sequences tables are written for limbs layout of robot. Quadruped has
+// posture sequences only, other sequences are uploaded (walk sequences are 
+// built by gait generator)
+#if ROBOT_LIMBS_COUNT == 6
+
 static const sequence_info_t sequence_down = {  
     .is_sequence_looped     = false,
     .main_motions_begin     = 0,
@@ -31,7 +41,7 @@ static const sequence_info_t sequence_down = {
     {
         {
             {{-140, -25, 83}, {-162, -25, 0}, {-140, -25, -83}, {140, -25, 83}, {162, -25, 0}, {140, -25, -83}},
-            { TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR},
+            { TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR},
             { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
             .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 5, .is_need_init_start_position = true
         }
@@ -47,161 +57,40 @@ static const sequence_info_t sequence_up = {
     {
         {
             {{-115, LIMB_DOWN_Y, 70}, {-135, LIMB_DOWN_Y, 0}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_DOWN_Y, -70}},
-            { TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR},
+            { TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR},
             { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
             .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 20, .is_need_init_start_position = true
         },
         {    // Up 0, 2, 4 legs
             {{-115, LIMB_UP_Y, 70}, {-135, LIMB_DOWN_Y, 0}, {-115, LIMB_UP_Y, -70}, {115, LIMB_DOWN_Y, 70}, {135, LIMB_UP_Y, 0}, {115, LIMB_DOWN_Y, -70}}, 
-            { TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR},
+            { TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR},
             { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
             .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 20, .is_need_init_start_position = true
         },
         {    // Down 0, 2, 4 legs
             {{-115, LIMB_DOWN_Y, 70}, {-135, LIMB_DOWN_Y, 0}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_DOWN_Y, -70}},
-            { TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR},
+            { TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR},
             { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
             .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 20, .is_need_init_start_position = true
         },
         {    // Up 1, 3, 5 legs
             {{-115, LIMB_DOWN_Y, 70}, {-135, LIMB_UP_Y, 0}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_UP_Y, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_UP_Y, -70}}, 
-            { TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR},
+            { TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR},
             { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
             .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 20, .is_need_init_start_position = true
         },
         {   // Down 0, 2, 4 legs
             {{-115, LIMB_DOWN_Y, 70}, {-135, LIMB_DOWN_Y, 0}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_DOWN_Y, -70}}, 
-            { TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR},
+            { TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR},
             { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
             .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 20, .is_need_init_start_position = true
         },
     }
 };
 
-static const sequence_info_t sequence_direct = {
-    .is_sequence_looped     = true,
-    .main_motions_begin     = 2,
-    .finalize_motions_begin = 4,
-    .total_motions_count    = 6,
-     
-    {
-        //
-        // Prepare sequence
-        //
-        {
-            {{-115, LIMB_DOWN_Y, 70}, {-135, LIMB_UP_Y, 0}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_UP_Y, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_UP_Y, -70}},
-            { TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR},
-            { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
-            {0}, // Start points initialize after motion start
-            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 25, .is_need_init_start_position = true
-        },
-        {
-            {0}, // Destination points is not use for TRAJECTORY_XZ_ADV_Y_CONST
-            { TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS},
-            { TIME_DIR_DIRECT, TIME_DIR_REVERSE, TIME_DIR_DIRECT, TIME_DIR_REVERSE, TIME_DIR_DIRECT, TIME_DIR_REVERSE },
-            {{-115, LIMB_DOWN_Y, 70}, {-135, LIMB_DOWN_Y, 0}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_DOWN_Y, -70}},
-            .motion_time = MTIME_MID_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 10, .is_need_init_start_position = false
-        },
-        
-        //
-        // Main sequence
-        //
-        {
-            {0}, // Destination points is not use for TRAJECTORY_XZ_ADV_Y_CONST
-            { TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST},
-            { TIME_DIR_REVERSE, TIME_DIR_DIRECT, TIME_DIR_REVERSE, TIME_DIR_DIRECT, TIME_DIR_REVERSE, TIME_DIR_DIRECT },
-            {{-115, LIMB_DOWN_Y, 70}, {-135, LIMB_DOWN_Y, 0}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_DOWN_Y, -70}},
-            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_MID_VALUE, .time_step = 10, .is_need_init_start_position = false
-        },
-        {
-            {0}, // Destination points is not use for TRAJECTORY_XZ_ADV_Y_CONST
-            { TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS},
-            { TIME_DIR_DIRECT, TIME_DIR_REVERSE, TIME_DIR_DIRECT, TIME_DIR_REVERSE, TIME_DIR_DIRECT, TIME_DIR_REVERSE },
-            {{-115, LIMB_DOWN_Y, 70}, {-135, LIMB_DOWN_Y, 0}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_DOWN_Y, -70}},
-            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_MID_VALUE, .time_step = 10, .is_need_init_start_position = false
-        },
-        
-        //
-        // Finalize sequence
-        //
-        {
-            {0}, // Destination points is not use for TRAJECTORY_XZ_ADV_Y_CONST
-            { TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST},
-            { TIME_DIR_REVERSE, TIME_DIR_DIRECT, TIME_DIR_REVERSE, TIME_DIR_DIRECT, TIME_DIR_REVERSE, TIME_DIR_DIRECT },
-            {{-115, LIMB_DOWN_Y, 70}, {-135, LIMB_DOWN_Y, 0}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_DOWN_Y, -70}},
-            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MID_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 10, .is_need_init_start_position = false
-        },
-        {
-            {{-115, LIMB_DOWN_Y, 70}, {-135, LIMB_DOWN_Y, 0}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_DOWN_Y, -70}},
-            { TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR},
-            { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
-            {0}, // Start points initialize after motion start
-            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 25, .is_need_init_start_position = true
-        },
-    }
-};
-
-static const sequence_info_t sequence_reverse = {
-    .is_sequence_looped     = true,
-    .main_motions_begin     = 2,
-    .finalize_motions_begin = 4,
-    .total_motions_count    = 6,
-     
-    {
-        //
-        // Prepare sequence
-        //
-        {
-            {{-115, LIMB_DOWN_Y, 70}, {-135, LIMB_UP_Y, 0}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_UP_Y, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_UP_Y, -70}},
-            { TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR},
-            { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
-            {0}, // Start points initialize after motion start
-            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 25, .is_need_init_start_position = true
-        },
-        {
-            {0}, // Destination points is not use for TRAJECTORY_XZ_ADV_Y_CONST
-            { TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS},
-            { TIME_DIR_REVERSE, TIME_DIR_DIRECT, TIME_DIR_REVERSE, TIME_DIR_DIRECT, TIME_DIR_REVERSE, TIME_DIR_DIRECT },
-            {{-115, LIMB_DOWN_Y, 70}, {-135, LIMB_DOWN_Y, 0}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_DOWN_Y, -70}},
-            .motion_time = MTIME_MID_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 10, .is_need_init_start_position = false
-        },
-        
-        //
-        // Main sequence
-        //
-        {
-            {0}, // Destination points is not use for TRAJECTORY_XZ_ADV_Y_CONST
-            { TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST},
-            { TIME_DIR_DIRECT, TIME_DIR_REVERSE, TIME_DIR_DIRECT, TIME_DIR_REVERSE, TIME_DIR_DIRECT, TIME_DIR_REVERSE },
-            {{-115, LIMB_DOWN_Y, 70}, {-135, LIMB_DOWN_Y, 0}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_DOWN_Y, -70}},
-            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_MID_VALUE, .time_step = 10, .is_need_init_start_position = false
-        },
-        {
-            {0}, // Destination points is not use for TRAJECTORY_XZ_ADV_Y_CONST
-            { TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS},
-            { TIME_DIR_REVERSE, TIME_DIR_DIRECT, TIME_DIR_REVERSE, TIME_DIR_DIRECT, TIME_DIR_REVERSE, TIME_DIR_DIRECT },
-            {{-115, LIMB_DOWN_Y, 70}, {-135, LIMB_DOWN_Y, 0}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_DOWN_Y, -70}},
-            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_MID_VALUE, .time_step = 10, .is_need_init_start_position = false
-        },
-        
-        //
-        // Finalize sequence
-        //
-        {
-            {0}, // Destination points is not use for TRAJECTORY_XZ_ADV_Y_CONST
-            { TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST, TRAJECTORY_XZ_ADV_Y_SINUS, TRAJECTORY_XZ_ADV_Y_CONST},
-            { TIME_DIR_DIRECT, TIME_DIR_REVERSE, TIME_DIR_DIRECT, TIME_DIR_REVERSE, TIME_DIR_DIRECT, TIME_DIR_REVERSE },
-            {{-115, LIMB_DOWN_Y, 70}, {-135, LIMB_DOWN_Y, 0}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_DOWN_Y, -70}},
-            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MID_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 10, .is_need_init_start_position = false
-        },
-        {
-            {{-115, LIMB_DOWN_Y, 70}, {-135, LIMB_DOWN_Y, 0}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_DOWN_Y, -70}},
-            { TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR},
-            { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
-            {0}, // Start points initialize after motion start
-            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 25, .is_need_init_start_position = true
-        },
-    }
+// Walk sequences (direct and reverse) are produced by gait generator. Neutral limbs positions for walk
+static const point_3d_t sequence_walk_neutral_positions[SUPPORT_LIMBS_COUNT] = {
+    {-115, LIMB_DOWN_Y, 70}, {-135, LIMB_DOWN_Y, 0}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_DOWN_Y, -70}
 };
 
 #define SEQ_LIMB_UP_Y                   (LIMB_DOWN_Y - 70)
@@ -444,13 +333,13 @@ static const sequence_info_t sequence_rotate_x = {
         //
         {
             {{-115, LIMB_DOWN_Y + LIMB_Y_OFFSET, 70}, {-135, LIMB_DOWN_Y, 0}, {-115, LIMB_DOWN_Y - LIMB_Y_OFFSET, -70}, {115, LIMB_DOWN_Y + LIMB_Y_OFFSET, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_DOWN_Y - LIMB_Y_OFFSET, -70}},
-            { TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR},
+            { TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK},
             { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
             .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 5, .is_need_init_start_position = true
         },
         {
             {{-115, LIMB_DOWN_Y - LIMB_Y_OFFSET, 70}, {-135, LIMB_DOWN_Y, 0}, {-115, LIMB_DOWN_Y + LIMB_Y_OFFSET, -70}, {115, LIMB_DOWN_Y - LIMB_Y_OFFSET, 70}, {135, LIMB_DOWN_Y, 0}, {115, LIMB_DOWN_Y + LIMB_Y_OFFSET, -70}},
-            { TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR},
+            { TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK},
             { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
             .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 5, .is_need_init_start_position = true
         },
@@ -481,13 +370,13 @@ static const sequence_info_t sequence_rotate_z = {
         //
         {
             {{-115, LIMB_DOWN_Y + LIMB_Y_OFFSET, 70}, {-135, LIMB_DOWN_Y + LIMB_Y_OFFSET, 0}, {-115, LIMB_DOWN_Y + LIMB_Y_OFFSET, -70}, {115, LIMB_DOWN_Y - LIMB_Y_OFFSET, 70}, {135, LIMB_DOWN_Y - LIMB_Y_OFFSET, 0}, {115, LIMB_DOWN_Y - LIMB_Y_OFFSET, -70}},
-            { TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR},
+            { TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK},
             { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
             .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 5, .is_need_init_start_position = true
         },
         {
             {{-115, LIMB_DOWN_Y - LIMB_Y_OFFSET, 70}, {-135, LIMB_DOWN_Y - LIMB_Y_OFFSET, 0}, {-115, LIMB_DOWN_Y - LIMB_Y_OFFSET, -70}, {115, LIMB_DOWN_Y + LIMB_Y_OFFSET, 70}, {135, LIMB_DOWN_Y + LIMB_Y_OFFSET, 0}, {115, LIMB_DOWN_Y + LIMB_Y_OFFSET, -70}},
-            { TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR, TRAJECTORY_XYZ_LINEAR},
+            { TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK, TRAJECTORY_XYZ_MIN_JERK},
             { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
             .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 5, .is_need_init_start_position = true
         },
@@ -506,5 +395,97 @@ static const sequence_info_t sequence_rotate_z = {
 };
 #undef LIMB_Y_OFFSET
 
+#elif ROBOT_LIMBS_COUNT == 4
+
+static const sequence_info_t sequence_down = {  
+    .is_sequence_looped     = false,
+    .main_motions_begin     = 0,
+    .finalize_motions_begin = 1,
+    .total_motions_count    = 1,
+    
+    {
+        {
+            {{-140, -25, 83}, {-140, -25, -83}, {140, -25, 83}, {140, -25, -83}},
+            { TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR },
+            { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
+            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 5, .is_need_init_start_position = true
+        }
+    }
+};
+
+// Legs are placed one by one, other three legs keep support
+static const sequence_info_t sequence_up = {
+    .is_sequence_looped     = false,
+    .main_motions_begin     = 0,
+    .finalize_motions_begin = 9,
+    .total_motions_count    = 9,
+     
+    {
+        {
+            {{-115, LIMB_DOWN_Y, 70}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {115, LIMB_DOWN_Y, -70}},
+            { TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR },
+            { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
+            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 20, .is_need_init_start_position = true
+        },
+        {    // Up 0 leg
+            {{-115, LIMB_UP_Y, 70}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {115, LIMB_DOWN_Y, -70}},
+            { TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR },
+            { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
+            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 20, .is_need_init_start_position = true
+        },
+        {    // Down 0 leg
+            {{-115, LIMB_DOWN_Y, 70}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {115, LIMB_DOWN_Y, -70}},
+            { TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR },
+            { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
+            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 20, .is_need_init_start_position = true
+        },
+        {    // Up 3 leg
+            {{-115, LIMB_DOWN_Y, 70}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {115, LIMB_UP_Y, -70}},
+            { TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR },
+            { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
+            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 20, .is_need_init_start_position = true
+        },
+        {    // Down 3 leg
+            {{-115, LIMB_DOWN_Y, 70}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {115, LIMB_DOWN_Y, -70}},
+            { TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR },
+            { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
+            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 20, .is_need_init_start_position = true
+        },
+        {    // Up 1 leg
+            {{-115, LIMB_DOWN_Y, 70}, {-115, LIMB_UP_Y, -70}, {115, LIMB_DOWN_Y, 70}, {115, LIMB_DOWN_Y, -70}},
+            { TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR },
+            { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
+            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 20, .is_need_init_start_position = true
+        },
+        {    // Down 1 leg
+            {{-115, LIMB_DOWN_Y, 70}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {115, LIMB_DOWN_Y, -70}},
+            { TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR },
+            { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
+            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 20, .is_need_init_start_position = true
+        },
+        {    // Up 2 leg
+            {{-115, LIMB_DOWN_Y, 70}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_UP_Y, 70}, {115, LIMB_DOWN_Y, -70}},
+            { TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR },
+            { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
+            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 20, .is_need_init_start_position = true
+        },
+        {    // Down 2 leg
+            {{-115, LIMB_DOWN_Y, 70}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {115, LIMB_DOWN_Y, -70}},
+            { TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR, TRAJECTORY_JOINT_LINEAR },
+            { TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT, TIME_DIR_DIRECT },
+            .motion_time = MTIME_MIN_VALUE, .time_stop = MTIME_MAX_VALUE, .time_update = MTIME_NO_UPDATE, .time_step = 20, .is_need_init_start_position = true
+        }
+    }
+};
+
+// Walk sequences (direct and reverse) are produced by gait generator. Neutral limbs positions for walk
+static const point_3d_t sequence_walk_neutral_positions[SUPPORT_LIMBS_COUNT] = {
+    {-115, LIMB_DOWN_Y, 70}, {-115, LIMB_DOWN_Y, -70}, {115, LIMB_DOWN_Y, 70}, {115, LIMB_DOWN_Y, -70}
+};
+
+#else
+#error "Sequences tables are not written for this robot"
+#endif
+
 
 #endif /* GAIT_SEQUENCES_H_ */
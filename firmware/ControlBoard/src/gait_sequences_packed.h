@@ -0,0 +1,248 @@
+//  ***************************************************************************
+/// @file    gait_sequences_packed.h
+/// @author  NeoProg
+/// @brief   Packed gait sequences
+/// @note    Generated by host/sequence_packer.c from gait_sequences.h, do not edit
+//  ***************************************************************************
+#ifndef GAIT_SEQUENCES_PACKED_H_
+#define GAIT_SEQUENCES_PACKED_H_
+
+#include "sequence_codec.h"
+
+#if ROBOT_LIMBS_COUNT != 6
+#error "Sequences tables are written for hexapod"
+#endif
+
+
+static const point_3d_t sequence_walk_neutral_positions[SUPPORT_LIMBS_COUNT] = {
+    {-115, -85, 70}, {-135, -85, 0}, {-115, -85, -70}, {115, -85, 70}, {135, -85, 0}, {115, -85, -70}
+};
+
+static const packed_motion_t sequence_down_motions[1] = {
+    {
+        .dest_positions = {{-140, -25, 83}, {-162, -25, 0}, {-140, -25, -83}, {140, -25, 83}, {162, -25, 0}, {140, -25, -83}},
+        .limbs_modes = 0x90842108, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 5
+    },
+};
+static const packed_sequence_t sequence_down = {
+    .is_sequence_looped     = false,
+    .main_motions_begin     = 0,
+    .finalize_motions_begin = 1,
+    .total_motions_count    = 1,
+    .motion_list            = sequence_down_motions
+};
+
+static const packed_motion_t sequence_up_motions[5] = {
+    {
+        .dest_positions = {{-115, -85, 70}, {-135, -85, 0}, {-115, -85, -70}, {115, -85, 70}, {135, -85, 0}, {115, -85, -70}},
+        .limbs_modes = 0x90842108, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 20
+    },
+    {
+        .dest_positions = {{-115, -55, 70}, {-135, -85, 0}, {-115, -55, -70}, {115, -85, 70}, {135, -55, 0}, {115, -85, -70}},
+        .limbs_modes = 0x90842108, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 20
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-135, -85, 0}, {-115, -85, -70}, {115, -85, 70}, {135, -85, 0}, {115, -85, -70}},
+        .limbs_modes = 0x90842108, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 20
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-135, -55, 0}, {-115, -85, -70}, {115, -55, 70}, {135, -85, 0}, {115, -55, -70}},
+        .limbs_modes = 0x90842108, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 20
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-135, -85, 0}, {-115, -85, -70}, {115, -85, 70}, {135, -85, 0}, {115, -85, -70}},
+        .limbs_modes = 0x90842108, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 20
+    },
+};
+static const packed_sequence_t sequence_up = {
+    .is_sequence_looped     = false,
+    .main_motions_begin     = 0,
+    .finalize_motions_begin = 5,
+    .total_motions_count    = 5,
+    .motion_list            = sequence_up_motions
+};
+
+static const packed_motion_t sequence_up_down_motions[2] = {
+    {
+        .dest_positions = {{-115, -155, 70}, {-135, -155, 0}, {-115, -155, -70}, {115, -155, 70}, {135, -155, 0}, {115, -155, -70}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 5
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-135, -85, 0}, {-115, -85, -70}, {115, -85, 70}, {135, -85, 0}, {115, -85, -70}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 5
+    },
+};
+static const packed_sequence_t sequence_up_down = {
+    .is_sequence_looped     = true,
+    .main_motions_begin     = 0,
+    .finalize_motions_begin = 2,
+    .total_motions_count    = 2,
+    .motion_list            = sequence_up_down_motions
+};
+
+static const packed_motion_t sequence_push_pull_motions[4] = {
+    {
+        .dest_positions = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
+        .limbs_modes = 0x02108421, .motion_time = 500, .time_stop = 1000, .time_update = 2000, .time_step = 5
+    },
+    {
+        .dest_positions = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
+        .limbs_modes = 0x2318C631, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 5
+    },
+    {
+        .dest_positions = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
+        .limbs_modes = 0x02108421, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 5
+    },
+    {
+        .dest_positions = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
+        .limbs_modes = 0x2318C631, .motion_time = 0, .time_stop = 500, .time_update = 2000, .time_step = 5
+    },
+};
+static const packed_sequence_t sequence_push_pull = {
+    .is_sequence_looped     = true,
+    .main_motions_begin     = 1,
+    .finalize_motions_begin = 3,
+    .total_motions_count    = 4,
+    .motion_list            = sequence_push_pull_motions
+};
+
+static const packed_motion_t sequence_attack_left_motions[4] = {
+    {
+        .dest_positions = {{0, 0, 150}, {-135, -85, 0}, {-115, -85, -70}, {115, -85, 70}, {135, -85, 0}, {115, -85, -70}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 10
+    },
+    {
+        .dest_positions = {{0, 0, 250}, {-135, -85, 0}, {-115, -85, -70}, {115, -85, 70}, {135, -85, 0}, {115, -85, -70}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 10
+    },
+    {
+        .dest_positions = {{0, 0, 150}, {-135, -85, 0}, {-115, -85, -70}, {115, -85, 70}, {135, -85, 0}, {115, -85, -70}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 10
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-135, -85, 0}, {-115, -85, -70}, {115, -85, 70}, {135, -85, 0}, {115, -85, -70}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 10
+    },
+};
+static const packed_sequence_t sequence_attack_left = {
+    .is_sequence_looped     = true,
+    .main_motions_begin     = 1,
+    .finalize_motions_begin = 3,
+    .total_motions_count    = 4,
+    .motion_list            = sequence_attack_left_motions
+};
+
+static const packed_motion_t sequence_attack_right_motions[4] = {
+    {
+        .dest_positions = {{-115, -85, 70}, {-135, -85, 0}, {-115, -85, -70}, {0, 0, 150}, {135, -85, 0}, {115, -85, -70}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 10
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-135, -85, 0}, {-115, -85, -70}, {0, 0, 250}, {135, -85, 0}, {115, -85, -70}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 10
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-135, -85, 0}, {-115, -85, -70}, {0, 0, 150}, {135, -85, 0}, {115, -85, -70}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 10
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-135, -85, 0}, {-115, -85, -70}, {115, -85, 70}, {135, -85, 0}, {115, -85, -70}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 10
+    },
+};
+static const packed_sequence_t sequence_attack_right = {
+    .is_sequence_looped     = true,
+    .main_motions_begin     = 1,
+    .finalize_motions_begin = 3,
+    .total_motions_count    = 4,
+    .motion_list            = sequence_attack_right_motions
+};
+
+static const packed_motion_t sequence_dance_motions[8] = {
+    {
+        .dest_positions = {{-115, -55, 70}, {-135, -85, 0}, {-115, -55, -70}, {115, -85, 70}, {135, -55, 0}, {115, -85, -70}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 20
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-135, -85, 0}, {-115, -85, -70}, {115, -85, 70}, {135, -85, 0}, {115, -85, -70}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 20
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-135, -55, 0}, {-115, -85, -70}, {115, -55, 70}, {135, -85, 0}, {115, -55, -70}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 20
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-135, -85, 0}, {-115, -85, -70}, {115, -85, 70}, {135, -85, 0}, {115, -85, -70}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 20
+    },
+    {
+        .dest_positions = {{-170, 50, 170}, {-130, -85, 0}, {-170, 50, -170}, {110, -85, 65}, {240, 50, 0}, {110, -85, -65}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 10
+    },
+    {
+        .dest_positions = {{-110, -85, 65}, {-130, -85, 0}, {-110, -85, -65}, {110, -85, 65}, {130, -85, 0}, {110, -85, -65}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 10
+    },
+    {
+        .dest_positions = {{-110, -85, 65}, {-240, 50, 0}, {-110, -85, -65}, {170, 50, 170}, {130, -85, 0}, {170, 50, -170}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 10
+    },
+    {
+        .dest_positions = {{-110, -85, 65}, {-130, -85, 0}, {-110, -85, -65}, {110, -85, 65}, {130, -85, 0}, {110, -85, -65}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 10
+    },
+};
+static const packed_sequence_t sequence_dance = {
+    .is_sequence_looped     = true,
+    .main_motions_begin     = 0,
+    .finalize_motions_begin = 8,
+    .total_motions_count    = 8,
+    .motion_list            = sequence_dance_motions
+};
+
+static const packed_motion_t sequence_rotate_x_motions[3] = {
+    {
+        .dest_positions = {{-115, -65, 70}, {-135, -85, 0}, {-115, -105, -70}, {115, -65, 70}, {135, -85, 0}, {115, -105, -70}},
+        .limbs_modes = 0x8E739CE7, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 5
+    },
+    {
+        .dest_positions = {{-115, -105, 70}, {-135, -85, 0}, {-115, -65, -70}, {115, -105, 70}, {135, -85, 0}, {115, -65, -70}},
+        .limbs_modes = 0x8E739CE7, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 5
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-135, -85, 0}, {-115, -85, -70}, {115, -85, 70}, {135, -85, 0}, {115, -85, -70}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 10
+    },
+};
+static const packed_sequence_t sequence_rotate_x = {
+    .is_sequence_looped     = true,
+    .main_motions_begin     = 0,
+    .finalize_motions_begin = 2,
+    .total_motions_count    = 3,
+    .motion_list            = sequence_rotate_x_motions
+};
+
+static const packed_motion_t sequence_rotate_z_motions[3] = {
+    {
+        .dest_positions = {{-115, -65, 70}, {-135, -65, 0}, {-115, -65, -70}, {115, -105, 70}, {135, -105, 0}, {115, -105, -70}},
+        .limbs_modes = 0x8E739CE7, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 5
+    },
+    {
+        .dest_positions = {{-115, -105, 70}, {-135, -105, 0}, {-115, -105, -70}, {115, -65, 70}, {135, -65, 0}, {115, -65, -70}},
+        .limbs_modes = 0x8E739CE7, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 5
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-135, -85, 0}, {-115, -85, -70}, {115, -85, 70}, {135, -85, 0}, {115, -85, -70}},
+        .limbs_modes = 0x80000000, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 10
+    },
+};
+static const packed_sequence_t sequence_rotate_z = {
+    .is_sequence_looped     = true,
+    .main_motions_begin     = 0,
+    .finalize_motions_begin = 2,
+    .total_motions_count    = 3,
+    .motion_list            = sequence_rotate_z_motions
+};
+
+
+#endif /* GAIT_SEQUENCES_PACKED_H_ */
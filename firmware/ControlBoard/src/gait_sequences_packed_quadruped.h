@@ -0,0 +1,82 @@
+//  ***************************************************************************
+/// @file    gait_sequences_packed_quadruped.h
+/// @author  NeoProg
+/// @brief   Packed gait sequences
+/// @note    Generated by host/sequence_packer.c from gait_sequences.h, do not edit
+//  ***************************************************************************
+#ifndef GAIT_SEQUENCES_PACKED_QUADRUPED_H_
+#define GAIT_SEQUENCES_PACKED_QUADRUPED_H_
+
+#include "sequence_codec.h"
+
+#if ROBOT_LIMBS_COUNT != 4
+#error "Sequences tables are written for quadruped"
+#endif
+
+
+static const point_3d_t sequence_walk_neutral_positions[SUPPORT_LIMBS_COUNT] = {
+    {-115, -85, 70}, {-115, -85, -70}, {115, -85, 70}, {115, -85, -70}
+};
+
+static const packed_motion_t sequence_down_motions[1] = {
+    {
+        .dest_positions = {{-140, -25, 83}, {-140, -25, -83}, {140, -25, 83}, {140, -25, -83}},
+        .limbs_modes = 0x80042108, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 5
+    },
+};
+static const packed_sequence_t sequence_down = {
+    .is_sequence_looped     = false,
+    .main_motions_begin     = 0,
+    .finalize_motions_begin = 1,
+    .total_motions_count    = 1,
+    .motion_list            = sequence_down_motions
+};
+
+static const packed_motion_t sequence_up_motions[9] = {
+    {
+        .dest_positions = {{-115, -85, 70}, {-115, -85, -70}, {115, -85, 70}, {115, -85, -70}},
+        .limbs_modes = 0x80042108, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 20
+    },
+    {
+        .dest_positions = {{-115, -55, 70}, {-115, -85, -70}, {115, -85, 70}, {115, -85, -70}},
+        .limbs_modes = 0x80042108, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 20
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-115, -85, -70}, {115, -85, 70}, {115, -85, -70}},
+        .limbs_modes = 0x80042108, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 20
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-115, -85, -70}, {115, -85, 70}, {115, -55, -70}},
+        .limbs_modes = 0x80042108, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 20
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-115, -85, -70}, {115, -85, 70}, {115, -85, -70}},
+        .limbs_modes = 0x80042108, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 20
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-115, -55, -70}, {115, -85, 70}, {115, -85, -70}},
+        .limbs_modes = 0x80042108, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 20
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-115, -85, -70}, {115, -85, 70}, {115, -85, -70}},
+        .limbs_modes = 0x80042108, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 20
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-115, -85, -70}, {115, -55, 70}, {115, -85, -70}},
+        .limbs_modes = 0x80042108, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 20
+    },
+    {
+        .dest_positions = {{-115, -85, 70}, {-115, -85, -70}, {115, -85, 70}, {115, -85, -70}},
+        .limbs_modes = 0x80042108, .motion_time = 0, .time_stop = 1000, .time_update = 2000, .time_step = 20
+    },
+};
+static const packed_sequence_t sequence_up = {
+    .is_sequence_looped     = false,
+    .main_motions_begin     = 0,
+    .finalize_motions_begin = 9,
+    .total_motions_count    = 9,
+    .motion_list            = sequence_up_motions
+};
+
+
+#endif /* GAIT_SEQUENCES_PACKED_QUADRUPED_H_ */
@@ -0,0 +1,270 @@
+//  ***************************************************************************
+/// @file    kinematic.c
+/// @author  NeoProg
+//  ***************************************************************************
+#include "kinematic.h"
+#include "fast_math.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI                                (3.14159265f)
+#endif
+#define RAD_TO_DEG(rad)                     ((rad) * 180.0f / M_PI)
+#define DEG_TO_RAD(deg)                     ((deg) * M_PI / 180.0f)
+
+
+static void apply_protection(const limb_geometry_t* limb, kinematic_result_t* result);
+static bool apply_reach_envelope(const kinematic_const_t* ik, float* x, float* y);
+
+
+//  ***************************************************************************
+/// @brief  Precalculate limb constants for fast IK backend
+/// @note   Call after limb links configuration changed
+/// @param  limb: limb geometry. @ref limb_geometry_t
+/// @retval limb::ik
+/// @return none
+//  ***************************************************************************
+void kinematic_prepare_limb(limb_geometry_t* limb) {
+
+    float coxa_zero_rotate_rad = DEG_TO_RAD((float)limb->coxa.zero_rotate);
+    float femur_length = limb->femur.length;
+    float tibia_length = limb->tibia.length;
+
+    limb->ik.coxa_zero_rotate_sin = sinf(coxa_zero_rotate_rad);
+    limb->ik.coxa_zero_rotate_cos = cosf(coxa_zero_rotate_rad);
+    limb->ik.max_reach            = femur_length + tibia_length - KINEMATIC_REACH_MARGIN;
+    limb->ik.min_reach            = fabsf(femur_length - tibia_length) + KINEMATIC_REACH_MARGIN;
+    if (limb->ik.min_reach > limb->ik.max_reach) {
+        limb->ik.min_reach = limb->ik.max_reach;
+    }
+    limb->ik.max_distance_sqr     = limb->ik.max_reach * limb->ik.max_reach;
+    limb->ik.min_distance_sqr     = limb->ik.min_reach * limb->ik.min_reach;
+    limb->ik.links_sqr_sum        = femur_length * femur_length + tibia_length * tibia_length;
+    limb->ik.links_sqr_diff       = femur_length * femur_length - tibia_length * tibia_length;
+    limb->ik.inv_2_femur          = 0;
+    limb->ik.inv_2_femur_tibia    = 0;
+    if (femur_length != 0 && tibia_length != 0) {
+        limb->ik.inv_2_femur       = 1.0f / (2.0f * femur_length);
+        limb->ik.inv_2_femur_tibia = 1.0f / (2.0f * femur_length * tibia_length);
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Calculate angles (reference libm backend)
+/// @note   Not attainable point is projected to reachability envelope
+/// @param  limb: limb geometry. @ref limb_geometry_t
+/// @param  position: limb position
+/// @param  result: IK result. @ref kinematic_result_t
+/// @retval result
+/// @return true - calculation success, false - no
+//  ***************************************************************************
+bool kinematic_calculate_angles_float(const limb_geometry_t* limb, const point_3d_t* position, kinematic_result_t* result) {
+
+    float coxa_zero_rotate_deg  = limb->coxa.zero_rotate;
+    float femur_zero_rotate_deg = limb->femur.zero_rotate;
+    float tibia_zero_rotate_deg = limb->tibia.zero_rotate;
+    float coxa_length  = limb->coxa.length;
+    float femur_length = limb->femur.length;
+    float tibia_length = limb->tibia.length;
+
+    float x = position->x;
+    float y = position->y;
+    float z = position->z;
+
+
+    // Move to (X*, Y*, Z*) coordinate system - rotate
+    float coxa_zero_rotate_rad = DEG_TO_RAD(coxa_zero_rotate_deg);
+    float x1 = x * cosf(coxa_zero_rotate_rad) + z * sinf(coxa_zero_rotate_rad);
+    float y1 = y;
+    float z1 = -x * sinf(coxa_zero_rotate_rad) + z * cosf(coxa_zero_rotate_rad);
+
+
+    //
+    // Calculate COXA angle
+    //
+    float coxa_angle_rad = atan2f(z1, x1);
+    result->angles[ROBOT_JOINT_COXA] = RAD_TO_DEG(coxa_angle_rad);
+
+
+    //
+    // Prepare for calculation FEMUR and TIBIA angles
+    //
+    // Move to (X*, Y*) coordinate system (rotate on axis Y)
+    x1 = x1 * cosf(coxa_angle_rad) + z1 * sinf(coxa_angle_rad);
+
+    // Move to (X**, Y**) coordinate system (remove coxa from calculations)
+    x1 = x1 - coxa_length;
+    
+    // Project not attainable point to reachability envelope
+    result->is_position_clamped = apply_reach_envelope(&limb->ik, &x1, &y1);
+
+    // Calculate angle between axis X and destination point
+    float fi = atan2f(y1, x1);
+
+    // Calculate distance to destination point
+    float d = sqrt(x1 * x1 + y1 * y1);
+
+
+    //
+    // Calculate triangle angles
+    //
+    float a = tibia_length;
+    float b = femur_length;
+    float c = d;
+
+    float alpha = acosf( (b * b + c * c - a * a) / (2.0f * b * c) );
+    float gamma = acosf( (a * a + b * b - c * c) / (2.0f * a * b) );
+
+
+    //
+    // Calculate FEMUR and TIBIA angle
+    //
+    result->angles[ROBOT_JOINT_FEMUR] = femur_zero_rotate_deg - RAD_TO_DEG(alpha) - RAD_TO_DEG(fi);
+    result->angles[ROBOT_JOINT_TIBIA] = RAD_TO_DEG(gamma) - tibia_zero_rotate_deg;
+
+    apply_protection(limb, result);
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Calculate angles (fast backend)
+/// @note   Same math as kinematic_calculate_angles_float(), but coxa zero rotate
+///         and link constants are taken from limb::ik, rotate back on coxa angle
+///         is replaced by vector length and libm calls are replaced by polynomials.
+///         Not attainable point is projected to reachability envelope
+/// @param  limb: limb geometry. @ref limb_geometry_t
+/// @param  position: limb position
+/// @param  result: IK result. @ref kinematic_result_t
+/// @retval result
+/// @return true - calculation success, false - no
+//  ***************************************************************************
+bool kinematic_calculate_angles_fast(const limb_geometry_t* limb, const point_3d_t* position, kinematic_result_t* result) {
+
+    const kinematic_const_t* ik = &limb->ik;
+
+    float x = position->x;
+    float y = position->y;
+    float z = position->z;
+
+    // Move to (X*, Y*, Z*) coordinate system - rotate
+    float x1 =  x * ik->coxa_zero_rotate_cos + z * ik->coxa_zero_rotate_sin;
+    float z1 = -x * ik->coxa_zero_rotate_sin + z * ik->coxa_zero_rotate_cos;
+
+    // Calculate COXA angle
+    result->angles[ROBOT_JOINT_COXA] = RAD_TO_DEG(fast_atan2f(z1, x1));
+
+    // Rotate on axis Y and remove coxa: x1 * cos(coxa) + z1 * sin(coxa) == |(x1, z1)|
+    float x2 = fast_sqrtf(x1 * x1 + z1 * z1) - (float)limb->coxa.length;
+    
+    // Project not attainable point to reachability envelope
+    result->is_position_clamped = apply_reach_envelope(ik, &x2, &y);
+
+    // Calculate angle between axis X and destination point
+    float fi = fast_atan2f(y, x2);
+
+    // Calculate distance to destination point
+    float d_sqr = x2 * x2 + y * y;
+    float d = fast_sqrtf(d_sqr);
+    if (d == 0) {
+        return false; // Degenerate triangle (zero links)
+    }
+
+    // Calculate triangle angles
+    float alpha = fast_acosf((d_sqr + ik->links_sqr_diff) * ik->inv_2_femur / d);
+    float gamma = fast_acosf((ik->links_sqr_sum - d_sqr) * ik->inv_2_femur_tibia);
+
+    // Calculate FEMUR and TIBIA angle
+    result->angles[ROBOT_JOINT_FEMUR] = (float)limb->femur.zero_rotate - RAD_TO_DEG(alpha + fi);
+    result->angles[ROBOT_JOINT_TIBIA] = RAD_TO_DEG(gamma) - (float)limb->tibia.zero_rotate;
+
+    apply_protection(limb, result);
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Calculate limb position by joints angles (forward kinematic)
+/// @note   Inverse of kinematic_calculate_angles_float() for attainable points.
+///         Femur direction is (zero rotate - femur angle) from X** axis, tibia 
+///         is rotated from femur direction on (tibia angle + zero rotate - 180)
+/// @param  limb: limb geometry. @ref limb_geometry_t
+/// @param  angles: joints angles by ROBOT_JOINT_xxx, [degree]
+/// @param  position: limb position
+/// @retval position
+/// @return none
+//  ***************************************************************************
+void kinematic_calculate_position(const limb_geometry_t* limb, const float* angles, point_3d_t* position) {
+
+    float femur_rad = DEG_TO_RAD((float)limb->femur.zero_rotate - angles[ROBOT_JOINT_FEMUR]);
+    float tibia_rad = femur_rad + DEG_TO_RAD(angles[ROBOT_JOINT_TIBIA] + (float)limb->tibia.zero_rotate) - M_PI;
+
+    // Limb plane: (X**, Y**) coordinate system
+    float x2 = limb->femur.length * cosf(femur_rad) + limb->tibia.length * cosf(tibia_rad);
+    float y  = limb->femur.length * sinf(femur_rad) + limb->tibia.length * sinf(tibia_rad);
+
+    // Add coxa and rotate on axis Y: (X*, Y*, Z*) coordinate system
+    float coxa_rad = DEG_TO_RAD(angles[ROBOT_JOINT_COXA]);
+    float radius = x2 + (float)limb->coxa.length;
+    float x1 = radius * cosf(coxa_rad);
+    float z1 = radius * sinf(coxa_rad);
+
+    // Rotate back on coxa zero rotate
+    position->x = x1 * limb->ik.coxa_zero_rotate_cos - z1 * limb->ik.coxa_zero_rotate_sin;
+    position->y = y;
+    position->z = x1 * limb->ik.coxa_zero_rotate_sin + z1 * limb->ik.coxa_zero_rotate_cos;
+}
+
+
+
+
+
+//  ***************************************************************************
+/// @brief  Project point to reachability envelope
+/// @note   Envelope is ring [min_reach; max_reach] around femur joint in 
+///         limb plane. Point is moved along direction from femur joint
+/// @param  ik: limb constants
+/// @param  x: X** coordinate (from femur joint)
+/// @param  y: Y** coordinate
+/// @retval x, y
+/// @return true - point was projected, false - point is attainable
+//  ***************************************************************************
+static bool apply_reach_envelope(const kinematic_const_t* ik, float* x, float* y) {
+    
+    float d_sqr = (*x) * (*x) + (*y) * (*y);
+    if (d_sqr <= ik->max_distance_sqr && d_sqr >= ik->min_distance_sqr) {
+        return false;
+    }
+    
+    float reach = (d_sqr > ik->max_distance_sqr) ? ik->max_reach : ik->min_reach;
+    if (d_sqr == 0) {
+        *x = reach; // Direction is not defined - use limb axis
+        *y = 0;
+        return true;
+    }
+    float k = reach / fast_sqrtf(d_sqr);
+    *x *= k;
+    *y *= k;
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Apply protection angles
+/// @param  limb: limb geometry. @ref limb_geometry_t
+/// @param  result: IK result. @ref kinematic_result_t
+/// @retval result::angles, result::is_angles_limited
+/// @return none
+//  ***************************************************************************
+static void apply_protection(const limb_geometry_t* limb, kinematic_result_t* result) {
+
+    const link_t* links[ROBOT_JOINTS_PER_LIMB] = { &limb->coxa, &limb->femur, &limb->tibia };
+    result->is_angles_limited = false;
+    for (uint32_t i = 0; i < ROBOT_JOINTS_PER_LIMB; ++i) {
+        if (result->angles[i] < links[i]->prot_min_angle) {
+            result->angles[i] = links[i]->prot_min_angle;
+            result->is_angles_limited = true;
+        }
+        if (result->angles[i] > links[i]->prot_max_angle) {
+            result->angles[i] = links[i]->prot_max_angle;
+            result->is_angles_limited = true;
+        }
+    }
+}
@@ -0,0 +1,75 @@
+//  ***************************************************************************
+/// @file    kinematic.h
+/// @author  NeoProg
+/// @brief   Limb inverse kinematic
+/// @note    Host compilable (no hardware dependencies)
+//  ***************************************************************************
+#ifndef _KINEMATIC_H_
+#define _KINEMATIC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "motion_core.h"
+#include "robot_config.h"
+
+// IK backend: 0 - libm float path, 1 - precomputed constants and polynomial approximations
+#ifndef KINEMATIC_FAST_BACKEND_ENABLE
+#define KINEMATIC_FAST_BACKEND_ENABLE       (1)
+#endif
+
+#define KINEMATIC_REACH_MARGIN              (1.0f)  // Reachability envelope margin, [mm]
+
+
+#if ROBOT_JOINTS_PER_LIMB != 3
+#error "IK supports coxa-femur-tibia limbs only"
+#endif
+
+
+typedef struct {
+    uint16_t length;
+    int16_t  zero_rotate;
+
+    int16_t  prot_min_angle; // Protection min angle, [degree]
+    int16_t  prot_max_angle; // Protection max angle, [degree]
+} link_t;
+
+typedef struct {
+    float coxa_zero_rotate_sin;
+    float coxa_zero_rotate_cos;
+    float max_reach;                // Reachability envelope: femur + tibia - margin
+    float min_reach;                // |femur - tibia| + margin
+    float max_distance_sqr;         // max_reach^2
+    float min_distance_sqr;         // min_reach^2
+    float links_sqr_sum;            // femur^2 + tibia^2
+    float links_sqr_diff;           // femur^2 - tibia^2
+    float inv_2_femur;              // 1 / (2 * femur)
+    float inv_2_femur_tibia;        // 1 / (2 * femur * tibia)
+} kinematic_const_t;
+
+typedef struct {
+    link_t coxa;
+    link_t femur;
+    link_t tibia;
+    kinematic_const_t ik;           // Initialize by kinematic_prepare_limb()
+} limb_geometry_t;
+
+typedef struct {
+    float angles[ROBOT_JOINTS_PER_LIMB]; // Joints angles by ROBOT_JOINT_xxx, [degree]
+    bool  is_position_clamped;      // Position was projected to reachability envelope
+    bool  is_angles_limited;        // Joint angle was limited by protection
+} kinematic_result_t;
+
+
+extern void kinematic_prepare_limb(limb_geometry_t* limb);
+extern bool kinematic_calculate_angles_float(const limb_geometry_t* limb, const point_3d_t* position, kinematic_result_t* result);
+extern bool kinematic_calculate_angles_fast(const limb_geometry_t* limb, const point_3d_t* position, kinematic_result_t* result);
+extern void kinematic_calculate_position(const limb_geometry_t* limb, const float* angles, point_3d_t* position);
+
+#if KINEMATIC_FAST_BACKEND_ENABLE
+#define kinematic_calculate_angles(limb, position, result)    kinematic_calculate_angles_fast(limb, position, result)
+#else
+#define kinematic_calculate_angles(limb, position, result)    kinematic_calculate_angles_float(limb, position, result)
+#endif
+
+
+#endif // _KINEMATIC_H_
@@ -10,6 +10,8 @@
 #include "servo_driver.h"
 #include "motion_core.h"
 #include "sequences_engine.h"
+#include "sequences_storage.h"
+#include "cue_scheduler.h"
 #include "indication.h"
 #include "gui.h"
 #include "camera.h"
@@ -50,6 +52,7 @@ void main() {
     
     // Initializaion submodules
     camera_init();    
+    sequences_storage_init();
     sequences_engine_init();
     
     delay_ms(100);
@@ -63,12 +66,17 @@ void main() {
         
         camera_process();
         
+        // Select sequence by show cues
+        cue_scheduler_process();
+        
         // Override select sequence if need
         if (sysmon_is_error_set(SYSMON_CONN_LOST_ERROR) == true) {
+            cue_scheduler_stop();
             sequences_engine_select_sequence(SEQUENCE_DOWN, 0, 0);
         }
         // Disable servo power if low supply voltage
         if (sysmon_is_error_set(SYSMON_VOLTAGE_ERROR) == true) {
+            cue_scheduler_stop();
             sequences_engine_select_sequence(SEQUENCE_DOWN, 0, 0);
             servo_driver_power_off();
         }
@@ -148,6 +156,14 @@ static void system_init(void) {
     // Enable clocks for TIM17
     RCC->APB2ENR |= RCC_APB2ENR_TIM17EN;
     while ((RCC->APB2ENR & RCC_APB2ENR_TIM17EN) == 0);    
+
+#if PWM_DMA_WAVEFORM_ENABLE
+    // Enable clocks for DMA2 and TIM5 (PWM DMA waveform)
+    RCC->AHBENR |= RCC_AHBENR_DMA2EN;
+    while ((RCC->AHBENR & RCC_AHBENR_DMA2EN) == 0);
+    RCC->APB1ENR |= RCC_APB1ENR_TIM5EN;
+    while ((RCC->APB1ENR & RCC_APB1ENR_TIM5EN) == 0);
+#endif
     
     // Enable clocks for USART3
     RCC->APB1ENR |= RCC_APB1ENR_USART3EN;
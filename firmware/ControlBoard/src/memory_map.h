@@ -35,8 +35,23 @@
 
 #define MM_SERVO_CONFIG_OFFSET                              (0)          ///< U8  Servo configuration
 #define     MM_SERVO_CONFIG_REVERSE_DIRECTION_MASK          (0x01)
-#define     MM_SERVO_CONFIG_SERVO_TYPE_MASK                 (0xF0)
+#define     MM_SERVO_CONFIG_CALIBRATION_TABLE_MASK          (0x02)       ///< Calibration table is programmed
+#define     MM_SERVO_CONFIG_SERVO_TYPE_MASK                 (0xF0)       ///< Servo type: 0 - DS3218MG 270, 1 - DS3218MG 180, 2 - DS3225MG 270
 #define MM_SERVO_ZERO_TRIM_OFFSET                           (2)          ///< S16 Servo zero trim
+#define MM_SERVO_CALIBRATION_TABLE_OFFSET                   (4)          ///< S8[4] Measured pulse width minus nominal at physic angles 0, 1/3, 2/3, 1 of range [us]
+#define     MM_SERVO_CALIBRATION_POINTS_COUNT               (4)
+
+#define MM_SERVO_LIMITS_BLOCK_BASE_EE_ADDRESS               (0x02A0)
+#define MM_SERVO_LIMITS_BLOCK_SIZE                          (4)
+#define MM_SERVO_MAX_SPEED_OFFSET                           (0)          ///< U16 Max servo speed [degree/s], not more rated speed of servo type. 0 or 0xFFFF - not limited
+#define MM_SERVO_MAX_ACCELERATION_OFFSET                    (2)          ///< U16 Max servo acceleration [degree/s^2]. 0 or 0xFFFF - not limited
+
+//
+// Uploaded sequences (sequence image, @ref sequence_image_t). Section is not
+// covered by page checksums, image has own checksum
+//
+#define MM_SEQUENCES_BASE_EE_ADDRESS                        (0x0300)
+#define MM_SEQUENCES_SECTION_SIZE                           (0x0700)     ///< Max image size is 1560 bytes
 
 
 #endif // _MEMORY_MAP_H_
@@ -4,13 +4,26 @@
 //  ***************************************************************************
 #include "motion_core.h"
 #include "project_base.h"
+#include "kinematic.h"
+#include "body_pose.h"
+#include "gait_generator.h"
+#include "trajectory_kernel.h"
 #include "servo_driver.h"
 #include "configurator.h"
 #include "systimer.h"
 #include "pwm.h"
 #include "system_monitor.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
 #include <math.h>
 
+#ifndef M_PI
+#define M_PI                                (3.14159265f)
+#endif
+#define RAD_TO_DEG(rad)                     ((rad) * 180.0f / M_PI)
+#define DEG_TO_RAD(deg)                     ((deg) * M_PI / 180.0f)
+
 
 typedef enum {
     STATE_NOINIT,
@@ -20,40 +33,168 @@ typedef enum {
 } core_state_t;
 
 typedef struct {
-    float    angle;
-    uint16_t length;
-    int16_t  zero_rotate;
-    
-    int16_t  prot_min_angle; // Protection min angle, [degree]
-    int16_t  prot_max_angle; // Protection max angle, [degree]
-} link_t;
+    int32_t curvature;
+    int32_t distance;
+} traejctory_config_t;
 
 typedef struct {
-    point_3d_t position;
-    link_t coxa;
-    link_t femur;
-    link_t tibia;
-} limb_t;
+    float    x[SUPPORT_LIMBS_COUNT];                    // Limbs positions (trajectory target, without body pose)
+    float    y[SUPPORT_LIMBS_COUNT];
+    float    z[SUPPORT_LIMBS_COUNT];
+    float    angles[ROBOT_JOINTS_PER_LIMB][SUPPORT_LIMBS_COUNT]; // Joints angles by last IK, [joint][limb]
+    float    ik_x[SUPPORT_LIMBS_COUNT];                 // Positions of last IK (with body pose). IK is skipped if it not changed
+    float    ik_y[SUPPORT_LIMBS_COUNT];
+    float    ik_z[SUPPORT_LIMBS_COUNT];
+    uint32_t ik_valid_mask;                             // Limbs which ik_x/y/z and angles are actual
+    uint32_t clamped_mask;                              // Limbs which positions was projected to reachability envelope by last IK
+} limbs_state_t;
 
 typedef struct {
-    int32_t curvature;
-    int32_t distance;
-} traejctory_config_t;
+    bool     is_valid;
+    uint32_t limbs_mask;                                // Limbs which use advanced trajectory
+    float    curvature_radius;
+    float    trajectory_radius[SUPPORT_LIMBS_COUNT];
+    float    start_angle_rad[SUPPORT_LIMBS_COUNT];
+    float    max_arc_angle;
+    float    arc_step_cos;                              // Arc rotation per time step
+    float    arc_step_sin;
+    float    height_step_cos;                           // Step height phase rotation per time step
+    float    height_step_sin;
+    float    gait_landing_x[SUPPORT_LIMBS_COUNT];       // Swing end point of gait trajectory
+    float    gait_landing_z[SUPPORT_LIMBS_COUNT];
+    float    gait_swing_max_length;                     // Max XZ path of limb per swing
+    bool     is_hot_update;                             // Trajectory configuration can be updated at any tick
+} adv_trajectory_context_t;
+
+typedef struct {
+    bool     is_seeded;                                 // Incremental state is valid for motion tick
+    uint32_t motion_tick;
+    float    arc_cos[SUPPORT_LIMBS_COUNT];
+    float    arc_sin[SUPPORT_LIMBS_COUNT];
+    float    height_cos;
+    float    height_sin;
+    float    gait_phase;                                // Gait cycle phase of limbs positions for gait trajectory
+} adv_trajectory_state_t;
+
+typedef struct {
+    uint32_t   limbs_mask;                              // Limbs which use spline trajectory
+    float      coeffs[SUPPORT_LIMBS_COUNT][3][6];       // X, Y, Z polynomials by motion time: c0 + c1 * t + ... + c5 * t^5
+    point_3d_t end_positions[SUPPORT_LIMBS_COUNT];      // Spline end points, next spline segment starts from them
+    point_3d_t end_velocities[SUPPORT_LIMBS_COUNT];     // [mm per PWM period]
+} spline_trajectory_context_t;
+
+typedef struct {
+    uint32_t   limbs_mask;                              // Limbs which use joint space trajectory
+    uint32_t   clamped_mask;                            // Limbs which keyframes was projected to reachability envelope
+    float      start_time;                              // Motion time of start keyframe [0; 1]
+    float      inv_duration;                            // 1 / (1 - start_time)
+    float      start_angles[ROBOT_JOINTS_PER_LIMB][SUPPORT_LIMBS_COUNT];  // Start keyframe, [joint][limb]
+    float      delta_angles[ROBOT_JOINTS_PER_LIMB][SUPPORT_LIMBS_COUNT];  // Destination keyframe - start keyframe
+    point_3d_t dest_positions[SUPPORT_LIMBS_COUNT];     // Destination keyframe positions (time direction is folded in)
+    body_pose_transform_t pose;                         // Body pose of keyframes
+} joint_trajectory_context_t;
+
+typedef struct {
+    motion_config_t     motion_config;                  // Motion configuration with initialized start positions
+    point_3d_t          limbs_positions[SUPPORT_LIMBS_COUNT];   // Limbs positions before motion (gait trajectory starts from them)
+    point_3d_t          spline_velocities[SUPPORT_LIMBS_COUNT]; // Spline start velocities (depends on previous motion)
+    uint32_t            clamps_count[SUPPORT_LIMBS_COUNT];      // Reachability clamps in baked rows
+    point_3d_t          end_positions[SUPPORT_LIMBS_COUNT];
+    traejctory_config_t trajectory_config;
+    float               time_step;                      // Motion time step with speed multiplier
+    uint32_t            first_row;
+    uint32_t            rows_count;                     // 0 - free item
+    uint32_t            baked_rows_count;
+    uint32_t            allocation_number;              // Allocation order, oldest motion is evicted first
+} baked_motion_t;
 
 
 static bool read_configuration(void);
-static bool process_linear_trajectory(float motion_time);
-static bool process_advanced_trajectory(float motion_time);
-static bool kinematic_calculate_angles(void);
+static bool read_limb_parameter(uint32_t address, int32_t default_value, uint16_t* value);
+static void shift_motion_time(uint32_t ticks);
+static float get_frame_time_scale(void);
+static int32_t get_blend_time_step(const motion_config_t* motion_config);
+static float get_gait_phase(uint32_t motion_tick);
+static void load_servo_angles(uint32_t changed_limbs_mask);
+static void sync_limbs_positions(void);
+static void update_command_latency(void);
+static bool process_motion_tick(uint32_t motion_tick, limbs_state_t* limbs, adv_trajectory_state_t* state, const body_pose_transform_t* pose, uint32_t* changed_limbs_mask);
+static bool process_linear_trajectory(float motion_time, limbs_state_t* limbs);
+static void process_spline_trajectory(float motion_time, limbs_state_t* limbs);
+static void build_spline_trajectory_context(const motion_config_t* next_motion_config);
+static bool process_advanced_trajectory(uint32_t motion_tick, float motion_time, limbs_state_t* limbs, adv_trajectory_state_t* state);
+static void process_gait_trajectory(uint32_t limb_index, float prev_phase, float phase, float stance_cos, float stance_sin, limbs_state_t* limbs);
+static bool build_advanced_trajectory_context(void);
+static bool process_joint_trajectory(float motion_time, limbs_state_t* limbs, const body_pose_transform_t* pose);
+static bool build_joint_trajectory_context(const body_pose_transform_t* pose);
+static bool solve_joint_keyframe(uint32_t limb, const point_3d_t* position, const body_pose_transform_t* pose, float* angles, bool* is_clamped);
+static bool is_pose_equal(const body_pose_transform_t* a, const body_pose_transform_t* b);
+static bool calculate_arc_geometry(const point_3d_t* start_positions, uint32_t limbs_mask, int32_t curvature, int32_t distance, adv_trajectory_context_t* ctx);
+static bool calculate_limbs_angles(limbs_state_t* limbs, const body_pose_transform_t* pose, uint32_t joint_limbs_mask, uint32_t* changed_limbs_mask);
+static void update_ik_statistic(uint32_t changed_limbs_mask);
+static void update_clamps_counters(const limbs_state_t* limbs, uint32_t* counters);
+static inline point_3d_t get_limb_position(const limbs_state_t* limbs, uint32_t limb);
+static inline void set_limb_position(limbs_state_t* limbs, uint32_t limb, const point_3d_t* position);
+static baked_motion_t* baked_schedule_select(void);
+static bool is_motion_config_equal(const motion_config_t* a, const motion_config_t* b);
+static void baked_schedule_init_baker(void);
+static bool baked_schedule_bake_next_row(void);
+static void baked_schedule_replay_tick(void);
+static uint32_t baked_schedule_plan_rows(uint16_t* row_ticks);
+static uint32_t baked_schedule_find_row(void);
 
 
 static core_state_t g_core_state = STATE_NOINIT;
-static limb_t g_limbs_list[SUPPORT_LIMBS_COUNT] = {0};
+static limb_geometry_t g_limbs_geometry[SUPPORT_LIMBS_COUNT] = {0};
+static limbs_state_t g_limbs = {0};
 
 static motion_config_t g_motion_config = {0};
+static float g_speed_multiplier = 1.0f;
+static float g_motion_time_step = 0;            // Motion time step with speed multiplier
+static float g_motion_time_begin = 0;           // Motion time of tick 0: start time with scheduled start offset
+static uint32_t g_motion_tick = 0;              // Motion time = motion time begin + tick * time step
+static uint32_t g_motion_ticks_count = 0;
+static uint64_t g_start_period = 0;             // Scheduled start of next motion, [PWM periods]. 0 - not scheduled
+static float g_start_offset = 0;                // Part of PWM period elapsed from start time on g_start_period
+static uint64_t g_motion_start_period = 0;      // First tick of current motion waits this period. 0 - no wait
+static uint32_t g_start_late_periods = 0;       // Lateness of last scheduled start, [PWM periods]
+static bool is_start_late_measured = false;
+static uint32_t g_missed_ticks_count = 0;       // Ticks which are skipped for catch up PWM periods
+static uint64_t g_command_time = 0;             // Command receive time for latency measure. 0 - no command
+static uint32_t g_last_latency = 0;             // Command to first servo change latency, [ms]
+static uint32_t g_max_latency = 0;
+static uint32_t g_preempt_count = 0;
+static uint32_t g_hot_update_count = 0;
+static uint32_t g_clamps_count[SUPPORT_LIMBS_COUNT] = {0};  // Limbs positions projected to reachability envelope
+static uint32_t g_ik_limbs_count = 0;           // Limbs recalculated by IK in current statistic window
+static uint32_t g_ik_limbs_per_second = 0;
+static uint32_t g_linear_max_cycles = 0;        // Worst linear trajectories calculation time, [CPU cycles]
+static uint32_t g_baked_replay_ticks_count = 0; // Ticks replayed from baked schedule
+static uint32_t g_baked_live_ticks_count = 0;   // Ticks of baked motions calculated live (rows are not ready)
+static uint64_t g_ik_statistic_time = 0;        // Statistic window begin time, [ms]
 static traejctory_config_t g_current_trajectory_config = {0};
 static traejctory_config_t g_next_trajectory_config = {0};
 static bool is_trajectory_config_init = false;
+static adv_trajectory_context_t g_adv_trajectory_ctx = {0};
+static adv_trajectory_state_t g_adv_trajectory_state = {0};
+static linear_kernel_t g_linear_kernel = {0};
+static spline_trajectory_context_t g_spline_ctx = {0};
+static point_3d_t g_spline_start_velocities[SUPPORT_LIMBS_COUNT] = {0};
+static joint_trajectory_context_t g_joint_ctx = {0};
+static const motion_config_t* g_next_motion_config = NULL;
+static const gait_params_t* g_gait_params = NULL;
+
+#if MOTION_CORE_BAKED_SCHEDULE_ENABLE
+static uint16_t g_baked_rows[MOTION_CORE_BAKED_SCHEDULE_MAX_ROWS][SUPPORT_SERVO_COUNT];
+static uint16_t g_baked_row_ticks[MOTION_CORE_BAKED_SCHEDULE_MAX_ROWS];    // Motion tick of row
+static uint32_t g_baked_replay_row = 0;                         // Row of current motion tick or previous row
+static baked_motion_t g_baked_motions[MOTION_CORE_BAKED_SCHEDULE_MAX_MOTIONS] = {0};
+static uint32_t g_baked_allocations_count = 0;
+static uint32_t g_baked_rows_used = 0;                          // Rows pool is used as ring buffer
+static baked_motion_t* g_baked_motion = NULL;                  // Baked schedule of current motion. NULL - live calculation
+static limbs_state_t g_baker_limbs = {0};                       // Baker works ahead of motion time on own limbs state
+static adv_trajectory_state_t g_baker_adv_trajectory_state = {0};
+#endif
 
 
 
@@ -72,11 +213,13 @@ void motion_core_init(const point_3d_t* start_point_list) {
     
     // Set start points
     for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
-        g_limbs_list[i].position = start_point_list[i];
+        set_limb_position(&g_limbs, i, &start_point_list[i]);
     }
     
     // Calculate start link angles
-    if (kinematic_calculate_angles() == false) {
+    body_pose_init();
+    uint32_t changed_limbs_mask = 0;
+    if (calculate_limbs_angles(&g_limbs, body_pose_get_transform(), 0, &changed_limbs_mask) == false) {
         sysmon_set_error(SYSMON_CONFIG_ERROR);
         sysmon_disable_module(SYSMON_MODULE_MOTION_DRIVER);
         // Do not return - need init servo driver for CLI access
@@ -84,11 +227,7 @@ void motion_core_init(const point_3d_t* start_point_list) {
     
     // Initialize servo driver
     servo_driver_init();
-    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
-        servo_driver_move(i * 3 + 0, g_limbs_list[i].coxa.angle);
-        servo_driver_move(i * 3 + 1, g_limbs_list[i].femur.angle);
-        servo_driver_move(i * 3 + 2, g_limbs_list[i].tibia.angle);
-    }
+    load_servo_angles(changed_limbs_mask);
     
     // Enable servo power
     if (sysmon_is_module_disable(SYSMON_MODULE_MOTION_DRIVER) == false) {
@@ -110,15 +249,106 @@ void motion_core_start_motion(const motion_config_t* motion_config) {
     g_motion_config = *motion_config;
     if (g_motion_config.is_need_init_start_position) {
         for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
-            g_motion_config.start_positions[i] = g_limbs_list[i].position;
+            g_motion_config.start_positions[i] = get_limb_position(&g_limbs, i);
         }
     }
     
+    // Initialize motion clock. Motion time is calculated from tick counter for avoid rounding error accumulation.
+    // Time step is set for PWM_FREQUENCY_HZ motion clock and scaled for current PWM frequency
+    g_motion_time_step = (float)g_motion_config.time_step * g_speed_multiplier * get_frame_time_scale();
+    g_motion_tick = 0;
+    g_motion_ticks_count = 0;
+    
+    // Scheduled start: first tick waits start period and start offset is carried to motion clock
+    // (first tick is calculated for motion time elapsed from start time)
+    g_motion_start_period = g_start_period;
+    g_motion_time_begin = (float)g_motion_config.motion_time + g_start_offset * g_motion_time_step;
+    g_start_period = 0;
+    g_start_offset = 0;
+    g_adv_trajectory_state.gait_phase = g_motion_time_begin / (float)MTIME_SCALE;
+    if (g_motion_time_step > 0 && (float)g_motion_config.time_stop > g_motion_time_begin) {
+        g_motion_ticks_count = (uint32_t)ceilf(((float)g_motion_config.time_stop - g_motion_time_begin) / g_motion_time_step);
+    }
+    
     // Initialize trajectory configuration
     if (is_trajectory_config_init == false) {
         g_current_trajectory_config = g_next_trajectory_config;
         is_trajectory_config_init = true;
     }
+    
+    // Pack linear trajectories coefficients. Last tick is not reach time_stop, linear trajectories are finished on it
+    float last_tick_time = 1.0f;
+    if (g_motion_ticks_count > 1) {
+        last_tick_time = (g_motion_time_begin + (g_motion_ticks_count - 1) * g_motion_time_step) / (float)MTIME_SCALE;
+    }
+    trajectory_kernel_build_linear(&g_motion_config, last_tick_time, &g_linear_kernel);
+    
+    // Calculate motion constant part of advanced trajectory
+    build_advanced_trajectory_context();
+    g_adv_trajectory_state.is_seeded = false;
+    
+    // Calculate spline coefficients. Next motion is used only once
+    build_spline_trajectory_context(g_next_motion_config);
+    g_next_motion_config = NULL;
+    
+    // Solve IK for joint space trajectory keyframes
+    if (build_joint_trajectory_context(body_pose_get_transform()) == false) {
+        sysmon_set_error(SYSMON_MATH_ERROR);
+        sysmon_disable_module(SYSMON_MODULE_MOTION_DRIVER);
+    }
+    
+#if MOTION_CORE_BAKED_SCHEDULE_ENABLE
+    // Select baked schedule for motion. Fallback to live calculation if it not available
+    g_baked_motion = baked_schedule_select();
+#endif
+}
+
+//  ***************************************************************************
+/// @brief  Set motion which will be started after next started motion
+/// @note   Spline trajectories pass through destination points of this motion
+///         without stop. Call before motion_core_start_motion()
+/// @param  next_motion_config: next motion configuration or NULL if it unknown
+/// @return none
+//  ***************************************************************************
+void motion_core_set_next_motion(const motion_config_t* next_motion_config) {
+    g_next_motion_config = next_motion_config;
+}
+
+//  ***************************************************************************
+/// @brief  Interrupt current motion and start new motion
+/// @note   New motion should start from current limbs positions and use 
+///         linear or joint space trajectories. Motion time step is limited for limbs speed 
+///         not more than MOTION_CORE_BLEND_MAX_SPEED
+/// @param  motion_config: motion configuration. @ref motion_config_t
+/// @return none
+//  ***************************************************************************
+void motion_core_preempt_motion(const motion_config_t* motion_config) {
+    
+    // Limbs positions are not calculated while baked schedule replay
+    sync_limbs_positions();
+    
+    // Limit motion time step by max limb distance
+    motion_config_t blend_config = *motion_config;
+    blend_config.time_step = get_blend_time_step(motion_config);
+    
+    motion_core_start_motion(&blend_config);
+    ++g_preempt_count;
+    
+#if MOTION_CORE_BAKED_SCHEDULE_ENABLE
+    // Blend motion is unique (start positions), do not bake it
+    g_baked_motion = NULL;
+#endif
+}
+
+//  ***************************************************************************
+/// @brief  Mark command for latency measure
+/// @note   Call before start motion which is reaction on command. Latency is
+///         time from command to first servo change of this motion
+/// @param  command_time: command receive time, [ms]
+/// @return none
+//  ***************************************************************************
+void motion_core_mark_command(uint64_t command_time) {
+    g_command_time = command_time;
 }
 
 //  ***************************************************************************
@@ -130,10 +360,13 @@ void motion_core_reset_trajectory_config(void) {
     g_current_trajectory_config.curvature = 1;
     g_current_trajectory_config.distance = 0;
     is_trajectory_config_init = false;
+    g_adv_trajectory_ctx.is_valid = false;
 }
 
 //  ***************************************************************************
 /// @brief  Update trajectory configuration
+/// @note   Gait trajectory applies configuration on next motion tick, other
+///         advanced trajectories apply it at motion time_update
 /// @param  curvature: curvature (parameter of trajectory)
 /// @param  distance: distance (parameter of trajectory)
 /// @return none
@@ -153,61 +386,110 @@ void motion_core_process(void) {
     if (sysmon_is_module_disable(SYSMON_MODULE_MOTION_DRIVER) == true) return;  // Module disabled
 
     
-    static uint64_t prev_synchro_value = 0;    
-    float scaled_motion_time = 0;
+    static uint64_t prev_synchro_value = 0;
     switch (g_core_state) {
 
         case STATE_SYNC:
             if (synchro != prev_synchro_value) {
                 if (synchro - prev_synchro_value > 1 && prev_synchro_value != 0) {
                     sysmon_set_error(SYSMON_SYNC_ERROR);
+                    
+                    // Catch up motion time for missed periods. Motion is not moved before scheduled start
+                    uint64_t first_missed_period = prev_synchro_value + 1;
+                    if (first_missed_period < g_motion_start_period) {
+                        first_missed_period = g_motion_start_period;
+                    }
+                    if (g_motion_tick < g_motion_ticks_count && synchro > first_missed_period) {
+                        uint32_t missed_ticks = (uint32_t)(synchro - first_missed_period);
+                        g_missed_ticks_count += missed_ticks;
+                        shift_motion_time(missed_ticks);
+                    }
                 }
                 prev_synchro_value = synchro;
                 g_core_state = STATE_CALC;
             }
+#if MOTION_CORE_BAKED_SCHEDULE_ENABLE
+            else if (g_baked_motion != NULL && g_baked_motion->baked_rows_count < g_baked_motion->rows_count) {
+                // Use idle time for bake rows ahead of motion time
+                if (baked_schedule_bake_next_row() == false) {
+                    sysmon_set_error(SYSMON_MATH_ERROR);
+                    sysmon_disable_module(SYSMON_MODULE_MOTION_DRIVER);
+                }
+            }
+#endif
             break;
 
         case STATE_CALC:
-            if (g_motion_config.motion_time >= g_motion_config.time_stop) {
+            if (g_motion_tick >= g_motion_ticks_count || synchro < g_motion_start_period) {
+                
+                // Body pose can be changed without motion or while motion waits scheduled start
+                uint32_t changed_limbs_mask = 0;
+                if (body_pose_process() == true) {
+                    if (calculate_limbs_angles(&g_limbs, body_pose_get_transform(), 0, &changed_limbs_mask) == false) {
+                        sysmon_set_error(SYSMON_MATH_ERROR);
+                        sysmon_disable_module(SYSMON_MODULE_MOTION_DRIVER);
+                        break;
+                    }
+                    update_clamps_counters(&g_limbs, g_clamps_count);
+                    load_servo_angles(changed_limbs_mask);
+                }
+                update_ik_statistic(changed_limbs_mask);
                 g_core_state = STATE_SYNC;
                 break;
             }
-            
-            // Calculate new limbs positions
-            scaled_motion_time = (float)g_motion_config.motion_time / (float)MTIME_SCALE; // to [0; 1]
-            if (process_linear_trajectory(scaled_motion_time) == false) {
-                sysmon_set_error(SYSMON_MATH_ERROR);
-                sysmon_disable_module(SYSMON_MODULE_MOTION_DRIVER);
-                break;
+            if (g_motion_start_period != 0) {
+                // Scheduled start lateness on first tick. Missed ticks are caught up, they are not late
+                g_start_late_periods = (uint32_t)(synchro - g_motion_start_period) - g_motion_tick;
+                is_start_late_measured = true;
+                g_motion_start_period = 0;
             }
-            if (process_advanced_trajectory(scaled_motion_time) == false) {
-                sysmon_set_error(SYSMON_MATH_ERROR);
-                sysmon_disable_module(SYSMON_MODULE_MOTION_DRIVER);
-                break;
+            body_pose_process();
+            
+#if MOTION_CORE_BAKED_SCHEDULE_ENABLE
+            // Baked rows are calculated without body pose
+            if (g_baked_motion != NULL && body_pose_get_transform()->is_identity == true) {
+                
+                // Tick between rows is interpolated by next row. Bake rows now if idle time was 
+                // not enough and they fit to catch up budget, else calculate tick live
+                uint32_t row = baked_schedule_find_row();
+                uint32_t required_rows_count = (g_baked_row_ticks[g_baked_motion->first_row + row] == g_motion_tick) ? row + 1 : row + 2;
+                if (required_rows_count <= g_baked_motion->baked_rows_count + MOTION_CORE_BAKED_SCHEDULE_CATCH_UP_ROWS) {
+                    while (g_baked_motion->baked_rows_count < required_rows_count) {
+                        if (baked_schedule_bake_next_row() == false) {
+                            sysmon_set_error(SYSMON_MATH_ERROR);
+                            sysmon_disable_module(SYSMON_MODULE_MOTION_DRIVER);
+                            return;
+                        }
+                    }
+                    baked_schedule_replay_tick();
+                    ++g_baked_replay_ticks_count;
+                    g_core_state = STATE_TIME_SHIFT;
+                    break;
+                }
+                
+                // Limbs positions are not calculated while replay - restore them for live tick
+                sync_limbs_positions();
+                ++g_baked_live_ticks_count;
             }
+#endif
             
-            // Calculate servo angles
-            if (kinematic_calculate_angles() == false) {
+            // Calculate new limbs positions and servo angles
+            uint32_t changed_limbs_mask = 0;
+            if (process_motion_tick(g_motion_tick, &g_limbs, &g_adv_trajectory_state, body_pose_get_transform(), &changed_limbs_mask) == false) {
                 sysmon_set_error(SYSMON_MATH_ERROR);
                 sysmon_disable_module(SYSMON_MODULE_MOTION_DRIVER);
                 break;
             }
-            
-            // Load new angles to servo driver
-            for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
-                servo_driver_move(i * 3 + 0, g_limbs_list[i].coxa.angle);
-                servo_driver_move(i * 3 + 1, g_limbs_list[i].femur.angle);
-                servo_driver_move(i * 3 + 2, g_limbs_list[i].tibia.angle);
-            }
+            update_clamps_counters(&g_limbs, g_clamps_count);
+            update_ik_statistic(changed_limbs_mask & ~g_joint_ctx.limbs_mask);
+            load_servo_angles(changed_limbs_mask);
+            update_command_latency();
 
             g_core_state = STATE_TIME_SHIFT;
             break;
 
         case STATE_TIME_SHIFT:
-            g_motion_config.motion_time += g_motion_config.time_step;
-            if (g_motion_config.motion_time == g_motion_config.time_update) {
-                g_current_trajectory_config = g_next_trajectory_config;
-            }
+            shift_motion_time(1);
             g_core_state = STATE_SYNC;
             break;
 
@@ -225,292 +507,1735 @@ void motion_core_process(void) {
 /// @return true - motion completed, false - motion in progress
 //  ***************************************************************************
 bool motion_core_is_motion_complete(void) {
-    return g_motion_config.motion_time >= g_motion_config.time_stop;
+    return g_motion_tick >= g_motion_ticks_count;
 }
 
-
-
-
-
 //  ***************************************************************************
-/// @brief  Read configuration
-/// @param  none
-/// @return true - read success, false - fail
+/// @brief  Check limb is lifted by current motion
+/// @note   Limb height is found by trajectory and motion time of last
+///         calculated tick. Lift trajectories are on ground on first and
+///         last ticks, gait trajectory - while leg is in stance
+/// @param  limb: limb index
+/// @return true - limb is in air, false - limb is on ground
 //  ***************************************************************************
-static bool read_configuration(void) {
-    
-    uint32_t base_address = MM_LIMB_CONFIG_BASE_EE_ADDRESS;
-    
-    // Read length
-    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
-        if (config_read_16(base_address + MM_LIMB_COXA_LENGTH_OFFSET,  &g_limbs_list[i].coxa.length) == false) return false;
-        if (config_read_16(base_address + MM_LIMB_FEMUR_LENGTH_OFFSET, &g_limbs_list[i].femur.length) == false) return false;
-        if (config_read_16(base_address + MM_LIMB_TIBIA_LENGTH_OFFSET, &g_limbs_list[i].tibia.length) == false) return false;
-    }
+bool motion_core_is_limb_lifted(uint32_t limb) {
     
-    // Read zero rotate
-    //int16_t femur_zero_rotate_femur = 35;
-    //int16_t tibia_zero_rotate_femur = 135;
-    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
-        if (config_read_16(base_address + MM_LIMB_COXA_ZERO_ROTATE_OFFSET + i * sizeof(uint16_t), (uint16_t*)&g_limbs_list[i].coxa.zero_rotate) == false) return false;
-        if (config_read_16(base_address + MM_LIMB_FEMUR_ZERO_ROTATE_OFFSET, (uint16_t*)&g_limbs_list[i].femur.zero_rotate) == false ) return false;
-        if (config_read_16(base_address + MM_LIMB_TIBIA_ZERO_ROTATE_OFFSET, (uint16_t*)&g_limbs_list[i].tibia.zero_rotate) == false ) return false;
-        if (abs(g_limbs_list[i].coxa.zero_rotate) > 360 || abs(g_limbs_list[i].femur.zero_rotate) > 360 || abs(g_limbs_list[i].tibia.zero_rotate) > 360) {
+    trajectory_t trajectory = g_motion_config.trajectories[limb];
+    if (trajectory == TRAJECTORY_XZ_ADV_Y_GAIT) {
+        if (g_gait_params == NULL) {
             return false;
         }
+        float phase = (g_motion_tick > 0) ? get_gait_phase(g_motion_tick - 1) : g_motion_time_begin / (float)MTIME_SCALE;
+        float arc_position = 0;
+        float height = 0;
+        gait_generator_calculate_leg(g_gait_params, limb, phase, &arc_position, &height);
+        return height > 0;
     }
     
-    // Read protection
-    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
-        if (config_read_16(base_address + MM_LIMB_PROTECTION_COXA_MIN_ANGLE_OFFSET,  (uint16_t*)&g_limbs_list[i].coxa.prot_min_angle)  == false ) return false;
-        if (config_read_16(base_address + MM_LIMB_PROTECTION_COXA_MAX_ANGLE_OFFSET,  (uint16_t*)&g_limbs_list[i].coxa.prot_max_angle)  == false ) return false;
-        if (config_read_16(base_address + MM_LIMB_PROTECTION_FEMUR_MIN_ANGLE_OFFSET, (uint16_t*)&g_limbs_list[i].femur.prot_min_angle) == false ) return false;
-        if (config_read_16(base_address + MM_LIMB_PROTECTION_FEMUR_MAX_ANGLE_OFFSET, (uint16_t*)&g_limbs_list[i].femur.prot_max_angle) == false ) return false;
-        if (config_read_16(base_address + MM_LIMB_PROTECTION_TIBIA_MIN_ANGLE_OFFSET, (uint16_t*)&g_limbs_list[i].tibia.prot_min_angle) == false ) return false;
-        if (config_read_16(base_address + MM_LIMB_PROTECTION_TIBIA_MAX_ANGLE_OFFSET, (uint16_t*)&g_limbs_list[i].tibia.prot_max_angle) == false ) return false;
-        if (g_limbs_list[i].coxa.prot_min_angle  >= g_limbs_list[i].coxa.prot_max_angle  || 
-            g_limbs_list[i].femur.prot_min_angle >= g_limbs_list[i].femur.prot_max_angle || 
-            g_limbs_list[i].tibia.prot_min_angle >= g_limbs_list[i].tibia.prot_max_angle) {
-            return false;
-        }
-    }
-
-    return true;
+    bool is_lift_trajectory = (trajectory == TRAJECTORY_XYZ_LINEAR_LIFT || trajectory == TRAJECTORY_XZ_ADV_Y_SINUS);
+    return is_lift_trajectory && g_motion_tick > 1 && g_motion_tick < g_motion_ticks_count;
 }
 
-#define M_PI                                (3.14159265f)
-#define RAD_TO_DEG(rad)                     ((rad) * 180.0f / M_PI)
-#define DEG_TO_RAD(deg)                     ((deg) * M_PI / 180.0f)
-
-
 //  ***************************************************************************
-/// @brief  Process linear trajectory
-/// @param  motion_time: current motion time [0; 1]
-/// @retval modify g_limbs_list
-/// @return true - calculation success, false - no
+/// @brief  Get periods while any limb of mask is lifted from next motion tick
+/// @note   Limbs which are on ground now can be lifted on next ticks, it is
+///         used for plan preemption ahead. Gait limbs are on ground together
+///         from next tick or from landing of one of them (looped walk 
+///         continues cycle in next motion), landing ticks are checked
+/// @param  limbs_mask: limbs mask
+/// @return PWM periods to landing of all limbs. 0 - limbs are on ground on next tick
 //  ***************************************************************************
-static bool process_linear_trajectory(float motion_time) {
+uint32_t motion_core_get_ground_periods(uint32_t limbs_mask) {
+    
+    if (g_motion_tick >= g_motion_ticks_count) {
+        return 0;
+    }
     
+    uint32_t gait_limbs_mask = 0;
+    uint32_t periods = 0;
     for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
-        
-        // Skip limbs which not use linear trajectory
-        if (g_motion_config.trajectories[i] != TRAJECTORY_XYZ_LINEAR) {
+        if ((limbs_mask & (0x01 << i)) == 0) {
             continue;
         }
-      
-        // Inversion motion time if need
-        float relative_motion_time = motion_time;
-        if (g_motion_config.time_directions[i] == TIME_DIR_REVERSE) {
-            relative_motion_time = 1.0f - relative_motion_time;
+        
+        // Lift trajectories are on ground on first and last ticks
+        trajectory_t trajectory = g_motion_config.trajectories[i];
+        bool is_lift_trajectory = (trajectory == TRAJECTORY_XYZ_LINEAR_LIFT || trajectory == TRAJECTORY_XZ_ADV_Y_SINUS);
+        if (trajectory == TRAJECTORY_XZ_ADV_Y_GAIT && g_gait_params != NULL) {
+            gait_limbs_mask |= (0x01 << i);
+        }
+        else if (is_lift_trajectory && g_motion_tick >= 1 && g_motion_tick + 1 < g_motion_ticks_count && g_motion_ticks_count - 1 - g_motion_tick > periods) {
+            periods = g_motion_ticks_count - 1 - g_motion_tick;
         }
+    }
+    if (gait_limbs_mask == 0) {
+        return periods;
+    }
+    
+    // Candidate ticks: next tick and landing tick of each limb (and tick after it for rounding error)
+    float phase = g_motion_time_begin / (float)MTIME_SCALE + (g_motion_tick + 1) * g_motion_time_step / (float)MTIME_SCALE;
+    uint32_t cycle_ticks = (uint32_t)ceilf((float)MTIME_SCALE / g_motion_time_step);
+    uint32_t ground_ticks = cycle_ticks;
+    for (int32_t c = -1; c < SUPPORT_LIMBS_COUNT * 2; ++c) {
         
-        float x0 = g_motion_config.start_positions[i].x;
-        float y0 = g_motion_config.start_positions[i].y;
-        float z0 = g_motion_config.start_positions[i].z;
-        float x1 = g_motion_config.dest_positions[i].x;
-        float y1 = g_motion_config.dest_positions[i].y;
-        float z1 = g_motion_config.dest_positions[i].z;
+        uint32_t ticks = 0;
+        if (c >= 0) {
+            if ((gait_limbs_mask & (0x01 << (c / 2))) == 0) {
+                continue;
+            }
+            float landing_phase = 1.0f - g_gait_params->phase_offsets[c / 2] - phase;
+            landing_phase -= floorf(landing_phase);
+            ticks = (uint32_t)ceilf(landing_phase * (float)MTIME_SCALE / g_motion_time_step) + (c & 0x01);
+        }
+        if (ticks >= ground_ticks) {
+            continue;
+        }
         
-        g_limbs_list[i].position.x = x0 + relative_motion_time * (x1 - x0);
-        g_limbs_list[i].position.y = y0 + relative_motion_time * (y1 - y0);
-        g_limbs_list[i].position.z = z0 + relative_motion_time * (z1 - z0);
+        float tick_phase = phase + ticks * g_motion_time_step / (float)MTIME_SCALE;
+        tick_phase -= floorf(tick_phase);
+        bool is_ground = true;
+        for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT && is_ground == true; ++i) {
+            float arc_position = 0;
+            float height = 0;
+            if (gait_limbs_mask & (0x01 << i)) {
+                gait_generator_calculate_leg(g_gait_params, i, tick_phase, &arc_position, &height);
+                is_ground = (height <= 0);
+            }
+        }
+        if (is_ground == true) {
+            ground_ticks = ticks;
+        }
     }
     
-    return true;
+    // Lifted limbs are checked on last calculated tick: preemption is possible on period after landing tick
+    if (ground_ticks != 0 && ground_ticks + 1 > periods) {
+        periods = ground_ticks + 1;
+    }
+    return periods;
 }
 
 //  ***************************************************************************
-/// @brief  Process advanced trajectory
-/// @param  motion_time: current motion time [0; 1]
-/// @retval modify g_limbs_list
-/// @return true - calculation success, false - no
+/// @brief  Get periods to current motion completion
+/// @note   Wait of scheduled start is included
+/// @param  none
+/// @return PWM periods
 //  ***************************************************************************
-static bool process_advanced_trajectory(float motion_time) {
+uint32_t motion_core_get_remaining_periods(void) {
     
-    // Check need process advanced trajectory
-    bool is_need_process = false;
-    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
-        if (g_motion_config.trajectories[i] == TRAJECTORY_XZ_ADV_Y_CONST || 
-            g_motion_config.trajectories[i] == TRAJECTORY_XZ_ADV_Y_SINUS) {
-            is_need_process = true;
-            break;
+    uint32_t periods = g_motion_ticks_count - g_motion_tick;
+    if (periods != 0 && g_motion_start_period > synchro) {
+        periods += (uint32_t)(g_motion_start_period - synchro);
+    }
+    return periods;
+}
+
+//  ***************************************************************************
+/// @brief  Get duration of motion if it started now
+/// @note   Current speed multiplier is used. Preemptive motion time step is
+///         limited same as motion_core_preempt_motion(). Limited time step
+///         is integer and limbs can move away from destination positions
+///         while preemption is waited, so next lower time step is used:
+///         estimate is not less real duration
+/// @param  motion_config: motion configuration. @ref motion_config_t
+/// @param  is_preempt: motion interrupts current motion
+/// @return PWM periods
+//  ***************************************************************************
+uint32_t motion_core_get_motion_periods(const motion_config_t* motion_config, bool is_preempt) {
+    
+    int32_t time_step = motion_config->time_step;
+    if (is_preempt == true) {
+        sync_limbs_positions(); // Limbs positions are not calculated while baked schedule replay
+        time_step = get_blend_time_step(motion_config);
+        if (time_step < motion_config->time_step && time_step > 1) {
+            time_step -= 1;
         }
     }
-    if (is_need_process == false) {
-        return true;
+    float motion_time_step = (float)time_step * g_speed_multiplier * get_frame_time_scale();
+    if (motion_time_step <= 0 || motion_config->time_stop <= motion_config->motion_time) {
+        return 0;
     }
-    
-    // Check curvature value
-    float curvature = 0;
-    if (g_current_trajectory_config.curvature == 0)         curvature = +0.001f;
-    else if (g_current_trajectory_config.curvature > 1999)  curvature = +1.999f;
-    else if (g_current_trajectory_config.curvature < -1999) curvature = -1.999f;
-    else                                                    curvature = (float)g_current_trajectory_config.curvature / 1000.0f;
-    
-    //
-    // Calculate XZ
-    //
-    float distance = (float)g_current_trajectory_config.distance;
+    return (uint32_t)ceilf((float)(motion_config->time_stop - motion_config->motion_time) / motion_time_step);
+}
 
-    // Calculation radius of curvature
-    float curvature_radius = tanf((2.0f - curvature) * M_PI / 4.0f) * distance;
+//  ***************************************************************************
+/// @brief  Schedule start of next started motion
+/// @note   First tick of motion waits start period. Start offset is carried
+///         to motion clock, so motion starts at start time with sub-period
+///         accuracy. Zero start period cancels schedule and wait of current
+///         motion
+/// @param  start_period: PWM period of first motion tick (synchro)
+/// @param  start_offset: part of PWM period elapsed from start time on start period [0; 1)
+/// @return none
+//  ***************************************************************************
+void motion_core_schedule_start(uint64_t start_period, float start_offset) {
+    
+    g_start_period = start_period;
+    g_start_offset = start_offset;
+    if (start_period == 0) {
+        g_motion_start_period = 0;
+    }
+}
 
-    // Common calculations
-    float trajectory_radius[SUPPORT_LIMBS_COUNT] = {0};
-    float start_angle_rad[SUPPORT_LIMBS_COUNT] = {0};
-    float max_trajectory_radius = 0;
-    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
-        
-        // Skip limbs which not use advanced trajectory
-        if (g_motion_config.trajectories[i] != TRAJECTORY_XZ_ADV_Y_CONST && 
-            g_motion_config.trajectories[i] != TRAJECTORY_XZ_ADV_Y_SINUS) {
-            continue;
-        }
+//  ***************************************************************************
+/// @brief  Check scheduled start is not happened yet
+/// @param  none
+/// @return true - next motion is scheduled or current motion waits start, false - no
+//  ***************************************************************************
+bool motion_core_is_start_scheduled(void) {
+    return g_start_period != 0 || g_motion_start_period != 0;
+}
 
-        // Save start point to separate variables for short code
-        float x0 = g_motion_config.start_positions[i].x;
-        float z0 = g_motion_config.start_positions[i].z;
+//  ***************************************************************************
+/// @brief  Get lateness of last scheduled start
+/// @note   Lateness is measured on first tick of motion and returned once
+/// @param  late_periods: first tick delay from start period, [PWM periods]
+/// @retval late_periods
+/// @return true - lateness is measured, false - no new measure
+//  ***************************************************************************
+bool motion_core_get_start_late(uint32_t* late_periods) {
+    
+    if (is_start_late_measured == false) {
+        return false;
+    }
+    *late_periods = g_start_late_periods;
+    is_start_late_measured = false;
+    return true;
+}
 
-        // Calculation trajectory radius
-        trajectory_radius[i] = sqrtf((curvature_radius - x0) * (curvature_radius - x0) + z0 * z0);
+//  ***************************************************************************
+/// @brief  Set motion speed multiplier
+/// @note   Multiplier is applied from next motion start
+/// @param  multiplier: speed multiplier [MOTION_CORE_SPEED_MIN; MOTION_CORE_SPEED_MAX]
+/// @return none
+//  ***************************************************************************
+void motion_core_set_speed_multiplier(float multiplier) {
+    if (multiplier < MOTION_CORE_SPEED_MIN) multiplier = MOTION_CORE_SPEED_MIN;
+    if (multiplier > MOTION_CORE_SPEED_MAX) multiplier = MOTION_CORE_SPEED_MAX;
+    g_speed_multiplier = multiplier;
+}
 
-        // Search max trajectory radius
-        if (trajectory_radius[i] > max_trajectory_radius) {
-            max_trajectory_radius = trajectory_radius[i];
-        }
+//  ***************************************************************************
+/// @brief  Get motion speed multiplier
+/// @param  none
+/// @return speed multiplier
+//  ***************************************************************************
+float motion_core_get_speed_multiplier(void) {
+    return g_speed_multiplier;
+}
 
-        // Calculation limb start angle
-        start_angle_rad[i] = atan2f(z0, -(curvature_radius - x0));
-    }
-    if (max_trajectory_radius == 0) {
-        return false; // Avoid division by zero
+//  ***************************************************************************
+/// @brief  Set gait parameters for TRAJECTORY_XZ_ADV_Y_GAIT
+/// @note   Call before start motions of new generated sequence
+/// @param  params: gait parameters. @ref gait_params_t
+/// @return none
+//  ***************************************************************************
+void motion_core_set_gait_params(const struct gait_params_s* params) {
+    g_gait_params = params;
+    
+#if MOTION_CORE_BAKED_SCHEDULE_ENABLE
+    // Generated motions are placed to same memory - drop all baked motions
+    for (uint32_t i = 0; i < MOTION_CORE_BAKED_SCHEDULE_MAX_MOTIONS; ++i) {
+        g_baked_motions[i].rows_count = 0;
     }
+    g_baked_rows_used = 0;
+#endif
+}
 
-    // Calculation max angle of arc
-    int32_t curvature_radius_sign = (curvature_radius >= 0) ? 1 : -1;
-    float max_arc_angle = curvature_radius_sign * distance / max_trajectory_radius;
-
-    // Calculation points by time
+//  ***************************************************************************
+/// @brief  Calculate arc geometry of advanced trajectory for all limbs
+/// @param  start_positions: limbs positions in middle of arc
+/// @param  curvature: curvature (parameter of trajectory)
+/// @param  distance: distance (parameter of trajectory)
+/// @param  curvature_radius: radius of curvature
+/// @param  trajectory_radius: limbs trajectory radius list
+/// @param  start_angle_rad: limbs arc angle in middle of arc list
+/// @param  max_arc_angle: arc angle for step
+/// @retval curvature_radius, trajectory_radius, start_angle_rad, max_arc_angle
+/// @return true - calculation success, false - no
+//  ***************************************************************************
+bool motion_core_calculate_arc_geometry(const point_3d_t* start_positions, int32_t curvature, int32_t distance, 
+                                        float* curvature_radius, float* trajectory_radius, float* start_angle_rad, float* max_arc_angle) {
+    
+    adv_trajectory_context_t ctx;
+    if (calculate_arc_geometry(start_positions, (1u << SUPPORT_LIMBS_COUNT) - 1, curvature, distance, &ctx) == false) {
+        return false;
+    }
+    
+    *curvature_radius = ctx.curvature_radius;
+    *max_arc_angle = ctx.max_arc_angle;
     for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
-        
-        // Skip limbs which not use advanced trajectory
-        if (g_motion_config.trajectories[i] != TRAJECTORY_XZ_ADV_Y_CONST && 
-            g_motion_config.trajectories[i] != TRAJECTORY_XZ_ADV_Y_SINUS) {
-            continue;
-        }
-        
-        // Inversion motion time if need
-        float relative_motion_time = motion_time;
-        if (g_motion_config.time_directions[i] == TIME_DIR_REVERSE) {
-            relative_motion_time = 1.0f - relative_motion_time;
-        }
+        trajectory_radius[i] = ctx.trajectory_radius[i];
+        start_angle_rad[i] = ctx.start_angle_rad[i];
+    }
+    return true;
+}
 
-        // Calculation arc angle for current time
-        float arc_angle_rad = (relative_motion_time - 0.5f) * max_arc_angle + start_angle_rad[i];
+//  ***************************************************************************
+/// @brief  Check limb position is attainable
+/// @note   Used for validation of uploaded sequences. Body pose is not applied
+/// @param  limb: limb index
+/// @param  position: limb position
+/// @return true - position is inside reachability envelope and joints angles
+///         are inside protection limits, false - otherwise
+//  ***************************************************************************
+bool motion_core_check_position(uint32_t limb, const point_3d_t* position) {
+    
+    if (sysmon_is_module_disable(SYSMON_MODULE_MOTION_DRIVER) == true || limb >= SUPPORT_LIMBS_COUNT) {
+        return false;
+    }
+    
+    kinematic_result_t result;
+    if (kinematic_calculate_angles(&g_limbs_geometry[limb], position, &result) == false) {
+        return false;
+    }
+    return result.is_position_clamped == false && result.is_angles_limited == false;
+}
 
-        // Calculation XZ points by time
-        g_limbs_list[i].position.x = curvature_radius + trajectory_radius[i] * cosf(arc_angle_rad);
-        g_limbs_list[i].position.z =                    trajectory_radius[i] * sinf(arc_angle_rad);
-        
-        
+//  ***************************************************************************
+/// @brief  Check linear path of limb is attainable
+/// @note   Path is checked by MOTION_CORE_PATH_CHECK_POINTS points between
+///         start and destination points (them are not checked)
+/// @param  limb: limb index
+/// @param  start: path start point
+/// @param  dest: path destination point
+/// @param  is_lift_used: path is lifted by sinus (TRAJECTORY_XYZ_LINEAR_LIFT)
+/// @return true - all path points are attainable, false - otherwise
+//  ***************************************************************************
+bool motion_core_check_path(uint32_t limb, const point_3d_t* start, const point_3d_t* dest, bool is_lift_used) {
+    
+    for (uint32_t k = 1; k < MOTION_CORE_PATH_CHECK_POINTS; ++k) {
         
-        // Calculation Y points by time
-        if (g_motion_config.trajectories[i] == TRAJECTORY_XZ_ADV_Y_CONST) {
-            g_limbs_list[i].position.y = g_motion_config.start_positions[i].y;
+        float t = (float)k / MOTION_CORE_PATH_CHECK_POINTS;
+        point_3d_t point;
+        point.x = start->x + t * (dest->x - start->x);
+        point.y = start->y + t * (dest->y - start->y);
+        point.z = start->z + t * (dest->z - start->z);
+        if (is_lift_used) {
+            point.y += LIMB_STEP_HEIGHT * sinf(t * M_PI);
         }
-        else if (g_motion_config.trajectories[i] == TRAJECTORY_XZ_ADV_Y_SINUS) {
-            g_limbs_list[i].position.y = g_motion_config.start_positions[i].y;
-            g_limbs_list[i].position.y += LIMB_STEP_HEIGHT * sinf(relative_motion_time * M_PI);  
+        if (motion_core_check_position(limb, &point) == false) {
+            return false;
         }
     }
-    
     return true;
 }
 
 //  ***************************************************************************
-/// @brief  Calculate angles
-/// @param  limbs_list: @ref limb_t
-/// @retval limbs_list::servo_angle
-/// @return true - calculation success, false - no
+/// @brief  Process CLI command
+/// @param  cmd: command string
+/// @param  argv: argument list
+/// @param  argc: arguments count
+/// @param  response: response
+/// @retval response
+/// @return true - success, false - fail
 //  ***************************************************************************
-static bool kinematic_calculate_angles(void) {
-
-    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
-
-        float coxa_zero_rotate_deg  = g_limbs_list[i].coxa.zero_rotate;
-        float femur_zero_rotate_deg = g_limbs_list[i].femur.zero_rotate;
-        float tibia_zero_rotate_deg = g_limbs_list[i].tibia.zero_rotate;
-        float coxa_length  = g_limbs_list[i].coxa.length;
-        float femur_length = g_limbs_list[i].femur.length;
-        float tibia_length = g_limbs_list[i].tibia.length;
-
-        float x = g_limbs_list[i].position.x;
-        float y = g_limbs_list[i].position.y;
-        float z = g_limbs_list[i].position.z;
-
-
-        // Move to (X*, Y*, Z*) coordinate system - rotate
-        float coxa_zero_rotate_rad = DEG_TO_RAD(coxa_zero_rotate_deg);
-        float x1 = x * cosf(coxa_zero_rotate_rad) + z * sinf(coxa_zero_rotate_rad);
-        float y1 = y;
-        float z1 = -x * sinf(coxa_zero_rotate_rad) + z * cosf(coxa_zero_rotate_rad);
-
-
-        //
-        // Calculate COXA angle
-        //
-        float coxa_angle_rad = atan2f(z1, x1);
-        g_limbs_list[i].coxa.angle = RAD_TO_DEG(coxa_angle_rad);
-
-
-        //
-        // Prepare for calculation FEMUR and TIBIA angles
-        //
-        // Move to (X*, Y*) coordinate system (rotate on axis Y)
-        x1 = x1 * cosf(coxa_angle_rad) + z1 * sinf(coxa_angle_rad);
-
-        // Move to (X**, Y**) coordinate system (remove coxa from calculations)
-        x1 = x1 - coxa_length;
-
-        // Calculate angle between axis X and destination point
-        float fi = atan2f(y1, x1);
-
-        // Calculate distance to destination point
-        float d = sqrt(x1 * x1 + y1 * y1);
-        if (d > femur_length + tibia_length) {
-            return false; // Point not attainable
+bool motion_core_cli_command_process(const char* cmd, const char (*argv)[CLI_ARG_MAX_SIZE], uint32_t argc, char* response) {
+    
+    if (strcmp(cmd, "status") == 0 && argc == 0) {
+        sprintf(response, CLI_OK("motion status report")
+                          CLI_OK("    - speed: %ld %%")
+                          CLI_OK("    - motion tick: %lu/%lu")
+                          CLI_OK("    - missed ticks: %lu")
+                          CLI_OK("    - preempted motions: %lu")
+                          CLI_OK("    - hot trajectory updates: %lu")
+                          CLI_OK("    - command latency: %lu ms (max %lu ms)")
+                          CLI_OK("    - IK limbs per second: %lu")
+                          CLI_OK("    - linear cycles: %lu max")
+                          CLI_OK("    - baked ticks: %lu replayed, %lu live"),
+                (int32_t)(g_speed_multiplier * 100.0f), g_motion_tick, g_motion_ticks_count, g_missed_ticks_count,
+                g_preempt_count, g_hot_update_count, g_last_latency, g_max_latency, g_ik_limbs_per_second, g_linear_max_cycles,
+                g_baked_replay_ticks_count, g_baked_live_ticks_count);
+    }
+    else if (strcmp(cmd, "reach") == 0 && argc == 0) {
+        sprintf(response, CLI_OK("reachability envelope report"));
+        for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+            sprintf(response + strlen(response), CLI_OK("    - limb %lu: [%ld; %ld] mm, clamps %lu"), i,
+                    (int32_t)g_limbs_geometry[i].ik.min_reach, (int32_t)g_limbs_geometry[i].ik.max_reach, g_clamps_count[i]);
         }
+    }
+    else if (strcmp(cmd, "set-speed") == 0 && argc == 1) {
+        motion_core_set_speed_multiplier((float)atoi(argv[0]) / 100.0f);
+        sprintf(response, CLI_OK("speed is %ld %%"), (int32_t)(g_speed_multiplier * 100.0f));
+    }
+    else {
+        strcpy(response, CLI_ERROR("Unknown command or format for motion"));
+        return false;
+    }
+    return true;
+}
 
 
-        //
-        // Calculate triangle angles
-        //
-        float a = tibia_length;
-        float b = femur_length;
-        float c = d;
 
-        float alpha = acosf( (b * b + c * c - a * a) / (2.0f * b * c) );
-        float gamma = acosf( (a * a + b * b - c * c) / (2.0f * a * b) );
 
 
-        //
-        // Calculate FEMUR and TIBIA angle
-        //
-        g_limbs_list[i].femur.angle = femur_zero_rotate_deg - RAD_TO_DEG(alpha) - RAD_TO_DEG(fi);
-        g_limbs_list[i].tibia.angle = RAD_TO_DEG(gamma) - tibia_zero_rotate_deg;
-        
-        //
-        // Protection
-        //
-        if (g_limbs_list[i].coxa.angle < g_limbs_list[i].coxa.prot_min_angle)   g_limbs_list[i].coxa.angle = g_limbs_list[i].coxa.prot_min_angle;
-        if (g_limbs_list[i].coxa.angle > g_limbs_list[i].coxa.prot_max_angle)   g_limbs_list[i].coxa.angle = g_limbs_list[i].coxa.prot_max_angle;
-        if (g_limbs_list[i].femur.angle < g_limbs_list[i].femur.prot_min_angle) g_limbs_list[i].femur.angle = g_limbs_list[i].femur.prot_min_angle;
-        if (g_limbs_list[i].femur.angle > g_limbs_list[i].femur.prot_max_angle) g_limbs_list[i].femur.angle = g_limbs_list[i].femur.prot_max_angle;
-        if (g_limbs_list[i].tibia.angle < g_limbs_list[i].tibia.prot_min_angle) g_limbs_list[i].tibia.angle = g_limbs_list[i].tibia.prot_min_angle;
-        if (g_limbs_list[i].tibia.angle > g_limbs_list[i].tibia.prot_max_angle) g_limbs_list[i].tibia.angle = g_limbs_list[i].tibia.prot_max_angle;
+//  ***************************************************************************
+/// @brief  Read configuration
+/// @param  none
+/// @return true - read success, false - fail
+//  ***************************************************************************
+static bool read_configuration(void) {
+    
+    uint32_t base_address = MM_LIMB_CONFIG_BASE_EE_ADDRESS;
+    
+    // Read length
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        if (read_limb_parameter(base_address + MM_LIMB_COXA_LENGTH_OFFSET,  ROBOT_DEFAULT_COXA_LENGTH,  &g_limbs_geometry[i].coxa.length)  == false) return false;
+        if (read_limb_parameter(base_address + MM_LIMB_FEMUR_LENGTH_OFFSET, ROBOT_DEFAULT_FEMUR_LENGTH, &g_limbs_geometry[i].femur.length) == false) return false;
+        if (read_limb_parameter(base_address + MM_LIMB_TIBIA_LENGTH_OFFSET, ROBOT_DEFAULT_TIBIA_LENGTH, &g_limbs_geometry[i].tibia.length) == false) return false;
     }
-    return true;
-}
+    
+    // Read zero rotate
+    static const int16_t default_coxa_zero_rotate[SUPPORT_LIMBS_COUNT] = ROBOT_DEFAULT_COXA_ZERO_ROTATE;
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        if (read_limb_parameter(base_address + MM_LIMB_COXA_ZERO_ROTATE_OFFSET + i * sizeof(uint16_t), default_coxa_zero_rotate[i], (uint16_t*)&g_limbs_geometry[i].coxa.zero_rotate) == false) return false;
+        if (read_limb_parameter(base_address + MM_LIMB_FEMUR_ZERO_ROTATE_OFFSET, ROBOT_DEFAULT_FEMUR_ZERO_ROTATE, (uint16_t*)&g_limbs_geometry[i].femur.zero_rotate) == false ) return false;
+        if (read_limb_parameter(base_address + MM_LIMB_TIBIA_ZERO_ROTATE_OFFSET, ROBOT_DEFAULT_TIBIA_ZERO_ROTATE, (uint16_t*)&g_limbs_geometry[i].tibia.zero_rotate) == false ) return false;
+        if (abs(g_limbs_geometry[i].coxa.zero_rotate) > 360 || abs(g_limbs_geometry[i].femur.zero_rotate) > 360 || abs(g_limbs_geometry[i].tibia.zero_rotate) > 360) {
+            return false;
+        }
+    }
+    
+    // Read protection
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        if (config_read_16(base_address + MM_LIMB_PROTECTION_COXA_MIN_ANGLE_OFFSET,  (uint16_t*)&g_limbs_geometry[i].coxa.prot_min_angle)  == false ) return false;
+        if (config_read_16(base_address + MM_LIMB_PROTECTION_COXA_MAX_ANGLE_OFFSET,  (uint16_t*)&g_limbs_geometry[i].coxa.prot_max_angle)  == false ) return false;
+        if (config_read_16(base_address + MM_LIMB_PROTECTION_FEMUR_MIN_ANGLE_OFFSET, (uint16_t*)&g_limbs_geometry[i].femur.prot_min_angle) == false ) return false;
+        if (config_read_16(base_address + MM_LIMB_PROTECTION_FEMUR_MAX_ANGLE_OFFSET, (uint16_t*)&g_limbs_geometry[i].femur.prot_max_angle) == false ) return false;
+        if (config_read_16(base_address + MM_LIMB_PROTECTION_TIBIA_MIN_ANGLE_OFFSET, (uint16_t*)&g_limbs_geometry[i].tibia.prot_min_angle) == false ) return false;
+        if (config_read_16(base_address + MM_LIMB_PROTECTION_TIBIA_MAX_ANGLE_OFFSET, (uint16_t*)&g_limbs_geometry[i].tibia.prot_max_angle) == false ) return false;
+        if (g_limbs_geometry[i].coxa.prot_min_angle  >= g_limbs_geometry[i].coxa.prot_max_angle  || 
+            g_limbs_geometry[i].femur.prot_min_angle >= g_limbs_geometry[i].femur.prot_max_angle || 
+            g_limbs_geometry[i].tibia.prot_min_angle >= g_limbs_geometry[i].tibia.prot_max_angle) {
+            return false;
+        }
+    }
+
+    // Precalculate IK constants
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        kinematic_prepare_limb(&g_limbs_geometry[i]);
+    }
+
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Read limb geometry parameter
+/// @note   Default value from robot description is used if EEPROM cell is 
+///         not programmed
+/// @param  address: EEPROM address
+/// @param  default_value: default value
+/// @param  value: parameter value
+/// @retval value
+/// @return true - read success, false - fail
+//  ***************************************************************************
+static bool read_limb_parameter(uint32_t address, int32_t default_value, uint16_t* value) {
+    
+    if (config_read_16(address, value) == false) {
+        return false;
+    }
+    if (*value == 0xFFFF) {
+        *value = (uint16_t)default_value;
+    }
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Load limbs angles to servo driver
+/// @param  changed_limbs_mask: limbs which angles was recalculated by IK
+/// @return none
+//  ***************************************************************************
+static void load_servo_angles(uint32_t changed_limbs_mask) {
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        if ((changed_limbs_mask & (1 << i)) == 0) {
+            continue;
+        }
+        for (uint32_t k = 0; k < ROBOT_JOINTS_PER_LIMB; ++k) {
+            servo_driver_move(ROBOT_SERVO_INDEX(i, k), g_limbs.angles[k][i]);
+        }
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Calculate limbs positions for last processed motion tick
+/// @note   Limbs positions are not calculated while baked schedule replay.
+///         Limbs positions of joint space trajectory are nominal (linear), 
+///         real positions are restored by joints angles
+/// @param  none
+/// @return none
+//  ***************************************************************************
+static void sync_limbs_positions(void) {
+    
+    if (g_joint_ctx.limbs_mask != 0 && g_motion_tick != 0 && g_motion_tick < g_motion_ticks_count) {
+        for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+            if ((g_joint_ctx.limbs_mask & (1 << i)) == 0) {
+                continue;
+            }
+            float angles[ROBOT_JOINTS_PER_LIMB];
+            for (uint32_t k = 0; k < ROBOT_JOINTS_PER_LIMB; ++k) {
+                angles[k] = g_limbs.angles[k][i];
+            }
+            point_3d_t position;
+            kinematic_calculate_position(&g_limbs_geometry[i], angles, &position);
+            body_pose_apply_inverse(&g_joint_ctx.pose, &position.x, &position.y, &position.z, &position.x, &position.y, &position.z, 1);
+            set_limb_position(&g_limbs, i, &position);
+        }
+    }
+    
+#if MOTION_CORE_BAKED_SCHEDULE_ENABLE
+    if (g_baked_motion == NULL || g_motion_tick == 0 || g_motion_tick >= g_motion_ticks_count) {
+        return; // Limbs positions are actual
+    }
+    float motion_time = g_motion_time_begin + (g_motion_tick - 1) * g_motion_time_step;
+    float scaled_motion_time = motion_time / (float)MTIME_SCALE; // to [0; 1]
+    process_linear_trajectory(scaled_motion_time, &g_limbs);
+    process_advanced_trajectory(g_motion_tick - 1, scaled_motion_time, &g_limbs, &g_adv_trajectory_state);
+#endif
+}
+
+//  ***************************************************************************
+/// @brief  Update command latency statistic
+/// @param  none
+/// @return none
+//  ***************************************************************************
+static void update_command_latency(void) {
+    
+    if (g_command_time == 0) {
+        return;
+    }
+    g_last_latency = (uint32_t)(get_time_ms() - g_command_time);
+    if (g_last_latency > g_max_latency) {
+        g_max_latency = g_last_latency;
+    }
+    g_command_time = 0;
+}
+
+//  ***************************************************************************
+/// @brief  Update IK rate statistic
+/// @param  changed_limbs_mask: limbs which angles was recalculated by IK
+/// @return none
+//  ***************************************************************************
+static void update_ik_statistic(uint32_t changed_limbs_mask) {
+    
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        if (changed_limbs_mask & (1 << i)) {
+            ++g_ik_limbs_count;
+        }
+    }
+    
+    uint64_t time = get_time_ms();
+    if (time - g_ik_statistic_time >= 1000) {
+        g_ik_limbs_per_second = g_ik_limbs_count;
+        g_ik_limbs_count = 0;
+        g_ik_statistic_time = time;
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Get motion time scale for current PWM frequency
+/// @note   Motion time steps are set for PWM_FREQUENCY_HZ motion clock
+/// @param  none
+/// @return time step multiplier
+//  ***************************************************************************
+static float get_frame_time_scale(void) {
+    return (float)PWM_FREQUENCY_HZ / (float)pwm_get_frequency();
+}
+
+//  ***************************************************************************
+/// @brief  Get time step of preemptive motion
+/// @note   Time step is limited for limbs speed not more than 
+///         MOTION_CORE_BLEND_MAX_SPEED from current limbs positions
+/// @param  motion_config: motion configuration. @ref motion_config_t
+/// @return motion time step
+//  ***************************************************************************
+static int32_t get_blend_time_step(const motion_config_t* motion_config) {
+    
+    float max_distance = 0;
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        if (motion_config->trajectories[i] == TRAJECTORY_XYZ_HOLD) {
+            continue;
+        }
+        float dx = motion_config->dest_positions[i].x - g_limbs.x[i];
+        float dy = motion_config->dest_positions[i].y - g_limbs.y[i];
+        float dz = motion_config->dest_positions[i].z - g_limbs.z[i];
+        float distance = sqrtf(dx * dx + dy * dy + dz * dz);
+        if (distance > max_distance) {
+            max_distance = distance;
+        }
+    }
+    
+    // Limit is set for limb distance * time step. Speed multiplier is applied to time step on motion start
+    int32_t time_step = motion_config->time_step;
+    float motion_time = (float)(motion_config->time_stop - motion_config->motion_time);
+    float max_step_distance = MOTION_CORE_BLEND_MAX_SPEED * motion_time / g_speed_multiplier;
+    if (max_distance * time_step > max_step_distance) {
+        time_step = (int32_t)(max_step_distance / max_distance);
+        if (time_step < 1) {
+            time_step = 1;
+        }
+    }
+    return time_step;
+}
+
+//  ***************************************************************************
+/// @brief  Get gait cycle phase of limbs positions on motion tick
+/// @note   Motion ends before time_stop, so gait phase is one time step ahead
+///         of motion time: limbs land on last tick of cycle (phase 1) and
+///         next cycle continues from this point without repeated positions
+/// @param  motion_tick: motion tick
+/// @return gait cycle phase [0; 1]
+//  ***************************************************************************
+static float get_gait_phase(uint32_t motion_tick) {
+    float phase = (g_motion_time_begin + (motion_tick + 1) * g_motion_time_step) / (float)MTIME_SCALE;
+    return (phase < 1.0f) ? phase : 1.0f;
+}
+
+//  ***************************************************************************
+/// @brief  Shift motion time
+/// @note   Trajectory configuration is updated when motion time cross time_update
+///         or on any tick for gait trajectory (hot update)
+/// @param  ticks: ticks count
+/// @return none
+//  ***************************************************************************
+static void shift_motion_time(uint32_t ticks) {
+    
+    float time_update = (float)g_motion_config.time_update;
+    float prev_motion_time = g_motion_time_begin + g_motion_tick * g_motion_time_step;
+    
+    g_motion_tick += ticks;
+    if (g_motion_tick > g_motion_ticks_count) {
+        g_motion_tick = g_motion_ticks_count;
+    }
+    
+    float motion_time = g_motion_time_begin + g_motion_tick * g_motion_time_step;
+    bool is_config_changed = g_current_trajectory_config.curvature != g_next_trajectory_config.curvature || 
+                             g_current_trajectory_config.distance != g_next_trajectory_config.distance;
+    bool is_hot_update = is_config_changed && g_adv_trajectory_ctx.is_hot_update && g_motion_tick < g_motion_ticks_count;
+    if ((prev_motion_time < time_update && motion_time >= time_update) || is_hot_update) {
+#if MOTION_CORE_BAKED_SCHEDULE_ENABLE
+        // Baked rows are calculated for current trajectory configuration. Continue motion by live calculation if it changed
+        if (is_config_changed && g_baked_motion != NULL) {
+            sync_limbs_positions();
+            g_baked_motion = NULL;
+        }
+#endif
+        if (is_hot_update) {
+            ++g_hot_update_count;
+        }
+        g_current_trajectory_config = g_next_trajectory_config;
+        build_advanced_trajectory_context();
+    }
+}
+
+
+//  ***************************************************************************
+/// @brief  Calculate limbs positions and angles for motion tick
+/// @param  motion_tick: motion tick [0; g_motion_ticks_count)
+/// @param  limbs: limbs state
+/// @param  state: advanced trajectory incremental state
+/// @param  pose: body pose transform. NULL - no transform
+/// @param  changed_limbs_mask: limbs which angles was recalculated by IK
+/// @retval limbs, changed_limbs_mask
+/// @return true - calculation success, false - no
+//  ***************************************************************************
+static bool process_motion_tick(uint32_t motion_tick, limbs_state_t* limbs, adv_trajectory_state_t* state, const body_pose_transform_t* pose, uint32_t* changed_limbs_mask) {
+    
+    float motion_time = g_motion_time_begin + motion_tick * g_motion_time_step;
+    float scaled_motion_time = motion_time / (float)MTIME_SCALE; // to [0; 1]
+    if (process_linear_trajectory(scaled_motion_time, limbs) == false) {
+        return false;
+    }
+    process_spline_trajectory(scaled_motion_time, limbs);
+    if (process_advanced_trajectory(motion_tick, scaled_motion_time, limbs, state) == false) {
+        return false;
+    }
+    float joint_motion_time = fminf(scaled_motion_time * g_linear_kernel.time_scale, 1.0f); // Same as nominal positions
+    if (process_joint_trajectory(joint_motion_time, limbs, pose) == false) {
+        return false;
+    }
+    return calculate_limbs_angles(limbs, pose, g_joint_ctx.limbs_mask, changed_limbs_mask);
+}
+
+//  ***************************************************************************
+/// @brief  Process linear trajectory
+/// @note   Linear, linear lift and hold trajectories are calculated by batched
+///         kernel from coefficients which packed on motion start
+/// @param  motion_time: current motion time [0; 1]
+/// @param  limbs: limbs state
+/// @retval limbs
+/// @return true - calculation success, false - no
+//  ***************************************************************************
+static bool process_linear_trajectory(float motion_time, limbs_state_t* limbs) {
+    
+    uint32_t begin_cycles = get_cpu_cycles();
+    trajectory_kernel_process_linear(&g_linear_kernel, motion_time, limbs->x, limbs->y, limbs->z);
+    uint32_t cycles = get_cpu_cycles() - begin_cycles;
+    if (cycles > g_linear_max_cycles) {
+        g_linear_max_cycles = cycles;
+    }
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Process spline trajectory
+/// @param  motion_time: current motion time [0; 1]
+/// @param  limbs: limbs state
+/// @retval limbs
+/// @return none
+//  ***************************************************************************
+static void process_spline_trajectory(float motion_time, limbs_state_t* limbs) {
+    
+    if (g_spline_ctx.limbs_mask == 0) {
+        return;
+    }
+    
+    float t = motion_time;
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        
+        // Skip limbs which not use spline trajectory
+        if ((g_spline_ctx.limbs_mask & (0x01 << i)) == 0) {
+            continue;
+        }
+        
+        float p[3];
+        for (uint32_t k = 0; k < 3; ++k) {
+            const float* c = g_spline_ctx.coeffs[i][k];
+            p[k] = c[0] + t * (c[1] + t * (c[2] + t * (c[3] + t * (c[4] + t * c[5]))));
+        }
+        limbs->x[i] = p[0];
+        limbs->y[i] = p[1];
+        limbs->z[i] = p[2];
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Build spline trajectory context
+/// @note   Spline segment is started with end velocity of previous segment 
+///         (if it was spline) and is finished with Catmull-Rom velocity 
+///         (P[next] - P[start]) / (T + T[next]) if next motion is spline, 
+///         otherwise limb stops in destination point. TRAJECTORY_XYZ_SPLINE 
+///         is cubic Hermite spline (C1), TRAJECTORY_XYZ_MIN_JERK is quintic 
+///         Hermite spline with zero acceleration in points (C2, minimum jerk 
+///         for stop-to-stop motion). Time direction is not used
+/// @param  next_motion_config: next motion configuration. NULL - limbs stop
+/// @retval g_spline_ctx, g_motion_config::start_positions
+/// @return none
+//  ***************************************************************************
+static void build_spline_trajectory_context(const motion_config_t* next_motion_config) {
+    
+    spline_trajectory_context_t* ctx = &g_spline_ctx;
+    uint32_t prev_limbs_mask = ctx->limbs_mask;
+    ctx->limbs_mask = 0;
+    if (g_motion_time_step <= 0) {
+        return;
+    }
+    
+    // Motion time [0; 1] duration in PWM periods
+    float unit_ticks = (float)MTIME_SCALE / g_motion_time_step;
+    float next_unit_ticks = 0;
+    if (next_motion_config != NULL && next_motion_config->time_step > 0) {
+        next_unit_ticks = (float)MTIME_SCALE / ((float)next_motion_config->time_step * g_speed_multiplier * get_frame_time_scale());
+    }
+    
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        
+        trajectory_t trajectory = g_motion_config.trajectories[i];
+        if (trajectory != TRAJECTORY_XYZ_SPLINE && trajectory != TRAJECTORY_XYZ_MIN_JERK) {
+            g_spline_start_velocities[i] = (point_3d_t){0};
+            continue;
+        }
+        
+        // Continue previous spline segment from its end point with same velocity
+        point_3d_t v0 = {0};
+        if (prev_limbs_mask & (0x01 << i)) {
+            g_motion_config.start_positions[i] = ctx->end_positions[i];
+            v0 = ctx->end_velocities[i];
+        }
+        
+        // Pass destination point without stop if next motion is spline
+        const point_3d_t* p0 = &g_motion_config.start_positions[i];
+        const point_3d_t* p1 = &g_motion_config.dest_positions[i];
+        point_3d_t v1 = {0};
+        if (next_unit_ticks > 0 && (next_motion_config->trajectories[i] == TRAJECTORY_XYZ_SPLINE || 
+                                    next_motion_config->trajectories[i] == TRAJECTORY_XYZ_MIN_JERK)) {
+            const point_3d_t* p2 = &next_motion_config->dest_positions[i];
+            v1.x = (p2->x - p0->x) / (unit_ticks + next_unit_ticks);
+            v1.y = (p2->y - p0->y) / (unit_ticks + next_unit_ticks);
+            v1.z = (p2->z - p0->z) / (unit_ticks + next_unit_ticks);
+        }
+        
+        // Hermite spline coefficients. Tangents by motion time = velocity * duration
+        const float a[3]  = { p0->x, p0->y, p0->z };
+        const float b[3]  = { p1->x, p1->y, p1->z };
+        const float m0[3] = { v0.x * unit_ticks, v0.y * unit_ticks, v0.z * unit_ticks };
+        const float m1[3] = { v1.x * unit_ticks, v1.y * unit_ticks, v1.z * unit_ticks };
+        for (uint32_t k = 0; k < 3; ++k) {
+            float* c = ctx->coeffs[i][k];
+            float d = b[k] - a[k];
+            c[0] = a[k];
+            c[1] = m0[k];
+            if (trajectory == TRAJECTORY_XYZ_SPLINE) {
+                c[2] = 3.0f * d - 2.0f * m0[k] - m1[k];
+                c[3] = -2.0f * d + m0[k] + m1[k];
+                c[4] = 0;
+                c[5] = 0;
+            }
+            else {
+                c[2] = 0;
+                c[3] = 10.0f * d - 6.0f * m0[k] - 4.0f * m1[k];
+                c[4] = -15.0f * d + 8.0f * m0[k] + 7.0f * m1[k];
+                c[5] = 6.0f * d - 3.0f * m0[k] - 3.0f * m1[k];
+            }
+        }
+        
+        g_spline_start_velocities[i] = v0;
+        ctx->end_positions[i] = *p1;
+        ctx->end_velocities[i] = v1;
+        ctx->limbs_mask |= 0x01 << i;
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Build advanced trajectory context
+/// @note   Everything what depends only on motion configuration and current
+///         trajectory configuration. Call on motion start and config update
+/// @param  none
+/// @retval g_adv_trajectory_ctx
+/// @return true - calculation success, false - no
+//  ***************************************************************************
+static bool build_advanced_trajectory_context(void) {
+    
+    adv_trajectory_context_t* ctx = &g_adv_trajectory_ctx;
+    ctx->is_valid = false;
+    g_adv_trajectory_state.is_seeded = false;
+#if MOTION_CORE_BAKED_SCHEDULE_ENABLE
+    g_baker_adv_trajectory_state.is_seeded = false;
+#endif
+    
+    // Check need process advanced trajectory
+    ctx->limbs_mask = 0;
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        if (g_motion_config.trajectories[i] == TRAJECTORY_XZ_ADV_Y_CONST || 
+            g_motion_config.trajectories[i] == TRAJECTORY_XZ_ADV_Y_SINUS ||
+            g_motion_config.trajectories[i] == TRAJECTORY_XZ_ADV_Y_GAIT) {
+            ctx->limbs_mask |= 0x01 << i;
+        }
+    }
+    ctx->is_hot_update = false;
+    if (ctx->limbs_mask == 0) {
+        ctx->is_valid = true;
+        return true;
+    }
+    
+    if (calculate_arc_geometry(g_motion_config.start_positions, ctx->limbs_mask, g_current_trajectory_config.curvature, 
+                               g_current_trajectory_config.distance, ctx) == false) {
+        return false;
+    }
+    
+    // Gait limbs land on arc start (arc end for reverse time)
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        if (g_motion_config.trajectories[i] == TRAJECTORY_XZ_ADV_Y_GAIT) {
+            float arc_position = (g_motion_config.time_directions[i] == TIME_DIR_REVERSE) ? 0.5f : -0.5f;
+            float arc_angle_rad = arc_position * ctx->max_arc_angle + ctx->start_angle_rad[i];
+            ctx->gait_landing_x[i] = ctx->curvature_radius + ctx->trajectory_radius[i] * cosf(arc_angle_rad);
+            ctx->gait_landing_z[i] =                         ctx->trajectory_radius[i] * sinf(arc_angle_rad);
+            ctx->is_hot_update = true;
+        }
+    }
+    float swing_length = fabsf((float)g_current_trajectory_config.distance);
+    if (swing_length < LIMB_STEP_HEIGHT) {
+        swing_length = LIMB_STEP_HEIGHT; // Limbs should be able return to arc if distance is small
+    }
+    ctx->gait_swing_max_length = MOTION_CORE_SWING_SPEED_FACTOR * swing_length;
+    
+    // Calculation rotations for one time step
+    float time_step = g_motion_time_step / (float)MTIME_SCALE;
+    ctx->arc_step_cos    = cosf(time_step * ctx->max_arc_angle);
+    ctx->arc_step_sin    = sinf(time_step * ctx->max_arc_angle);
+    ctx->height_step_cos = cosf(time_step * M_PI);
+    ctx->height_step_sin = sinf(time_step * M_PI);
+    
+    ctx->is_valid = true;
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Calculate arc geometry of advanced trajectory
+/// @param  start_positions: limbs positions in middle of arc
+/// @param  limbs_mask: limbs which use advanced trajectory
+/// @param  curvature: curvature (parameter of trajectory)
+/// @param  distance: distance (parameter of trajectory)
+/// @param  ctx: trajectory context
+/// @retval ctx::curvature_radius, ctx::trajectory_radius, ctx::start_angle_rad, ctx::max_arc_angle
+/// @return true - calculation success, false - no
+//  ***************************************************************************
+static bool calculate_arc_geometry(const point_3d_t* start_positions, uint32_t limbs_mask, int32_t curvature, int32_t distance, adv_trajectory_context_t* ctx) {
+    
+    // Check curvature value
+    float scaled_curvature = 0;
+    if (curvature == 0)         scaled_curvature = +0.001f;
+    else if (curvature > 1999)  scaled_curvature = +1.999f;
+    else if (curvature < -1999) scaled_curvature = -1.999f;
+    else                        scaled_curvature = (float)curvature / 1000.0f;
+    
+    //
+    // Calculate XZ
+    //
+    float scaled_distance = (float)distance;
+
+    // Calculation radius of curvature
+    ctx->curvature_radius = tanf((2.0f - scaled_curvature) * M_PI / 4.0f) * scaled_distance;
+
+    // Common calculations
+    float max_trajectory_radius = 0;
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        
+        // Skip limbs which not use advanced trajectory
+        if ((limbs_mask & (0x01 << i)) == 0) {
+            continue;
+        }
+
+        // Save start point to separate variables for short code
+        float x0 = start_positions[i].x;
+        float z0 = start_positions[i].z;
+
+        // Calculation trajectory radius
+        ctx->trajectory_radius[i] = sqrtf((ctx->curvature_radius - x0) * (ctx->curvature_radius - x0) + z0 * z0);
+
+        // Search max trajectory radius
+        if (ctx->trajectory_radius[i] > max_trajectory_radius) {
+            max_trajectory_radius = ctx->trajectory_radius[i];
+        }
+
+        // Calculation limb start angle
+        ctx->start_angle_rad[i] = atan2f(z0, -(ctx->curvature_radius - x0));
+    }
+    if (max_trajectory_radius == 0) {
+        return false; // Avoid division by zero
+    }
+
+    // Calculation max angle of arc
+    int32_t curvature_radius_sign = (ctx->curvature_radius >= 0) ? 1 : -1;
+    ctx->max_arc_angle = curvature_radius_sign * scaled_distance / max_trajectory_radius;
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Process advanced trajectory
+/// @note   cos/sin of arc angle are evaluated directly only on first motion
+///         tick (or after time jump). Next ticks rotate previous values by 
+///         precalculated time step rotation
+/// @param  motion_tick: current motion tick
+/// @param  motion_time: current motion time [0; 1]
+/// @param  limbs: limbs state
+/// @param  state: incremental state
+/// @retval limbs
+/// @return true - calculation success, false - no
+//  ***************************************************************************
+static bool process_advanced_trajectory(uint32_t motion_tick, float motion_time, limbs_state_t* limbs, adv_trajectory_state_t* state) {
+    
+    adv_trajectory_context_t* ctx = &g_adv_trajectory_ctx;
+    if (ctx->is_valid == false && build_advanced_trajectory_context() == false) {
+        return false;
+    }
+    if (ctx->limbs_mask == 0) {
+        return true;
+    }
+    
+    bool is_next_step = state->is_seeded && (motion_tick == state->motion_tick + 1);
+    if (is_next_step) {
+        
+        // Rotate step height phase
+        float c = state->height_cos * ctx->height_step_cos - state->height_sin * ctx->height_step_sin;
+        float s = state->height_sin * ctx->height_step_cos + state->height_cos * ctx->height_step_sin;
+        float norm = 1.5f - 0.5f * (c * c + s * s); // Compensate rounding error accumulation
+        state->height_cos = c * norm;
+        state->height_sin = s * norm;
+    }
+    else {
+        state->height_cos = cosf(motion_time * M_PI);
+        state->height_sin = sinf(motion_time * M_PI); // sin(t * PI) == sin((1 - t) * PI), same for both time directions
+    }
+    
+    // Gait cycle phase of current limbs positions. Stance limbs rotate on same angle 
+    // while phase step if they not cross stance-swing border - calculate it once
+    float gait_phase = get_gait_phase(motion_tick);
+    float gait_prev_phase = gait_phase;
+    float gait_stance_cos = 1.0f;
+    float gait_stance_sin = 0;
+    if (g_gait_params != NULL && gait_phase > state->gait_phase) {
+        gait_prev_phase = state->gait_phase;
+        float stance_angle_rad = (gait_phase - gait_prev_phase) / g_gait_params->duty_factor * ctx->max_arc_angle;
+        gait_stance_cos = cosf(stance_angle_rad);
+        gait_stance_sin = sinf(stance_angle_rad);
+    }
+    
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        
+        // Skip limbs which not use advanced trajectory
+        if ((ctx->limbs_mask & (0x01 << i)) == 0) {
+            continue;
+        }
+        
+        // Gait cycle: limb moves from current position by leg phase from gait generator
+        if (g_motion_config.trajectories[i] == TRAJECTORY_XZ_ADV_Y_GAIT) {
+            if (g_gait_params == NULL) {
+                return false;
+            }
+            process_gait_trajectory(i, gait_prev_phase, gait_phase, gait_stance_cos, gait_stance_sin, limbs);
+            continue;
+        }
+        
+        if (is_next_step) {
+            
+            // Rotate arc angle on one time step (in negative direction for reverse time)
+            float step_sin = (g_motion_config.time_directions[i] == TIME_DIR_REVERSE) ? -ctx->arc_step_sin : ctx->arc_step_sin;
+            float c = state->arc_cos[i] * ctx->arc_step_cos - state->arc_sin[i] * step_sin;
+            float s = state->arc_sin[i] * ctx->arc_step_cos + state->arc_cos[i] * step_sin;
+            float norm = 1.5f - 0.5f * (c * c + s * s);
+            state->arc_cos[i] = c * norm;
+            state->arc_sin[i] = s * norm;
+        }
+        else {
+            
+            // Inversion motion time if need
+            float relative_motion_time = motion_time;
+            if (g_motion_config.time_directions[i] == TIME_DIR_REVERSE) {
+                relative_motion_time = 1.0f - relative_motion_time;
+            }
+
+            // Calculation arc angle for current time
+            float arc_angle_rad = (relative_motion_time - 0.5f) * ctx->max_arc_angle + ctx->start_angle_rad[i];
+            state->arc_cos[i] = cosf(arc_angle_rad);
+            state->arc_sin[i] = sinf(arc_angle_rad);
+        }
+
+        // Calculation XZ points by time
+        limbs->x[i] = ctx->curvature_radius + ctx->trajectory_radius[i] * state->arc_cos[i];
+        limbs->z[i] =                         ctx->trajectory_radius[i] * state->arc_sin[i];
+        
+        // Calculation Y points by time
+        limbs->y[i] = g_motion_config.start_positions[i].y;
+        if (g_motion_config.trajectories[i] == TRAJECTORY_XZ_ADV_Y_SINUS) {
+            limbs->y[i] += LIMB_STEP_HEIGHT * state->height_sin;
+        }
+    }
+    
+    state->is_seeded = true;
+    state->motion_tick = motion_tick;
+    state->gait_phase = gait_phase;
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Process gait trajectory of limb
+/// @note   Limb is re-anchored on each tick: stance limb rotates from current 
+///         position around current curvature center (all stance limbs rotate 
+///         on same angle, no foot slip), swing limb moves from current position 
+///         to landing point of current arc. So trajectory configuration can be
+///         changed at any tick without position jumps. Swing speed is limited
+///         by MOTION_CORE_SWING_SPEED_FACTOR, limb which can not reach landing 
+///         point returns to arc on next swing
+/// @param  limb_index: limb index
+/// @param  prev_phase: gait cycle phase of current limb position
+/// @param  phase: gait cycle phase [prev_phase; 1]
+/// @param  stance_cos: cos of stance rotation angle for full phase step
+/// @param  stance_sin: sin of stance rotation angle for full phase step
+/// @param  limbs: limbs state
+/// @retval limbs position
+/// @return none
+//  ***************************************************************************
+static void process_gait_trajectory(uint32_t limb_index, float prev_phase, float phase, float stance_cos, float stance_sin, limbs_state_t* limbs) {
+    
+    const adv_trajectory_context_t* ctx = &g_adv_trajectory_ctx;
+    const gait_params_t* params = g_gait_params;
+    float direction = (g_motion_config.time_directions[limb_index] == TIME_DIR_REVERSE) ? -1.0f : 1.0f;
+    
+    float leg_phase = prev_phase + params->phase_offsets[limb_index];
+    if (leg_phase >= 1.0f) {
+        leg_phase -= 1.0f;
+    }
+    float x = limbs->x[limb_index] - ctx->curvature_radius; // Relative to curvature center
+    float z = limbs->z[limb_index];
+    float phase_step = phase - prev_phase;
+    
+    if (leg_phase < params->duty_factor && leg_phase + phase_step <= params->duty_factor) {
+        
+        // Stance for all phase step - use precalculated rotation
+        float s = direction * stance_sin;
+        float x1 = x * stance_cos - z * s;
+        z = x * s + z * stance_cos;
+        x = x1;
+    }
+    else {
+        while (phase_step > 0) {
+            if (leg_phase < params->duty_factor) {
+                
+                // Stance: rotate around curvature center
+                float step = params->duty_factor - leg_phase;
+                if (step > phase_step) step = phase_step;
+                float angle_rad = direction * step / params->duty_factor * ctx->max_arc_angle;
+                float c = cosf(angle_rad);
+                float s = sinf(angle_rad);
+                float x1 = x * c - z * s;
+                z = x * s + z * c;
+                x = x1;
+                leg_phase = (step == phase_step) ? (leg_phase + step) : params->duty_factor;
+                phase_step -= step;
+            }
+            else {
+                
+                // Swing: move to landing point, remaining part of swing is decreased by step.
+                // Limit speed if landing point was moved at end of swing
+                float step = 1.0f - leg_phase;
+                if (step > phase_step) step = phase_step;
+                float k = step / (1.0f - leg_phase);
+                float dx = (ctx->gait_landing_x[limb_index] - ctx->curvature_radius - x) * k;
+                float dz = (ctx->gait_landing_z[limb_index] - z) * k;
+                float max_move = ctx->gait_swing_max_length * step / (1.0f - params->duty_factor);
+                float move = sqrtf(dx * dx + dz * dz);
+                if (move > max_move) {
+                    dx = dx * max_move / move;
+                    dz = dz * max_move / move;
+                }
+                x += dx;
+                z += dz;
+                leg_phase = (step == phase_step) ? (leg_phase + step) : 0;
+                phase_step -= step;
+            }
+        }
+    }
+    
+    // Step height is taken from gait generator
+    float arc_position = 0;
+    float height = 0;
+    gait_generator_calculate_leg(params, limb_index, phase, &arc_position, &height);
+    
+    limbs->x[limb_index] = x + ctx->curvature_radius;
+    limbs->z[limb_index] = z;
+    limbs->y[limb_index] = g_motion_config.start_positions[limb_index].y + height;
+}
+
+//  ***************************************************************************
+/// @brief  Build joint space trajectory context
+/// @note   IK is solved for start and destination keyframes only, joints 
+///         limits (protection) are applied to keyframes by IK. Interpolated
+///         angles are between keyframes angles, so they are in limits too
+/// @param  pose: body pose transform. NULL - no transform
+/// @retval g_joint_ctx
+/// @return true - calculation success, false - no
+//  ***************************************************************************
+static bool build_joint_trajectory_context(const body_pose_transform_t* pose) {
+    
+    g_joint_ctx.limbs_mask = 0;
+    g_joint_ctx.clamped_mask = 0;
+    g_joint_ctx.start_time = 0;
+    g_joint_ctx.inv_duration = 1.0f;
+    g_joint_ctx.pose.is_identity = true;
+    if (pose != NULL) {
+        g_joint_ctx.pose = *pose;
+    }
+    
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        
+        // Skip limbs which not use joint space trajectory
+        if (g_motion_config.trajectories[i] != TRAJECTORY_JOINT_LINEAR) {
+            continue;
+        }
+        
+        const point_3d_t* start = &g_motion_config.start_positions[i];
+        const point_3d_t* dest  = &g_motion_config.dest_positions[i];
+        if (g_motion_config.time_directions[i] == TIME_DIR_REVERSE) {
+            const point_3d_t* temp = start;
+            start = dest;
+            dest = temp;
+        }
+        
+        float start_angles[ROBOT_JOINTS_PER_LIMB];
+        float dest_angles[ROBOT_JOINTS_PER_LIMB];
+        bool is_start_clamped = false;
+        bool is_dest_clamped = false;
+        if (solve_joint_keyframe(i, start, pose, start_angles, &is_start_clamped) == false) return false;
+        if (solve_joint_keyframe(i, dest,  pose, dest_angles,  &is_dest_clamped)  == false) return false;
+        
+        for (uint32_t k = 0; k < ROBOT_JOINTS_PER_LIMB; ++k) {
+            g_joint_ctx.start_angles[k][i] = start_angles[k];
+            g_joint_ctx.delta_angles[k][i] = dest_angles[k] - start_angles[k];
+        }
+        g_joint_ctx.dest_positions[i] = *dest;
+        if (is_start_clamped || is_dest_clamped) {
+            g_joint_ctx.clamped_mask |= (1 << i);
+        }
+        g_joint_ctx.limbs_mask |= (1 << i);
+    }
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Process joint space trajectory
+/// @note   Limbs positions are calculated by linear trajectory (nominal), 
+///         angles are interpolated between keyframes. If body pose changed 
+///         while motion then trajectory continues from current angles to 
+///         destination keyframe with new body pose
+/// @param  motion_time: current motion time [0; 1]
+/// @param  limbs: limbs state
+/// @param  pose: body pose transform. NULL - no transform
+/// @retval limbs::angles, limbs::clamped_mask
+/// @return true - calculation success, false - no
+//  ***************************************************************************
+static bool process_joint_trajectory(float motion_time, limbs_state_t* limbs, const body_pose_transform_t* pose) {
+    
+    if (g_joint_ctx.limbs_mask == 0) {
+        return true;
+    }
+    
+    if (is_pose_equal(&g_joint_ctx.pose, pose) == false && motion_time < 1.0f) {
+        float u = (motion_time - g_joint_ctx.start_time) * g_joint_ctx.inv_duration;
+        for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+            if ((g_joint_ctx.limbs_mask & (1 << i)) == 0) {
+                continue;
+            }
+            float dest_angles[ROBOT_JOINTS_PER_LIMB];
+            bool is_clamped = false;
+            if (solve_joint_keyframe(i, &g_joint_ctx.dest_positions[i], pose, dest_angles, &is_clamped) == false) {
+                return false;
+            }
+            for (uint32_t k = 0; k < ROBOT_JOINTS_PER_LIMB; ++k) {
+                float start_angle = g_joint_ctx.start_angles[k][i] + u * g_joint_ctx.delta_angles[k][i];
+                g_joint_ctx.start_angles[k][i] = start_angle;
+                g_joint_ctx.delta_angles[k][i] = dest_angles[k] - start_angle;
+            }
+            if (is_clamped) {
+                g_joint_ctx.clamped_mask |= (1 << i);
+            }
+        }
+        g_joint_ctx.start_time = motion_time;
+        g_joint_ctx.inv_duration = 1.0f / (1.0f - motion_time);
+        g_joint_ctx.pose.is_identity = true;
+        if (pose != NULL) {
+            g_joint_ctx.pose = *pose;
+        }
+    }
+    
+    float u = (motion_time - g_joint_ctx.start_time) * g_joint_ctx.inv_duration;
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        if ((g_joint_ctx.limbs_mask & (1 << i)) == 0) {
+            continue;
+        }
+        for (uint32_t k = 0; k < ROBOT_JOINTS_PER_LIMB; ++k) {
+            limbs->angles[k][i] = g_joint_ctx.start_angles[k][i] + u * g_joint_ctx.delta_angles[k][i];
+        }
+    }
+    limbs->clamped_mask = (limbs->clamped_mask & ~g_joint_ctx.limbs_mask) | g_joint_ctx.clamped_mask;
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Solve IK for joint space trajectory keyframe
+/// @param  limb: limb index
+/// @param  position: keyframe position (without body pose)
+/// @param  pose: body pose transform. NULL - no transform
+/// @param  angles: joints angles by ROBOT_JOINT_xxx, [degree]
+/// @param  is_clamped: keyframe was projected to reachability envelope
+/// @retval angles, is_clamped
+/// @return true - calculation success, false - no
+//  ***************************************************************************
+static bool solve_joint_keyframe(uint32_t limb, const point_3d_t* position, const body_pose_transform_t* pose, float* angles, bool* is_clamped) {
+    
+    point_3d_t ik_position = *position;
+    if (pose != NULL && pose->is_identity == false) {
+        body_pose_apply(pose, &position->x, &position->y, &position->z, &ik_position.x, &ik_position.y, &ik_position.z, 1);
+    }
+    
+    kinematic_result_t result;
+    if (kinematic_calculate_angles(&g_limbs_geometry[limb], &ik_position, &result) == false) {
+        return false;
+    }
+    for (uint32_t k = 0; k < ROBOT_JOINTS_PER_LIMB; ++k) {
+        angles[k] = result.angles[k];
+    }
+    *is_clamped = result.is_position_clamped;
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Compare body pose transforms
+/// @param  a: keyframes body pose transform
+/// @param  b: body pose transform. NULL - no transform
+/// @return true - transforms are equal, false - no
+//  ***************************************************************************
+static bool is_pose_equal(const body_pose_transform_t* a, const body_pose_transform_t* b) {
+    
+    bool is_b_identity = (b == NULL || b->is_identity);
+    if (a->is_identity || is_b_identity) {
+        return a->is_identity == is_b_identity;
+    }
+    if (memcmp(a->matrix, b->matrix, sizeof(a->matrix)) != 0) {
+        return false;
+    }
+    return a->offset.x == b->offset.x && a->offset.y == b->offset.y && a->offset.z == b->offset.z;
+}
+
+//  ***************************************************************************
+/// @brief  Get limb position from limbs state
+/// @param  limbs: limbs state
+/// @param  limb: limb index
+/// @return limb position
+//  ***************************************************************************
+static inline point_3d_t get_limb_position(const limbs_state_t* limbs, uint32_t limb) {
+    point_3d_t position = { limbs->x[limb], limbs->y[limb], limbs->z[limb] };
+    return position;
+}
+
+//  ***************************************************************************
+/// @brief  Set limb position to limbs state
+/// @param  limbs: limbs state
+/// @param  limb: limb index
+/// @param  position: limb position
+/// @return none
+//  ***************************************************************************
+static inline void set_limb_position(limbs_state_t* limbs, uint32_t limb, const point_3d_t* position) {
+    limbs->x[limb] = position->x;
+    limbs->y[limb] = position->y;
+    limbs->z[limb] = position->z;
+}
+
+//  ***************************************************************************
+/// @brief  Update reachability clamps counters
+/// @param  limbs: limbs state after IK
+/// @param  counters: counters for each limb
+/// @retval counters
+/// @return none
+//  ***************************************************************************
+static void update_clamps_counters(const limbs_state_t* limbs, uint32_t* counters) {
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        if (limbs->clamped_mask & (1 << i)) {
+            ++counters[i];
+        }
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Calculate angles for all limbs
+/// @note   IK backend is selected by KINEMATIC_FAST_BACKEND_ENABLE. Body pose
+///         transform is applied to IK positions only (trajectories work 
+///         without pose).
+///         Not attainable positions are projected to reachability envelope 
+///         by IK, limbs positions are not changed (trajectory target).
+///         IK is skipped for limbs which position was not changed from last 
+///         IK (stance limbs, holded limbs), their angles are actual.
+///         IK is skipped for joint space trajectory limbs, their angles are
+///         interpolated already. They are reported as changed
+/// @param  limbs: limbs state
+/// @param  pose: body pose transform. NULL - no transform
+/// @param  joint_limbs_mask: limbs which angles are interpolated in joint space
+/// @param  changed_limbs_mask: limbs which angles was recalculated by IK or interpolated
+/// @retval limbs, changed_limbs_mask
+/// @return true - calculation success, false - no
+//  ***************************************************************************
+static bool calculate_limbs_angles(limbs_state_t* limbs, const body_pose_transform_t* pose, uint32_t joint_limbs_mask, uint32_t* changed_limbs_mask) {
+
+    // IK positions: trajectory positions with body pose
+    float x[SUPPORT_LIMBS_COUNT];
+    float y[SUPPORT_LIMBS_COUNT];
+    float z[SUPPORT_LIMBS_COUNT];
+    if (pose != NULL && pose->is_identity == false) {
+        body_pose_apply(pose, limbs->x, limbs->y, limbs->z, x, y, z, SUPPORT_LIMBS_COUNT);
+    }
+    else {
+        memcpy(x, limbs->x, sizeof(x));
+        memcpy(y, limbs->y, sizeof(y));
+        memcpy(z, limbs->z, sizeof(z));
+    }
+    
+    // Find limbs which IK positions was changed
+    uint32_t changed_mask = 0;
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        if (x[i] != limbs->ik_x[i] || y[i] != limbs->ik_y[i] || z[i] != limbs->ik_z[i]) {
+            changed_mask |= (1 << i);
+        }
+    }
+    changed_mask |= ~limbs->ik_valid_mask & ((1 << SUPPORT_LIMBS_COUNT) - 1);
+    changed_mask &= ~joint_limbs_mask;
+    
+    // Angles of joint space trajectory limbs are not match IK positions
+    limbs->ik_valid_mask &= ~joint_limbs_mask;
+    *changed_limbs_mask = joint_limbs_mask;
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        if ((changed_mask & (1 << i)) == 0) {
+            continue;
+        }
+        
+        point_3d_t position = { x[i], y[i], z[i] };
+        kinematic_result_t result;
+        if (kinematic_calculate_angles(&g_limbs_geometry[i], &position, &result) == false) {
+            limbs->ik_valid_mask &= ~(1 << i);
+            return false;
+        }
+        for (uint32_t k = 0; k < ROBOT_JOINTS_PER_LIMB; ++k) {
+            limbs->angles[k][i] = result.angles[k];
+        }
+        if (result.is_position_clamped) {
+            limbs->clamped_mask |= (1 << i);
+        }
+        else {
+            limbs->clamped_mask &= ~(1 << i);
+        }
+        limbs->ik_x[i] = x[i];
+        limbs->ik_y[i] = y[i];
+        limbs->ik_z[i] = z[i];
+        limbs->ik_valid_mask |= (1 << i);
+        *changed_limbs_mask |= (1 << i);
+    }
+    return true;
+}
 #undef M_PI
 #undef RAD_TO_DEG
 #undef DEG_TO_RAD
+
+#if MOTION_CORE_BAKED_SCHEDULE_ENABLE
+//  ***************************************************************************
+/// @brief  Select baked schedule for motion
+/// @note   Motion can be baked if trajectory configuration will not changed 
+///         while motion. Baked schedule is reused if same motion started again 
+///         from same start positions with same trajectory configuration (gait 
+///         loop) and limbs are in same positions (gait trajectory starts from 
+///         them). Motions are compared by content: decoded motions of packed
+///         sequences use same buffer. Rows pool is ring buffer: new motion
+///         evicts motions which rows it overwrites and oldest motion if no
+///         free items, so looped sequence which fits to pool is not re-baked
+/// @param  none
+/// @return baked motion or NULL if motion should be calculated live
+//  ***************************************************************************
+static baked_motion_t* baked_schedule_select(void) {
+    
+    if (g_motion_ticks_count == 0) {
+        return NULL;
+    }
+    
+    // Scheduled start offset shifts motion clock, motion is unique
+    if (g_motion_time_begin != (float)g_motion_config.motion_time) {
+        return NULL;
+    }
+    
+    // Joint space trajectory has no IK per tick and keyframes depend on body pose
+    if (g_joint_ctx.limbs_mask != 0) {
+        return NULL;
+    }
+    
+    // Check trajectory configuration update while motion
+    if (g_motion_config.time_update > g_motion_config.motion_time && g_motion_config.time_update < g_motion_config.time_stop) {
+        if (g_current_trajectory_config.curvature != g_next_trajectory_config.curvature || 
+            g_current_trajectory_config.distance != g_next_trajectory_config.distance) {
+            return NULL;
+        }
+    }
+    
+    // Search baked motion
+    for (uint32_t i = 0; i < MOTION_CORE_BAKED_SCHEDULE_MAX_MOTIONS; ++i) {
+        baked_motion_t* baked_motion = &g_baked_motions[i];
+        if (baked_motion->rows_count == 0) continue;
+        if (is_motion_config_equal(&baked_motion->motion_config, &g_motion_config) == false) continue;
+        if (baked_motion->time_step != g_motion_time_step) continue;
+        if (baked_motion->trajectory_config.curvature != g_current_trajectory_config.curvature) continue;
+        if (baked_motion->trajectory_config.distance != g_current_trajectory_config.distance) continue;
+        
+        bool is_match = true;
+        for (uint32_t k = 0; k < SUPPORT_LIMBS_COUNT; ++k) {
+            // Spline segment depends on previous motion
+            const point_3d_t* a = &baked_motion->spline_velocities[k];
+            const point_3d_t* b = &g_spline_start_velocities[k];
+            if (a->x != b->x || a->y != b->y || a->z != b->z) {
+                is_match = false;
+                break;
+            }
+            
+            // Limbs are not on nominal gait cycle after hot update
+            a = &baked_motion->limbs_positions[k];
+            point_3d_t limb_position = get_limb_position(&g_limbs, k);
+            b = &limb_position;
+            if (fabsf(a->x - b->x) > MOTION_CORE_BAKED_SCHEDULE_TOLERANCE || 
+                fabsf(a->y - b->y) > MOTION_CORE_BAKED_SCHEDULE_TOLERANCE || 
+                fabsf(a->z - b->z) > MOTION_CORE_BAKED_SCHEDULE_TOLERANCE) {
+                is_match = false;
+                break;
+            }
+        }
+        if (is_match) {
+            if (baked_motion->baked_rows_count < baked_motion->rows_count) {
+                baked_motion->baked_rows_count = 0; // Baker limbs state is lost, bake again
+                baked_schedule_init_baker();
+            }
+            g_baked_replay_row = 0;
+            return baked_motion;
+        }
+    }
+    
+    // Allocate rows
+    uint32_t rows_count = baked_schedule_plan_rows(NULL);
+    if (rows_count > MOTION_CORE_BAKED_SCHEDULE_MAX_ROWS) {
+        return NULL; // Too long motion
+    }
+    if (g_baked_rows_used + rows_count > MOTION_CORE_BAKED_SCHEDULE_MAX_ROWS) {
+        g_baked_rows_used = 0;
+    }
+    uint32_t first_row = g_baked_rows_used;
+    
+    // Evict motions which rows are overwritten. Use free item or evict oldest motion
+    baked_motion_t* baked_motion = NULL;
+    for (uint32_t i = 0; i < MOTION_CORE_BAKED_SCHEDULE_MAX_MOTIONS; ++i) {
+        baked_motion_t* item = &g_baked_motions[i];
+        if (item->rows_count != 0 && item->first_row < first_row + rows_count && first_row < item->first_row + item->rows_count) {
+            item->rows_count = 0;
+        }
+    }
+    for (uint32_t i = 0; i < MOTION_CORE_BAKED_SCHEDULE_MAX_MOTIONS; ++i) {
+        baked_motion_t* item = &g_baked_motions[i];
+        if (item->rows_count == 0) {
+            baked_motion = item;
+            break;
+        }
+        if (baked_motion == NULL || item->allocation_number < baked_motion->allocation_number) {
+            baked_motion = item;
+        }
+    }
+    
+    baked_motion->motion_config = g_motion_config;
+    baked_motion->trajectory_config = g_current_trajectory_config;
+    baked_motion->time_step = g_motion_time_step;
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        baked_motion->limbs_positions[i] = get_limb_position(&g_limbs, i);
+        baked_motion->spline_velocities[i] = g_spline_start_velocities[i];
+    }
+    baked_motion->first_row = first_row;
+    baked_motion->rows_count = rows_count;
+    baked_motion->baked_rows_count = 0;
+    baked_motion->allocation_number = g_baked_allocations_count++;
+    g_baked_rows_used = first_row + rows_count;
+    baked_schedule_plan_rows(&g_baked_row_ticks[first_row]);
+    g_baked_replay_row = 0;
+    
+    baked_schedule_init_baker();
+    return baked_motion;
+}
+
+//  ***************************************************************************
+/// @brief  Compare motion configurations
+/// @note   Initialized start positions are current limbs positions, they 
+///         are compared with tolerance by caller
+/// @param  a, b: motion configurations. @ref motion_config_t
+/// @return true - configurations are equal, false - no
+//  ***************************************************************************
+static bool is_motion_config_equal(const motion_config_t* a, const motion_config_t* b) {
+    
+    if (memcmp(a->dest_positions, b->dest_positions, sizeof(a->dest_positions)) != 0) return false;
+    if (memcmp(a->trajectories, b->trajectories, sizeof(a->trajectories)) != 0) return false;
+    if (memcmp(a->time_directions, b->time_directions, sizeof(a->time_directions)) != 0) return false;
+    if (a->is_need_init_start_position != b->is_need_init_start_position) return false;
+    if (a->is_need_init_start_position == false && memcmp(a->start_positions, b->start_positions, sizeof(a->start_positions)) != 0) return false;
+    return a->motion_time == b->motion_time && a->time_stop == b->time_stop && a->time_update == b->time_update && 
+           a->time_step == b->time_step;
+}
+
+//  ***************************************************************************
+/// @brief  Initialize baker for bake motion from first row
+/// @note   Gait trajectory moves limbs from current positions
+/// @param  none
+/// @return none
+//  ***************************************************************************
+static void baked_schedule_init_baker(void) {
+    memcpy(g_baker_limbs.x, g_limbs.x, sizeof(g_limbs.x));
+    memcpy(g_baker_limbs.y, g_limbs.y, sizeof(g_limbs.y));
+    memcpy(g_baker_limbs.z, g_limbs.z, sizeof(g_limbs.z));
+    g_baker_adv_trajectory_state.is_seeded = false;
+    g_baker_adv_trajectory_state.gait_phase = g_motion_time_begin / (float)MTIME_SCALE;
+}
+
+//  ***************************************************************************
+/// @brief  Bake next row of current baked motion
+/// @note   Baker jumps over ticks between rows: gait trajectory moves limbs
+///         by phase step, other trajectories are calculated by motion time
+/// @param  none
+/// @retval g_baked_rows, g_baked_motion
+/// @return true - calculation success, false - no
+//  ***************************************************************************
+static bool baked_schedule_bake_next_row(void) {
+    
+    baked_motion_t* baked_motion = g_baked_motion;
+    uint32_t row = baked_motion->baked_rows_count;
+    uint32_t changed_limbs_mask = 0;
+    if (process_motion_tick(g_baked_row_ticks[baked_motion->first_row + row], &g_baker_limbs, &g_baker_adv_trajectory_state, NULL, &changed_limbs_mask) == false) {
+        return false;
+    }
+    if (row == 0) {
+        memset(baked_motion->clamps_count, 0, sizeof(baked_motion->clamps_count));
+    }
+    update_clamps_counters(&g_baker_limbs, baked_motion->clamps_count);
+    update_ik_statistic(changed_limbs_mask);
+    
+    uint16_t* pulse_widths = g_baked_rows[baked_motion->first_row + row];
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        if (row != 0 && (changed_limbs_mask & (1 << i)) == 0) { // Copy angles from previous row
+            for (uint32_t k = 0; k < ROBOT_JOINTS_PER_LIMB; ++k) {
+                uint32_t servo_index = ROBOT_SERVO_INDEX(i, k);
+                pulse_widths[servo_index] = g_baked_rows[baked_motion->first_row + row - 1][servo_index];
+            }
+            continue;
+        }
+        for (uint32_t k = 0; k < ROBOT_JOINTS_PER_LIMB; ++k) {
+            uint32_t servo_index = ROBOT_SERVO_INDEX(i, k);
+            pulse_widths[servo_index] = servo_driver_convert_angle(servo_index, g_baker_limbs.angles[k][i]);
+        }
+    }
+    
+    // Save limbs positions after motion
+    if (row + 1 == baked_motion->rows_count) {
+        for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+            baked_motion->end_positions[i] = get_limb_position(&g_baker_limbs, i);
+        }
+    }
+    
+    baked_motion->baked_rows_count = row + 1;
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Replay current motion tick from baked rows
+/// @note   Pulse widths of tick between rows are interpolated. Required rows
+///         should be baked
+/// @param  none
+/// @return none
+//  ***************************************************************************
+static void baked_schedule_replay_tick(void) {
+    
+    const baked_motion_t* baked_motion = g_baked_motion;
+    uint32_t row = baked_schedule_find_row();
+    uint32_t row_tick = g_baked_row_ticks[baked_motion->first_row + row];
+    const uint16_t* pulse_widths = g_baked_rows[baked_motion->first_row + row];
+    if (row_tick == g_motion_tick) {
+        for (uint32_t i = 0; i < SUPPORT_SERVO_COUNT; ++i) {
+            servo_driver_move_pulse_width(i, pulse_widths[i]);
+        }
+    }
+    else {
+        const uint16_t* next_pulse_widths = g_baked_rows[baked_motion->first_row + row + 1];
+        int32_t ticks = (int32_t)(g_baked_row_ticks[baked_motion->first_row + row + 1] - row_tick);
+        int32_t tick = (int32_t)(g_motion_tick - row_tick);
+        for (uint32_t i = 0; i < SUPPORT_SERVO_COUNT; ++i) {
+            int32_t delta = (int32_t)next_pulse_widths[i] - (int32_t)pulse_widths[i];
+            servo_driver_move_pulse_width(i, (uint32_t)((int32_t)pulse_widths[i] + delta * tick / ticks));
+        }
+    }
+    
+    // Servo driver is not contain limbs angles now - IK required for next live tick
+    g_limbs.ik_valid_mask = 0;
+    update_ik_statistic(0);
+    update_command_latency();
+    
+    // Limbs positions are not calculated while replay, restore them at last tick
+    if (g_motion_tick + 1 >= g_motion_ticks_count) {
+        for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+            set_limb_position(&g_limbs, i, &baked_motion->end_positions[i]);
+            g_clamps_count[i] += baked_motion->clamps_count[i];
+        }
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Plan baked rows of current motion
+/// @note   Rows are placed on every stride tick and last tick. Stride is
+///         limited by step height (sinus) interpolation error: 
+///         H * pi^2 * stride^2 / (8 * lift_ticks^2). Gait limbs change
+///         direction on stance-swing borders, rows are placed on both ticks
+///         around border - interpolation is not cross it
+/// @param  row_ticks: motion ticks of rows. NULL - count rows only
+/// @retval row_ticks
+/// @return rows count
+//  ***************************************************************************
+static uint32_t baked_schedule_plan_rows(uint16_t* row_ticks) {
+    
+    // Limit stride by lifted limbs
+    uint32_t stride = MOTION_CORE_BAKED_SCHEDULE_MAX_STRIDE;
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        trajectory_t trajectory = g_motion_config.trajectories[i];
+        float lift_ticks = (float)g_motion_ticks_count;
+        float height = LIMB_STEP_HEIGHT;
+        if (trajectory == TRAJECTORY_XZ_ADV_Y_GAIT && g_gait_params != NULL) {
+            lift_ticks = (1.0f - g_gait_params->duty_factor) * MTIME_SCALE / g_motion_time_step;
+            height = g_gait_params->step_height;
+        }
+        else if (trajectory != TRAJECTORY_XYZ_LINEAR_LIFT && trajectory != TRAJECTORY_XZ_ADV_Y_SINUS) {
+            continue;
+        }
+        uint32_t max_stride = (uint32_t)(lift_ticks * sqrtf(8.0f * MOTION_CORE_BAKED_SCHEDULE_MAX_ERROR / (height * 9.8696044f))); // pi^2
+        if (max_stride < stride) {
+            stride = (max_stride > 1) ? max_stride : 1;
+        }
+    }
+    
+    // Sorted ticks around stance-swing borders (duplicates are allowed)
+    uint32_t border_ticks[4 * SUPPORT_LIMBS_COUNT];
+    uint32_t borders_count = 0;
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT && g_gait_params != NULL; ++i) {
+        if (g_motion_config.trajectories[i] != TRAJECTORY_XZ_ADV_Y_GAIT) {
+            continue;
+        }
+        float border_phases[2] = { g_gait_params->duty_factor - g_gait_params->phase_offsets[i], 1.0f - g_gait_params->phase_offsets[i] };
+        for (uint32_t k = 0; k < 2; ++k) {
+            
+            // First tick after border: get_gait_phase(tick) >= border phase
+            float phase = (border_phases[k] > 0) ? border_phases[k] : border_phases[k] + 1.0f;
+            float tick = ceilf((phase * MTIME_SCALE - g_motion_time_begin) / g_motion_time_step - 1.0f);
+            if (tick < 1.0f || tick >= (float)g_motion_ticks_count) {
+                continue;
+            }
+            for (uint32_t b = (uint32_t)tick - 1; b <= (uint32_t)tick; ++b) {
+                uint32_t n = borders_count++;
+                while (n > 0 && border_ticks[n - 1] > b) {
+                    border_ticks[n] = border_ticks[n - 1];
+                    --n;
+                }
+                border_ticks[n] = b;
+            }
+        }
+    }
+    
+    uint32_t rows_count = 0;
+    uint32_t tick = 0;
+    uint32_t border = 0;
+    while (true) {
+        if (row_ticks != NULL) {
+            row_ticks[rows_count] = (uint16_t)tick;
+        }
+        ++rows_count;
+        if (tick + 1 >= g_motion_ticks_count) {
+            return rows_count;
+        }
+        uint32_t next_tick = tick + stride;
+        if (next_tick > g_motion_ticks_count - 1) {
+            next_tick = g_motion_ticks_count - 1;
+        }
+        while (border < borders_count && border_ticks[border] <= tick) {
+            ++border;
+        }
+        if (border < borders_count && border_ticks[border] < next_tick) {
+            next_tick = border_ticks[border];
+        }
+        tick = next_tick;
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Find baked row of current motion tick
+/// @note   Motion tick is only increased while motion (missed ticks can be
+///         skipped), so search is continued from previous row
+/// @param  none
+/// @return row with tick equal or less current motion tick
+//  ***************************************************************************
+static uint32_t baked_schedule_find_row(void) {
+    const uint16_t* row_ticks = &g_baked_row_ticks[g_baked_motion->first_row];
+    while (g_baked_replay_row + 1 < g_baked_motion->rows_count && row_ticks[g_baked_replay_row + 1] <= g_motion_tick) {
+        ++g_baked_replay_row;
+    }
+    return g_baked_replay_row;
+}
+#endif
@@ -8,8 +8,10 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "cli.h"
+#include "robot_config.h"
 
-#define SUPPORT_LIMBS_COUNT                 (6)
+#define SUPPORT_LIMBS_COUNT                 (ROBOT_LIMBS_COUNT)
 
 #define LIMB_STEP_HEIGHT                    (30)
 
@@ -19,11 +21,38 @@
 #define MTIME_MID_VALUE                     (MTIME_MAX_VALUE >> 1)
 #define MTIME_NO_UPDATE                     (MTIME_MAX_VALUE << 1)
 
+#define MOTION_CORE_SPEED_MIN               (0.25f)
+#define MOTION_CORE_SPEED_MAX               (4.00f)
+
+#define MOTION_CORE_BLEND_MAX_SPEED         (1.5f)      // Max limb speed for preemptive motion, [mm per PWM period at PWM_FREQUENCY_HZ]
+#define MOTION_CORE_SWING_SPEED_FACTOR      (2.0f)      // Max swing speed relative to nominal while gait re-planning
+#define MOTION_CORE_PATH_CHECK_POINTS       (8)         // Linear path check points count (attainability check)
+
+// Baked schedule: motion servo pulse widths are calculated ahead in idle time and replayed on PWM ticks
+#ifndef MOTION_CORE_BAKED_SCHEDULE_ENABLE
+#define MOTION_CORE_BAKED_SCHEDULE_ENABLE   (1)
+#endif
+#define MOTION_CORE_BAKED_SCHEDULE_RAM_BUDGET   (4096)  // RAM for baked rows, [bytes]
+#define MOTION_CORE_BAKED_SCHEDULE_MAX_ROWS     (MOTION_CORE_BAKED_SCHEDULE_RAM_BUDGET / (ROBOT_SERVO_COUNT * 2))   // 113 rows for hexapod
+#define MOTION_CORE_BAKED_SCHEDULE_MAX_MOTIONS  (8)
+#define MOTION_CORE_BAKED_SCHEDULE_MAX_STRIDE   (8)     // Max motion ticks per baked row, pulse widths are interpolated between rows
+#define MOTION_CORE_BAKED_SCHEDULE_MAX_ERROR    (0.2f)  // Max step height interpolation error between rows, [mm]
+#ifndef MOTION_CORE_BAKED_SCHEDULE_CATCH_UP_ROWS
+#define MOTION_CORE_BAKED_SCHEDULE_CATCH_UP_ROWS    (1) // Max rows baked on PWM tick if idle time was not enough, else tick is calculated live
+#endif
+#define MOTION_CORE_BAKED_SCHEDULE_TOLERANCE    (0.5f)  // Max limb position mismatch for reuse baked motion, [mm]
+
 
 typedef enum {
     TRAJECTORY_XYZ_LINEAR,
     TRAJECTORY_XZ_ADV_Y_CONST,
-    TRAJECTORY_XZ_ADV_Y_SINUS
+    TRAJECTORY_XZ_ADV_Y_SINUS,
+    TRAJECTORY_XYZ_LINEAR_LIFT,         // Linear with step height by sinus
+    TRAJECTORY_XZ_ADV_Y_GAIT,           // Gait cycle from gait generator. Motion time is cycle phase, trajectory config is hot updated
+    TRAJECTORY_XYZ_HOLD,                // Limb keeps start position
+    TRAJECTORY_XYZ_SPLINE,              // Cubic spline through destination points of consecutive motions (C1)
+    TRAJECTORY_XYZ_MIN_JERK,            // Quintic spline through destination points of consecutive motions (C2)
+    TRAJECTORY_JOINT_LINEAR             // Linear interpolation of joints angles between start and destination (IK on motion start only)
 } trajectory_t;
 
 typedef enum {
@@ -50,12 +79,34 @@ typedef struct {
 } motion_config_t;
 
 
+struct gait_params_s;
+
+
 extern void motion_core_init(const point_3d_t* start_point_list);
 extern void motion_core_start_motion(const motion_config_t* motion_config);
+extern void motion_core_set_next_motion(const motion_config_t* next_motion_config);
+extern void motion_core_preempt_motion(const motion_config_t* motion_config);
+extern void motion_core_mark_command(uint64_t command_time);
 extern void motion_core_reset_trajectory_config(void);
 extern void motion_core_update_trajectory_config(int32_t curvature, int32_t distance);
 extern void motion_core_process(void);
 extern bool motion_core_is_motion_complete(void);
+extern bool motion_core_is_limb_lifted(uint32_t limb);
+extern uint32_t motion_core_get_ground_periods(uint32_t limbs_mask);
+extern uint32_t motion_core_get_remaining_periods(void);
+extern uint32_t motion_core_get_motion_periods(const motion_config_t* motion_config, bool is_preempt);
+extern void motion_core_schedule_start(uint64_t start_period, float start_offset);
+extern bool motion_core_is_start_scheduled(void);
+extern bool motion_core_get_start_late(uint32_t* late_periods);
+extern void motion_core_set_speed_multiplier(float multiplier);
+extern float motion_core_get_speed_multiplier(void);
+extern void motion_core_set_gait_params(const struct gait_params_s* params);
+extern bool motion_core_calculate_arc_geometry(const point_3d_t* start_positions, int32_t curvature, int32_t distance, 
+                                               float* curvature_radius, float* trajectory_radius, float* start_angle_rad, float* max_arc_angle);
+extern bool motion_core_check_position(uint32_t limb, const point_3d_t* position);
+extern bool motion_core_check_path(uint32_t limb, const point_3d_t* start, const point_3d_t* dest, bool is_lift_used);
+
+extern bool motion_core_cli_command_process(const char* cmd, const char (*argv)[CLI_ARG_MAX_SIZE], uint32_t argc, char* response);
 
 
 #endif /* _MOTION_CORE_H_ */
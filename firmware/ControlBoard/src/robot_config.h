@@ -0,0 +1,108 @@
+//  ***************************************************************************
+/// @file    robot_config.h
+/// @author  NeoProg
+/// @brief   Build-time robot description
+/// @note    Host compilable (no hardware dependencies). Select robot by
+///          ROBOT_CONFIG_HEXAPOD (default) or ROBOT_CONFIG_QUADRUPED define.
+///          Limbs are numbered by left side from front to rear and after
+///          that by right side from front to rear. Servo index of limb joint
+///          is ROBOT_SERVO_INDEX(limb, joint), servo with index N is driven
+///          by PWM channel N from ROBOT_PWM_CHANNELS_LIST
+//  ***************************************************************************
+#ifndef _ROBOT_CONFIG_H_
+#define _ROBOT_CONFIG_H_
+
+#if !defined(ROBOT_CONFIG_HEXAPOD) && !defined(ROBOT_CONFIG_QUADRUPED)
+#define ROBOT_CONFIG_HEXAPOD
+#endif
+
+
+#define ROBOT_JOINT_COXA                    (0)
+#define ROBOT_JOINT_FEMUR                   (1)
+#define ROBOT_JOINT_TIBIA                   (2)
+#define ROBOT_JOINTS_PER_LIMB               (3)
+
+#define ROBOT_SERVO_INDEX(limb, joint)      ((limb) * ROBOT_JOINTS_PER_LIMB + (joint))
+
+
+#if defined(ROBOT_CONFIG_HEXAPOD)
+
+#define ROBOT_LIMBS_COUNT                   (6)
+
+// Default limb geometry. Used if EEPROM cell is not programmed (0xFFFF)
+#define ROBOT_DEFAULT_COXA_LENGTH           (53)
+#define ROBOT_DEFAULT_FEMUR_LENGTH          (76)
+#define ROBOT_DEFAULT_TIBIA_LENGTH          (137)
+#define ROBOT_DEFAULT_COXA_ZERO_ROTATE      { 135, 180, 225, 45, 0, 315 }
+#define ROBOT_DEFAULT_FEMUR_ZERO_ROTATE     (35)
+#define ROBOT_DEFAULT_TIBIA_ZERO_ROTATE     (135)
+
+// Gait phase offsets and duty factors (see gait_generator.c)
+#define ROBOT_GAIT_TRIPOD_PHASE_OFFSETS     { 0.5f, 0.0f, 0.5f, 0.0f, 0.5f, 0.0f }
+#define ROBOT_GAIT_TRIPOD_DUTY_FACTOR       (0.5f)
+#define ROBOT_GAIT_RIPPLE_PHASE_OFFSETS     { 0.0f, 0.333333f, 0.666667f, 0.5f, 0.833333f, 0.166667f }
+#define ROBOT_GAIT_RIPPLE_DUTY_FACTOR       (0.666667f)
+#define ROBOT_GAIT_WAVE_PHASE_OFFSETS       { 0.5f, 0.666667f, 0.833333f, 0.0f, 0.166667f, 0.333333f }
+#define ROBOT_GAIT_WAVE_DUTY_FACTOR         (0.833333f)
+#define ROBOT_GAIT_SUPPORT_GROUP_MASK       (0x15)  // Limbs which move together in first gait prepare motion (0, 2, 4)
+
+// Servo PWM outputs: { GPIO port, GPIO pin } by servo index
+#define ROBOT_PWM_CHANNELS_LIST {                                                                               \
+    { GPIOD,  8 }, { GPIOB, 15 }, { GPIOB, 14 },    /* Limb 0 */                                                \
+    { GPIOE,  9 }, { GPIOE,  8 }, { GPIOB,  2 },    /* Limb 1 */                                                \
+    { GPIOB,  1 }, { GPIOB,  0 }, { GPIOC,  5 },    /* Limb 2 */                                                \
+    { GPIOA,  0 }, { GPIOA,  1 }, { GPIOA,  2 },    /* Limb 3 */                                                \
+    { GPIOA,  3 }, { GPIOA,  4 }, { GPIOA,  5 },    /* Limb 4 */                                                \
+    { GPIOA,  6 }, { GPIOA,  7 }, { GPIOC,  4 },    /* Limb 5 */                                                \
+}
+
+// Servo PWM pulse start offsets by limb, [us]. Pulse starts are spread over PWM period for reduce
+// supply current peaks. Offsets are compressed by PWM driver if max pulse is not fit to PWM period
+#define ROBOT_PWM_LIMB_START_OFFSETS        { 0, 200, 400, 600, 800, 1000 }
+
+#elif defined(ROBOT_CONFIG_QUADRUPED)
+
+#define ROBOT_LIMBS_COUNT                   (4)
+
+// Default limb geometry. Used if EEPROM cell is not programmed (0xFFFF)
+#define ROBOT_DEFAULT_COXA_LENGTH           (53)
+#define ROBOT_DEFAULT_FEMUR_LENGTH          (76)
+#define ROBOT_DEFAULT_TIBIA_LENGTH          (137)
+#define ROBOT_DEFAULT_COXA_ZERO_ROTATE      { 135, 225, 45, 315 }
+#define ROBOT_DEFAULT_FEMUR_ZERO_ROTATE     (35)
+#define ROBOT_DEFAULT_TIBIA_ZERO_ROTATE     (135)
+
+// Gait phase offsets and duty factors: trot (diagonal pairs) and walk (one leg in air)
+#define ROBOT_GAIT_TRIPOD_PHASE_OFFSETS     { 0.5f, 0.0f, 0.0f, 0.5f }
+#define ROBOT_GAIT_TRIPOD_DUTY_FACTOR       (0.5f)
+#define ROBOT_GAIT_RIPPLE_PHASE_OFFSETS     { 0.0f, 0.75f, 0.5f, 0.25f }
+#define ROBOT_GAIT_RIPPLE_DUTY_FACTOR       (0.75f)
+#define ROBOT_GAIT_WAVE_PHASE_OFFSETS       { 0.0f, 0.75f, 0.5f, 0.25f }
+#define ROBOT_GAIT_WAVE_DUTY_FACTOR         (0.75f)
+#define ROBOT_GAIT_SUPPORT_GROUP_MASK       (0x09)  // Limbs which move together in first gait prepare motion (0, 3)
+
+// Servo PWM outputs: { GPIO port, GPIO pin } by servo index. Hexapod limbs 0, 2, 3, 5 connectors
+#define ROBOT_PWM_CHANNELS_LIST {                                                                               \
+    { GPIOD,  8 }, { GPIOB, 15 }, { GPIOB, 14 },    /* Limb 0 */                                                \
+    { GPIOB,  1 }, { GPIOB,  0 }, { GPIOC,  5 },    /* Limb 1 */                                                \
+    { GPIOA,  0 }, { GPIOA,  1 }, { GPIOA,  2 },    /* Limb 2 */                                                \
+    { GPIOA,  6 }, { GPIOA,  7 }, { GPIOC,  4 },    /* Limb 3 */                                                \
+}
+
+// Servo PWM pulse start offsets by limb, [us]. Pulse starts are spread over PWM period for reduce
+// supply current peaks. Offsets are compressed by PWM driver if max pulse is not fit to PWM period
+#define ROBOT_PWM_LIMB_START_OFFSETS        { 0, 300, 600, 900 }
+
+#else
+#error "Robot configuration is not selected"
+#endif
+
+
+#define ROBOT_SERVO_COUNT                   (ROBOT_LIMBS_COUNT * ROBOT_JOINTS_PER_LIMB)
+
+#if ROBOT_LIMBS_COUNT > 6
+#error "EEPROM map contains coxa zero rotate cells for 6 limbs"
+#endif
+
+
+#endif // _ROBOT_CONFIG_H_
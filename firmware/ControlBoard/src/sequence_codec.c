@@ -0,0 +1,243 @@
+//  ***************************************************************************
+/// @file    sequence_codec.c
+/// @author  NeoProg
+//  ***************************************************************************
+#include "sequence_codec.h"
+#include <string.h>
+
+
+static bool encode_value(float value, int16_t* encoded);
+static bool encode_time(int32_t value, int16_t* encoded);
+static bool check_motion(const packed_motion_t* packed);
+
+
+//  ***************************************************************************
+/// @brief  Encode motion to packed format
+/// @note   Used by host sequence packer and sequence upload. Start positions
+///         are not encoded (runtime field)
+/// @param  motion: motion configuration. @ref motion_config_t
+/// @param  packed: packed motion. @ref packed_motion_t
+/// @retval packed
+/// @return true - success, false - motion can not be packed without loss
+//  ***************************************************************************
+bool sequence_codec_encode_motion(const motion_config_t* motion, packed_motion_t* packed) {
+
+    memset(packed, 0, sizeof(packed_motion_t));
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+
+        if (encode_value(motion->dest_positions[i].x, &packed->dest_positions[i][0]) == false) return false;
+        if (encode_value(motion->dest_positions[i].y, &packed->dest_positions[i][1]) == false) return false;
+        if (encode_value(motion->dest_positions[i].z, &packed->dest_positions[i][2]) == false) return false;
+
+        if ((uint32_t)motion->trajectories[i] > SEQUENCE_CODEC_TRAJECTORY_MASK) {
+            return false;
+        }
+        uint32_t mode = (uint32_t)motion->trajectories[i];
+        if (motion->time_directions[i] == TIME_DIR_REVERSE) {
+            mode |= SEQUENCE_CODEC_REVERSE_FLAG;
+        }
+        packed->limbs_modes |= mode << (i * SEQUENCE_CODEC_LIMB_MODE_BITS);
+    }
+    if (motion->is_need_init_start_position) {
+        packed->limbs_modes |= SEQUENCE_CODEC_INIT_START_FLAG;
+    }
+
+    if (encode_time(motion->motion_time, &packed->motion_time) == false) return false;
+    if (encode_time(motion->time_stop,   &packed->time_stop)   == false) return false;
+    if (encode_time(motion->time_update, &packed->time_update) == false) return false;
+    if (encode_time(motion->time_step,   &packed->time_step)   == false) return false;
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Decode packed motion
+/// @param  packed: packed motion. @ref packed_motion_t
+/// @param  motion: motion configuration. @ref motion_config_t
+/// @retval motion
+/// @return none
+//  ***************************************************************************
+void sequence_codec_decode_motion(const packed_motion_t* packed, motion_config_t* motion) {
+
+    memset(motion, 0, sizeof(motion_config_t));
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+
+        motion->dest_positions[i].x = packed->dest_positions[i][0];
+        motion->dest_positions[i].y = packed->dest_positions[i][1];
+        motion->dest_positions[i].z = packed->dest_positions[i][2];
+
+        uint32_t mode = packed->limbs_modes >> (i * SEQUENCE_CODEC_LIMB_MODE_BITS);
+        motion->trajectories[i] = (trajectory_t)(mode & SEQUENCE_CODEC_TRAJECTORY_MASK);
+        motion->time_directions[i] = (mode & SEQUENCE_CODEC_REVERSE_FLAG) ? TIME_DIR_REVERSE : TIME_DIR_DIRECT;
+    }
+    motion->is_need_init_start_position = (packed->limbs_modes & SEQUENCE_CODEC_INIT_START_FLAG) != 0;
+
+    motion->motion_time = packed->motion_time;
+    motion->time_stop   = packed->time_stop;
+    motion->time_update = packed->time_update;
+    motion->time_step   = packed->time_step;
+}
+
+//  ***************************************************************************
+/// @brief  Calculate sequence image checksum
+/// @param  image: sequence image. @ref sequence_image_t
+/// @return bytes sum of image after checksum field
+//  ***************************************************************************
+uint16_t sequence_codec_calc_image_checksum(const sequence_image_t* image) {
+
+    const uint8_t* data = (const uint8_t*)image;
+    uint32_t size = image->image_size;
+    if (size > sizeof(sequence_image_t)) {
+        size = sizeof(sequence_image_t);
+    }
+
+    uint16_t checksum = 0;
+    for (uint32_t i = offsetof(sequence_image_t, image_size); i < size; ++i) {
+        checksum += data[i];
+    }
+    return checksum;
+}
+
+//  ***************************************************************************
+/// @brief  Check sequence image format
+/// @note   Header, checksum, sequences layout and motions time parameters
+///         are checked. Limbs positions are not checked (it depends on 
+///         limbs geometry)
+/// @param  image: sequence image. @ref sequence_image_t
+/// @return true - image is correct, false - otherwise
+//  ***************************************************************************
+bool sequence_codec_check_image(const sequence_image_t* image) {
+
+    if (image->magic != SEQUENCE_CODEC_IMAGE_MAGIC) {
+        return false;
+    }
+    if (image->sequences_count == 0 || image->sequences_count > SEQUENCE_CODEC_IMAGE_MAX_SEQUENCES ||
+        image->motions_count == 0 || image->motions_count > SEQUENCE_CODEC_IMAGE_MAX_MOTIONS) {
+        return false;
+    }
+    if (image->image_size != SEQUENCE_CODEC_IMAGE_SIZE(image->motions_count)) {
+        return false;
+    }
+    if (image->checksum != sequence_codec_calc_image_checksum(image)) {
+        return false;
+    }
+
+    uint32_t motions_count = 0;
+    for (uint32_t i = 0; i < image->sequences_count; ++i) {
+
+        const packed_sequence_header_t* header = &image->sequences[i];
+        if (header->flags & ~SEQUENCE_CODEC_IMAGE_LOOPED_FLAG) {
+            return false;
+        }
+        if (header->total_motions_count == 0 || header->total_motions_count > SEQUENCE_CODEC_MAX_MOTIONS_COUNT) {
+            return false;
+        }
+        if (header->main_motions_begin > header->finalize_motions_begin || header->finalize_motions_begin > header->total_motions_count) {
+            return false;
+        }
+        if ((header->flags & SEQUENCE_CODEC_IMAGE_LOOPED_FLAG) && header->main_motions_begin == header->finalize_motions_begin) {
+            return false; // Looped sequence without main motions
+        }
+        motions_count += header->total_motions_count;
+    }
+    if (motions_count != image->motions_count) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < image->motions_count; ++i) {
+        if (check_motion(&image->motions[i]) == false) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Get sequence of image
+/// @note   Image should be checked by sequence_codec_check_image(). Motion
+///         list of sequence points to image
+/// @param  image: sequence image. @ref sequence_image_t
+/// @param  index: sequence index
+/// @param  sequence: sequence. @ref packed_sequence_t
+/// @retval sequence
+/// @return none
+//  ***************************************************************************
+void sequence_codec_get_image_sequence(const sequence_image_t* image, uint32_t index, packed_sequence_t* sequence) {
+
+    uint32_t first_motion = 0;
+    for (uint32_t i = 0; i < index; ++i) {
+        first_motion += image->sequences[i].total_motions_count;
+    }
+
+    const packed_sequence_header_t* header = &image->sequences[index];
+    sequence->is_sequence_looped     = (header->flags & SEQUENCE_CODEC_IMAGE_LOOPED_FLAG) != 0;
+    sequence->main_motions_begin     = header->main_motions_begin;
+    sequence->finalize_motions_begin = header->finalize_motions_begin;
+    sequence->total_motions_count    = header->total_motions_count;
+    sequence->motion_list            = &image->motions[first_motion];
+}
+
+
+
+
+
+//  ***************************************************************************
+/// @brief  Encode position coordinate
+/// @param  value: coordinate, [mm]
+/// @param  encoded: encoded value
+/// @retval encoded
+/// @return true - success, false - value is not integer or out of range
+//  ***************************************************************************
+static bool encode_value(float value, int16_t* encoded) {
+
+    if (value < INT16_MIN || value > INT16_MAX || value != (float)(int32_t)value) {
+        return false;
+    }
+    *encoded = (int16_t)value;
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Encode motion time value
+/// @param  value: motion time value
+/// @param  encoded: encoded value
+/// @retval encoded
+/// @return true - success, false - value out of range
+//  ***************************************************************************
+static bool encode_time(int32_t value, int16_t* encoded) {
+
+    if (value < INT16_MIN || value > INT16_MAX) {
+        return false;
+    }
+    *encoded = (int16_t)value;
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Check packed motion
+/// @param  packed: packed motion. @ref packed_motion_t
+/// @return true - motion is correct, false - otherwise
+//  ***************************************************************************
+static bool check_motion(const packed_motion_t* packed) {
+
+    uint32_t modes_mask = (1UL << (SUPPORT_LIMBS_COUNT * SEQUENCE_CODEC_LIMB_MODE_BITS)) - 1;
+    if (packed->limbs_modes & ~(modes_mask | SEQUENCE_CODEC_INIT_START_FLAG)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        uint32_t mode = packed->limbs_modes >> (i * SEQUENCE_CODEC_LIMB_MODE_BITS);
+        if ((mode & SEQUENCE_CODEC_TRAJECTORY_MASK) > TRAJECTORY_JOINT_LINEAR) {
+            return false;
+        }
+    }
+
+    if (packed->motion_time < MTIME_MIN_VALUE || packed->motion_time >= packed->time_stop || packed->time_stop > MTIME_MAX_VALUE) {
+        return false;
+    }
+    if (packed->time_step <= 0) {
+        return false;
+    }
+    if (packed->time_update != MTIME_NO_UPDATE && (packed->time_update < MTIME_MIN_VALUE || packed->time_update > MTIME_MAX_VALUE)) {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,81 @@
+//  ***************************************************************************
+/// @file    sequence_codec.h
+/// @author  NeoProg
+/// @brief   Packed sequences format
+/// @note    Host compilable (no hardware dependencies). Packed motion is
+///          motion_config_t without runtime fields (start positions are
+///          initialized on motion start): integer positions, trajectory and
+///          time direction are bit fields. Sequence image is binary format
+///          of uploaded sequences (little-endian, same layout on host and MCU)
+//  ***************************************************************************
+#ifndef _SEQUENCE_CODEC_H_
+#define _SEQUENCE_CODEC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "motion_core.h"
+
+#define SEQUENCE_CODEC_LIMB_MODE_BITS       (5)         // Limb mode: trajectory (4 bits) and reverse time direction (1 bit)
+#define SEQUENCE_CODEC_TRAJECTORY_MASK      (0x0F)
+#define SEQUENCE_CODEC_REVERSE_FLAG         (0x10)
+#define SEQUENCE_CODEC_INIT_START_FLAG      (0x80000000)// Motion flag: is_need_init_start_position
+
+#define SEQUENCE_CODEC_MAX_MOTIONS_COUNT    (15)        // Max motions count of sequence
+
+#define SEQUENCE_CODEC_IMAGE_MAGIC          (0x5153)    // "SQ"
+#define SEQUENCE_CODEC_IMAGE_MAX_SEQUENCES  (4)         // Max sequences count of image
+#define SEQUENCE_CODEC_IMAGE_MAX_MOTIONS    (32)        // Max motions count of image (all sequences)
+#define SEQUENCE_CODEC_IMAGE_LOOPED_FLAG    (0x01)      // Sequence flag: is_sequence_looped
+#define SEQUENCE_CODEC_IMAGE_HEADER_SIZE    (offsetof(sequence_image_t, motions))
+#define SEQUENCE_CODEC_IMAGE_SIZE(motions)  (SEQUENCE_CODEC_IMAGE_HEADER_SIZE + (motions) * sizeof(packed_motion_t))
+
+
+#if SUPPORT_LIMBS_COUNT * SEQUENCE_CODEC_LIMB_MODE_BITS > 31
+#error "Limbs modes are not fit to packed motion"
+#endif
+
+
+typedef struct {
+    int16_t  dest_positions[SUPPORT_LIMBS_COUNT][3];    // Destination point for each limb (X, Y, Z), [mm]
+    uint32_t limbs_modes;                               // Limb mode by SEQUENCE_CODEC_LIMB_MODE_BITS for each limb and motion flags
+    int16_t  motion_time;
+    int16_t  time_stop;
+    int16_t  time_update;
+    int16_t  time_step;
+} packed_motion_t;
+
+typedef struct {
+    bool     is_sequence_looped;
+    uint8_t  main_motions_begin;
+    uint8_t  finalize_motions_begin;
+    uint8_t  total_motions_count;
+    const packed_motion_t* motion_list;                 // Variable length motion list (total_motions_count items)
+} packed_sequence_t;
+
+typedef struct {
+    uint8_t  flags;                                     // Sequence flags
+    uint8_t  main_motions_begin;
+    uint8_t  finalize_motions_begin;
+    uint8_t  total_motions_count;
+} packed_sequence_header_t;
+
+typedef struct {
+    uint16_t magic;                                     // SEQUENCE_CODEC_IMAGE_MAGIC
+    uint16_t checksum;                                  // Bytes sum of image after checksum field
+    uint16_t image_size;                                // Image size with header, [bytes]
+    uint8_t  sequences_count;
+    uint8_t  motions_count;
+    packed_sequence_header_t sequences[SEQUENCE_CODEC_IMAGE_MAX_SEQUENCES];
+    packed_motion_t motions[SEQUENCE_CODEC_IMAGE_MAX_MOTIONS]; // Variable length motion list (motions_count items), sequences motions follow each other
+} sequence_image_t;
+
+
+extern bool sequence_codec_encode_motion(const motion_config_t* motion, packed_motion_t* packed);
+extern void sequence_codec_decode_motion(const packed_motion_t* packed, motion_config_t* motion);
+extern uint16_t sequence_codec_calc_image_checksum(const sequence_image_t* image);
+extern bool sequence_codec_check_image(const sequence_image_t* image);
+extern void sequence_codec_get_image_sequence(const sequence_image_t* image, uint32_t index, packed_sequence_t* sequence);
+
+
+#endif // _SEQUENCE_CODEC_H_
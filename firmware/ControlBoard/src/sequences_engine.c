@@ -5,11 +5,21 @@
 #include "sequences_engine.h"
 #include "project_base.h"
 #include "motion_core.h"
-#include "gait_sequences.h"
+#if ROBOT_LIMBS_COUNT == 6
+#include "gait_sequences_packed.h"
+#else
+#include "gait_sequences_packed_quadruped.h"
+#endif
+#include "sequence_codec.h"
+#include "sequences_storage.h"
+#include "transition_planner.h"
+#include "gait_generator.h"
 #include "system_monitor.h"
 #include "systimer.h"
+#include "pwm.h"
 
 #define AUTO_SELECT_DOWN_SEQUENCE_TIME              (20000) // 20s
+#define SCHEDULE_SELECT_MARGIN                      (2)     // Sequence change processing time, [PWM periods]
 
 
 typedef enum {
@@ -24,7 +34,8 @@ typedef enum {
 typedef enum {
     STAGE_PREPARE,
     STAGE_MAIN,
-    STAGE_FINALIZE
+    STAGE_FINALIZE,
+    STAGE_BRIDGE            // Bridge motion between sequences (transition planner)
 } stage_t;
 
 typedef enum {
@@ -32,15 +43,65 @@ typedef enum {
     HEXAPOD_STATE_UP
 } hexapod_state_t;
 
+typedef struct {
+    bool     is_sequence_looped;
+    uint32_t main_motions_begin;
+    uint32_t finalize_motions_begin;
+    uint32_t total_motions_count;
+    const motion_config_t* motion_list;         // Unpacked motion list (walk sequences)
+    const packed_motion_t* packed_motion_list;  // Packed motion list (sequences tables). Motions are decoded on start
+} sequence_view_t;
+
 
 static engine_state_t engine_state = STATE_NOINIT;
 static hexapod_state_t hexapod_state = HEXAPOD_STATE_DOWN;
 
 static sequence_id_t current_sequence = SEQUENCE_NONE;
-static const sequence_info_t* current_sequence_info = NULL;
+static sequence_view_t current_sequence_info = {0};
+static const packed_sequence_t* current_packed_sequence = NULL; // NULL for walk sequences
+static gait_type_t current_gait = GAIT_TRIPOD;
 
 static sequence_id_t next_sequence = SEQUENCE_NONE;
-static const sequence_info_t* next_sequence_info = NULL;
+static const packed_sequence_t* next_sequence_info = NULL; // NULL for walk sequences
+static gait_type_t next_gait = GAIT_TRIPOD;
+static int32_t next_walk_curvature = 0;
+static int32_t next_walk_step_length = 0;
+
+static motion_config_t walk_motion_list[GAIT_TOTAL_MOTIONS_COUNT] = {0};
+static motion_config_t current_motion_config = {0};    // Decoded motion of packed sequence
+static motion_config_t next_motion_config = {0};
+static motion_config_t bridge_motion_config = {0};
+
+static uint8_t transitions[SUPPORT_SEQUENCE_COUNT][SUPPORT_SEQUENCE_COUNT] = {0}; // Planned transitions [from][to] by TRANSITION_xxx
+static uint8_t active_transition = TRANSITION_DEFAULT;
+static sequence_id_t transition_target = SEQUENCE_NONE;     // Destination sequence of active transition
+
+static uint64_t command_time = 0;           // Time of last not processed command. 0 - no command
+static bool is_response_motion = false;     // Next motion is reaction on command
+
+static bool is_schedule_pending = false;    // Scheduled sequence is not selected yet
+static bool is_schedule_selected = false;   // Scheduled sequence is selected, wait while it loaded
+static bool is_schedule_start = false;      // Next motion is first motion of scheduled sequence
+static sequence_id_t scheduled_sequence = SEQUENCE_NONE;
+static int32_t scheduled_curvature = 0;
+static int32_t scheduled_step_length = 0;
+static float scheduled_speed = 0;           // Speed multiplier from first motion. 0 - do not change
+static uint64_t scheduled_start_period = 0; // First motion start, [PWM periods]
+static float scheduled_start_offset = 0;    // Part of PWM period elapsed from start time on start period
+
+
+static bool is_sequence_change_needed(void);
+static bool is_sequence_preemptible(void);
+static const motion_config_t* get_preemptive_finalize(motion_config_t* buffer);
+static void process_schedule(stage_t stage, uint32_t motion);
+static uint32_t get_change_periods(stage_t stage, uint32_t motion);
+static uint32_t get_motions_periods(uint32_t begin, uint32_t end);
+static const motion_config_t* get_next_motion(stage_t stage, uint32_t motion);
+static const motion_config_t* get_motion(uint32_t motion, motion_config_t* buffer);
+static uint8_t get_transition(void);
+static const motion_config_t* get_transition_motion(uint8_t transition, motion_config_t* buffer);
+static const packed_sequence_t* get_packed_sequence(sequence_id_t sequence);
+static bool load_next_sequence(void);
 
 
 //  ***************************************************************************
@@ -52,14 +113,17 @@ void sequences_engine_init(void) {
 
     // Select DOWN sequence as start position
     current_sequence      = SEQUENCE_DOWN;
-    current_sequence_info = &sequence_down;
     next_sequence         = SEQUENCE_DOWN;
     next_sequence_info    = &sequence_down;
     hexapod_state         = HEXAPOD_STATE_DOWN;
+    load_next_sequence();
     
     // Initialize motion driver
     uint32_t last_motion_index = sequence_down.total_motions_count - 1;
-    motion_core_init(sequence_down.motion_list[last_motion_index].dest_positions);
+    motion_core_init(get_motion(last_motion_index, &current_motion_config)->dest_positions);
+    
+    // Plan transitions between sequences (limbs reachability is checked by motion core)
+    sequences_engine_update_transitions();
     
     // Initialization engine state
     engine_state = STATE_IDLE;
@@ -78,11 +142,18 @@ void sequences_engine_process(void) {
     static stage_t sequence_stage = STAGE_PREPARE;
     static uint32_t current_motion = 0;
     static uint64_t prev_active_time = 0;
+    static uint64_t prev_schedule_period = 0;
+    
+    // Scheduled sequence is selected when change of current sequence should be started
+    if (is_schedule_pending == true && synchro != prev_schedule_period && engine_state != STATE_NOINIT) {
+        prev_schedule_period = synchro;
+        process_schedule(sequence_stage, current_motion);
+    }
 
     switch (engine_state) {
         
         case STATE_IDLE:
-            if (current_sequence != next_sequence) {
+            if (is_sequence_change_needed() == true) {
                 engine_state = STATE_CHANGE_SEQUENCE;
             }
             else {
@@ -94,8 +165,25 @@ void sequences_engine_process(void) {
             break;
         
         case STATE_MOVE:
-            for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
-                motion_core_start_motion(&current_sequence_info->motion_list[current_motion]);
+            if (is_response_motion == true && command_time != 0) {
+                motion_core_mark_command(command_time);
+                command_time = 0;
+            }
+            is_response_motion = false;
+            if (is_schedule_start == true) {
+                // First motion of scheduled sequence waits start time in motion core
+                if (scheduled_speed != 0) {
+                    motion_core_set_speed_multiplier(scheduled_speed);
+                }
+                motion_core_schedule_start(scheduled_start_period, scheduled_start_offset);
+                is_schedule_start = false;
+            }
+            motion_core_set_next_motion(get_next_motion(sequence_stage, current_motion));
+            if (sequence_stage == STAGE_BRIDGE) {
+                motion_core_start_motion(&bridge_motion_config);
+            }
+            else {
+                motion_core_start_motion(get_motion(current_motion, &current_motion_config));
             }
             engine_state = STATE_WAIT;
             break;
@@ -104,46 +192,110 @@ void sequences_engine_process(void) {
             if (motion_core_is_motion_complete() == true) {
                 engine_state = STATE_NEXT_MOTION;
             }
+            else if (sequence_stage != STAGE_FINALIZE && sequence_stage != STAGE_BRIDGE && is_sequence_change_needed() == true && is_sequence_preemptible() == true) {
+                
+                if (command_time != 0) {
+                    motion_core_mark_command(command_time);
+                    command_time = 0;
+                }
+                
+                // Interrupt current motion and go to bridge motion if it planned. Other transitions
+                // are valid after main motions only, go to finalize motions from current limbs positions
+                active_transition = get_transition() & TRANSITION_BRIDGE_USED;
+                transition_target = next_sequence;
+                if (active_transition & TRANSITION_BRIDGE_USED) {
+                    sequence_stage = STAGE_BRIDGE;
+                    motion_core_preempt_motion(&bridge_motion_config);
+                }
+                else {
+                    current_motion = current_sequence_info.finalize_motions_begin;
+                    sequence_stage = STAGE_FINALIZE;
+                    motion_core_preempt_motion(get_motion(current_motion, &current_motion_config));
+                }
+            }
             break;
             
         case STATE_NEXT_MOTION:
+            if (sequence_stage == STAGE_BRIDGE) {
+                engine_state = STATE_CHANGE_SEQUENCE;
+                break;
+            }
             ++current_motion;
             engine_state = STATE_MOVE;
             
-            if (sequence_stage == STAGE_PREPARE && current_motion >= current_sequence_info->main_motions_begin) {
+            if (sequence_stage == STAGE_PREPARE && current_motion >= current_sequence_info.main_motions_begin) {
                 sequence_stage = STAGE_MAIN;
             }
-            if (sequence_stage == STAGE_MAIN && current_motion >= current_sequence_info->finalize_motions_begin) {
+            if (sequence_stage == STAGE_MAIN && current_motion >= current_sequence_info.finalize_motions_begin) {
                 
-                if (current_sequence != next_sequence) { 
-                    // Need change current sequence - go to finalize motions if it available
-                    current_motion = current_sequence_info->finalize_motions_begin;
-                    sequence_stage = STAGE_FINALIZE;
+                if (is_sequence_change_needed() == true) { 
+                    active_transition = get_transition();
+                    transition_target = next_sequence;
+                    if (active_transition & TRANSITION_BRIDGE_USED) {
+                        // Finalize and prepare motions are merged - go to bridge motion
+                        sequence_stage = STAGE_BRIDGE;
+                        is_response_motion = true;
+                    }
+                    else if (active_transition & TRANSITION_FINALIZE_SKIPPED) {
+                        // Next sequence can be started from current pose
+                        engine_state = STATE_CHANGE_SEQUENCE;
+                    }
+                    else {
+                        // Need change current sequence - go to finalize motions if it available
+                        current_motion = current_sequence_info.finalize_motions_begin;
+                        sequence_stage = STAGE_FINALIZE;
+                        is_response_motion = true;
+                    }
                 }
                 else {
                     
-                    if (current_sequence_info->is_sequence_looped == true) {
-                        current_motion = current_sequence_info->main_motions_begin;
+                    if (current_sequence_info.is_sequence_looped == true) {
+                        current_motion = current_sequence_info.main_motions_begin;
                     }
                     else {
-                        // Not looped sequence completed and new sequence not selected
+                        // Not looped sequence completed and new sequence not selected. Hexapod state is
+                        // updated same as after finalize motions, next sequence can be selected from idle
                         sequences_engine_select_sequence(SEQUENCE_NONE, 0, 0);
                         engine_state = STATE_CHANGE_SEQUENCE;
+                        hexapod_state = (current_sequence == SEQUENCE_DOWN) ? HEXAPOD_STATE_DOWN : HEXAPOD_STATE_UP;
                     }
                 }              
             }
-            if (sequence_stage == STAGE_FINALIZE && current_motion >= current_sequence_info->total_motions_count) {
+            if (sequence_stage == STAGE_FINALIZE && current_motion >= current_sequence_info.total_motions_count) {
                 engine_state = STATE_CHANGE_SEQUENCE;
                 hexapod_state = (current_sequence == SEQUENCE_DOWN) ? HEXAPOD_STATE_DOWN : HEXAPOD_STATE_UP;
             }    
             break;
 
         case STATE_CHANGE_SEQUENCE:
-            current_sequence      = next_sequence;
-            current_sequence_info = next_sequence_info;
+            if (active_transition != TRANSITION_DEFAULT && next_sequence != transition_target) {
+                
+                // Other sequence is selected while transition - finalize current sequence from current limbs positions
+                active_transition = TRANSITION_DEFAULT;
+                if (current_sequence_info.finalize_motions_begin < current_sequence_info.total_motions_count) {
+                    current_motion = current_sequence_info.finalize_motions_begin;
+                    sequence_stage = STAGE_FINALIZE;
+                    engine_state = STATE_MOVE;
+                    break;
+                }
+            }
+            if (load_next_sequence() == false) {
+                sysmon_set_error(SYSMON_MATH_ERROR);
+                sysmon_disable_module(SYSMON_MODULE_SEQUENCES_ENGINE);
+                break;
+            }
             current_motion        = 0;
             sequence_stage        = STAGE_PREPARE;
             engine_state          = STATE_MOVE;
+            is_response_motion    = true;
+            is_schedule_start     = is_schedule_selected && current_sequence == scheduled_sequence && current_sequence != SEQUENCE_NONE;
+            is_schedule_selected  = false;
+            
+            if (active_transition & (TRANSITION_PREPARE_SKIPPED | TRANSITION_BRIDGE_USED)) {
+                current_motion = current_sequence_info.main_motions_begin;
+                sequence_stage = STAGE_MAIN;
+            }
+            active_transition = TRANSITION_DEFAULT;
             
             motion_core_reset_trajectory_config();
             
@@ -170,6 +322,7 @@ void sequences_engine_process(void) {
 //  ***************************************************************************
 void sequences_engine_select_sequence(sequence_id_t sequence, int32_t curvature, int32_t step_length) {
     
+    sequence_id_t prev_next_sequence = next_sequence;
     switch (sequence) {
         
         case SEQUENCE_NONE:
@@ -192,7 +345,9 @@ void sequences_engine_select_sequence(sequence_id_t sequence, int32_t curvature,
         case SEQUENCE_DIRECT:
             if (hexapod_state == HEXAPOD_STATE_UP) {
                 next_sequence = SEQUENCE_DIRECT;
-                next_sequence_info = &sequence_direct;
+                next_sequence_info = NULL;
+                next_walk_curvature = curvature;
+                next_walk_step_length = step_length;
                 motion_core_update_trajectory_config(curvature, step_length);
             }
             break;
@@ -200,11 +355,14 @@ void sequences_engine_select_sequence(sequence_id_t sequence, int32_t curvature,
         case SEQUENCE_REVERSE: 
             if (hexapod_state == HEXAPOD_STATE_UP) {
                 next_sequence = SEQUENCE_REVERSE;
-                next_sequence_info = &sequence_reverse;
+                next_sequence_info = NULL;
+                next_walk_curvature = curvature;
+                next_walk_step_length = step_length;
                 motion_core_update_trajectory_config(curvature, step_length);
             }
             break;
     
+#if ROBOT_LIMBS_COUNT == 6
         case SEQUENCE_UP_DOWN: 
             if (hexapod_state == HEXAPOD_STATE_UP) {
                 next_sequence = SEQUENCE_UP_DOWN;
@@ -254,10 +412,477 @@ void sequences_engine_select_sequence(sequence_id_t sequence, int32_t curvature,
                 next_sequence_info = &sequence_rotate_z;
             }
             break;
+#else
+        case SEQUENCE_UP_DOWN:
+        case SEQUENCE_PUSH_PULL:
+        case SEQUENCE_ATTACK_LEFT:
+        case SEQUENCE_ATTACK_RIGHT:
+        case SEQUENCE_DANCE:
+        case SEQUENCE_ROTATE_X:
+        case SEQUENCE_ROTATE_Z:
+            break; // Sequences tables are hexapod only, other robots use uploaded sequences
+#endif
+            
+        case SEQUENCE_USER_0:
+        case SEQUENCE_USER_1:
+        case SEQUENCE_USER_2:
+        case SEQUENCE_USER_3:
+            if (hexapod_state == HEXAPOD_STATE_UP) {
+                const packed_sequence_t* info = sequences_storage_get_sequence(sequence - SEQUENCE_USER_0);
+                if (info != NULL) {
+                    next_sequence = sequence;
+                    next_sequence_info = info;
+                }
+            }
+            break;
             
         default:
             sysmon_set_error(SYSMON_FATAL_ERROR);
             sysmon_disable_module(SYSMON_MODULE_SEQUENCES_ENGINE);
             return;
     }
+    
+    // Save command time for latency measure
+    if (next_sequence != prev_next_sequence && command_time == 0) {
+        command_time = get_time_ms();
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Select gait for walk sequences
+/// @note   Gait is changed after finalize motions of current walk sequence
+/// @param  gait: gait type
+/// @return none
+//  ***************************************************************************
+void sequences_engine_select_gait(gait_type_t gait) {
+    if (gait < SUPPORT_GAIT_COUNT && gait != next_gait) {
+        next_gait = gait;
+        if (command_time == 0) {
+            command_time = get_time_ms();
+        }
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Schedule sequence start
+/// @note   Sequence is selected ahead when change of current sequence 
+///         (preemption, finalize motions) should be started for start first
+///         motion of it at start time. First motion waits start time in motion
+///         core if transition is completed earlier. Selection is repeated up
+///         to start time if sequence is not available in current state
+/// @param  sequence: new sequence
+/// @param  curvature: curvature value for DIRECT\REVERSE sequences
+/// @param  step_length: step length value for DIRECT\REVERSE sequences
+/// @param  speed: speed multiplier from first motion of sequence. 0 - do not change
+/// @param  start_period: first motion start, [PWM periods] (synchro)
+/// @param  start_offset: part of PWM period elapsed from start time on start period [0; 1)
+/// @return none
+//  ***************************************************************************
+void sequences_engine_schedule_sequence(sequence_id_t sequence, int32_t curvature, int32_t step_length, float speed, uint64_t start_period, float start_offset) {
+    
+    scheduled_sequence     = sequence;
+    scheduled_curvature    = curvature;
+    scheduled_step_length  = step_length;
+    scheduled_speed        = speed;
+    scheduled_start_period = start_period;
+    scheduled_start_offset = start_offset;
+    is_schedule_pending    = true;
+    is_schedule_selected   = false;
+    is_schedule_start      = false;
+}
+
+//  ***************************************************************************
+/// @brief  Check scheduled sequence is not started yet
+/// @param  none
+/// @return true - scheduled sequence is not started, false - started or no schedule
+//  ***************************************************************************
+bool sequences_engine_is_sequence_scheduled(void) {
+    return is_schedule_pending || is_schedule_selected || is_schedule_start || motion_core_is_start_scheduled();
+}
+
+//  ***************************************************************************
+/// @brief  Cancel scheduled sequence start
+/// @note   Selected sequence is not changed, its first motion is started 
+///         without wait
+/// @param  none
+/// @return none
+//  ***************************************************************************
+void sequences_engine_cancel_schedule(void) {
+    is_schedule_pending  = false;
+    is_schedule_selected = false;
+    is_schedule_start    = false;
+    motion_core_schedule_start(0, 0);
+}
+
+//  ***************************************************************************
+/// @brief  Check uploaded sequence is current or selected
+/// @note   Uploaded sequences cache should not be changed while it is used
+/// @param  none
+/// @return true - uploaded sequence is active, false - no
+//  ***************************************************************************
+bool sequences_engine_is_uploaded_sequence_active(void) {
+    
+    return (current_sequence >= SEQUENCE_USER_0 && current_sequence <= SEQUENCE_USER_3) ||
+           (next_sequence >= SEQUENCE_USER_0 && next_sequence <= SEQUENCE_USER_3);
+}
+
+//  ***************************************************************************
+/// @brief  Update transitions between sequences
+/// @note   Transitions are planned for packed sequences only and should be
+///         updated after uploaded sequences change. Posture and walk
+///         sequences always use finalize and prepare motions
+/// @param  none
+/// @return none
+//  ***************************************************************************
+void sequences_engine_update_transitions(void) {
+    
+    for (uint32_t from = 0; from < SUPPORT_SEQUENCE_COUNT; ++from) {
+        for (uint32_t to = 0; to < SUPPORT_SEQUENCE_COUNT; ++to) {
+            transitions[from][to] = transition_planner_plan(get_packed_sequence((sequence_id_t)from), get_packed_sequence((sequence_id_t)to),
+                                                            sequence_walk_neutral_positions);
+        }
+    }
+}
+
+
+
+
+
+//  ***************************************************************************
+/// @brief  Check need change current sequence
+/// @param  none
+/// @return true - need change, false - no
+//  ***************************************************************************
+static bool is_sequence_change_needed(void) {
+    
+    if (current_sequence != next_sequence) {
+        return true;
+    }
+    if (current_sequence == SEQUENCE_DIRECT || current_sequence == SEQUENCE_REVERSE) {
+        return current_gait != next_gait;
+    }
+    return false;
+}
+
+//  ***************************************************************************
+/// @brief  Check current sequence can be interrupted at any motion time
+/// @note   First finalize motion should start from current limbs positions
+///         and use linear or joint space trajectories. Limbs which are held
+///         by it should not be lifted by current motion
+/// @param  none
+/// @return true - sequence is preemptible now, false - no
+//  ***************************************************************************
+static bool is_sequence_preemptible(void) {
+    
+    motion_config_t buffer;
+    const motion_config_t* motion = get_preemptive_finalize(&buffer);
+    if (motion == NULL) {
+        return false;
+    }
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        
+        // Held limbs stay in current positions while other limbs are moved (walk finalize moves
+        // support groups by turns). They should be on ground, wait for stance if limb is lifted
+        if (motion->trajectories[i] == TRAJECTORY_XYZ_HOLD && motion_core_is_limb_lifted(i) == true) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Get first finalize motion which can interrupt current sequence
+/// @note   Motion should start from current limbs positions and use linear
+///         or joint space trajectories. Lifted limbs are not checked
+/// @param  buffer: buffer for decoded motion
+/// @retval buffer
+/// @return motion configuration or NULL if sequence is not preemptible
+//  ***************************************************************************
+static const motion_config_t* get_preemptive_finalize(motion_config_t* buffer) {
+    
+    if (current_sequence_info.finalize_motions_begin >= current_sequence_info.total_motions_count) {
+        return NULL; // No finalize motions
+    }
+    
+    const motion_config_t* motion = get_motion(current_sequence_info.finalize_motions_begin, buffer);
+    if (motion->is_need_init_start_position == false) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+        if (motion->trajectories[i] != TRAJECTORY_XYZ_LINEAR &&
+            motion->trajectories[i] != TRAJECTORY_XYZ_LINEAR_LIFT &&
+            motion->trajectories[i] != TRAJECTORY_XYZ_HOLD &&
+            motion->trajectories[i] != TRAJECTORY_JOINT_LINEAR) {
+            return NULL;
+        }
+    }
+    return motion;
+}
+
+//  ***************************************************************************
+/// @brief  Select scheduled sequence if change should be started now
+/// @note   Call once per PWM period
+/// @param  stage: current sequence stage
+/// @param  motion: current motion index
+/// @return none
+//  ***************************************************************************
+static void process_schedule(stage_t stage, uint32_t motion) {
+    
+    if (synchro + get_change_periods(stage, motion) + SCHEDULE_SELECT_MARGIN < scheduled_start_period) {
+        return; // Current sequence is continued
+    }
+    
+    sequences_engine_select_sequence(scheduled_sequence, scheduled_curvature, scheduled_step_length);
+    bool is_selected = (next_sequence == scheduled_sequence);
+    if (is_selected == false && synchro < scheduled_start_period) {
+        return; // Sequence is not available in current state, try again
+    }
+    is_schedule_pending = false;
+    is_schedule_selected = is_selected && is_sequence_change_needed();
+    if (is_selected == true && is_schedule_selected == false && scheduled_speed != 0) {
+        motion_core_set_speed_multiplier(scheduled_speed); // Current sequence is continued with new parameters
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Get periods from scheduled sequence selection to start of it
+/// @note   Estimate is not less real time: preemption is delayed while any
+///         held limb is lifted on next ticks and looped sequence which is 
+///         not preemptible is changed on next main loop if it is not 
+///         selected now. Finalize motions are counted if finalize is skipped
+/// @param  stage: current sequence stage
+/// @param  motion: current motion index
+/// @return PWM periods
+//  ***************************************************************************
+static uint32_t get_change_periods(stage_t stage, uint32_t motion) {
+    
+    bool is_walk = (current_sequence == SEQUENCE_DIRECT || current_sequence == SEQUENCE_REVERSE);
+    if (engine_state == STATE_IDLE || current_sequence == SEQUENCE_NONE) {
+        return 0;
+    }
+    if (scheduled_sequence == current_sequence && next_sequence == current_sequence && (is_walk == false || next_gait == current_gait)) {
+        return 0; // Sequence is not changed, parameters are applied on selection
+    }
+    
+    uint32_t periods = motion_core_get_remaining_periods();
+    uint32_t finalize_begin = current_sequence_info.finalize_motions_begin;
+    uint32_t total = current_sequence_info.total_motions_count;
+    if (stage == STAGE_BRIDGE) {
+        return periods;
+    }
+    if (stage == STAGE_FINALIZE) {
+        return periods + get_motions_periods(motion + 1, total);
+    }
+    
+    // Transition by bridge motion or finalize motions. Preemptive motion starts from current limbs positions
+    motion_config_t finalize_buffer;
+    motion_config_t bridge;
+    const motion_config_t* finalize = get_preemptive_finalize(&finalize_buffer);
+    bool is_preempt = (finalize != NULL);
+    uint32_t transition_periods = 0;
+    if ((transitions[current_sequence][scheduled_sequence] & TRANSITION_BRIDGE_USED) &&
+        transition_planner_build_bridge(current_packed_sequence, get_packed_sequence(scheduled_sequence), sequence_walk_neutral_positions, &bridge) == true) {
+        transition_periods = motion_core_get_motion_periods(&bridge, is_preempt);
+    }
+    else if (is_preempt == true) {
+        transition_periods = motion_core_get_motion_periods(finalize, true) + get_motions_periods(finalize_begin + 1, total);
+    }
+    else {
+        transition_periods = get_motions_periods(finalize_begin, total);
+    }
+    
+    // Wait held limbs landing and interrupt current motion
+    if (is_preempt == true) {
+        uint32_t held_limbs_mask = 0;
+        for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+            if (finalize->trajectories[i] == TRAJECTORY_XYZ_HOLD) {
+                held_limbs_mask |= (0x01 << i);
+            }
+        }
+        return motion_core_get_ground_periods(held_limbs_mask) + transition_periods;
+    }
+    
+    // Sequence is changed after main motions
+    periods += get_motions_periods(motion + 1, finalize_begin);
+    if (current_sequence_info.is_sequence_looped == true) {
+        periods += get_motions_periods(current_sequence_info.main_motions_begin, finalize_begin);
+    }
+    return periods + transition_periods;
+}
+
+//  ***************************************************************************
+/// @brief  Get duration of current sequence motions
+/// @param  begin: first motion index
+/// @param  end: motion index after last motion
+/// @return PWM periods
+//  ***************************************************************************
+static uint32_t get_motions_periods(uint32_t begin, uint32_t end) {
+    
+    uint32_t periods = 0;
+    for (uint32_t i = begin; i < end; ++i) {
+        motion_config_t buffer;
+        periods += motion_core_get_motion_periods(get_motion(i, &buffer), false);
+    }
+    return periods;
+}
+
+//  ***************************************************************************
+/// @brief  Get motion which will be started after current motion
+/// @note   Same logic as STATE_NEXT_MOTION, used for spline trajectories
+/// @param  stage: current sequence stage
+/// @param  motion: current motion index
+/// @return next motion or NULL if it unknown
+//  ***************************************************************************
+static const motion_config_t* get_next_motion(stage_t stage, uint32_t motion) {
+    
+    if (stage == STAGE_BRIDGE) {
+        return (next_sequence == transition_target) ? get_transition_motion(active_transition, &next_motion_config) : NULL;
+    }
+    
+    uint32_t next_motion = motion + 1;
+    if (stage != STAGE_FINALIZE && next_motion >= current_sequence_info.finalize_motions_begin) {
+        if (is_sequence_change_needed() == true) {
+            uint8_t transition = get_transition();
+            if (transition & TRANSITION_BRIDGE_USED) {
+                return &bridge_motion_config;
+            }
+            if (transition & TRANSITION_FINALIZE_SKIPPED) {
+                return get_transition_motion(transition, &next_motion_config);
+            }
+            next_motion = current_sequence_info.finalize_motions_begin;
+        }
+        else if (current_sequence_info.is_sequence_looped == true) {
+            next_motion = current_sequence_info.main_motions_begin;
+        }
+        else {
+            return NULL;
+        }
+    }
+    if (next_motion >= current_sequence_info.total_motions_count) {
+        return NULL;
+    }
+    return get_motion(next_motion, &next_motion_config);
+}
+
+//  ***************************************************************************
+/// @brief  Get motion of current sequence
+/// @note   Motion of packed sequence is decoded to buffer
+/// @param  motion: motion index
+/// @param  buffer: buffer for decoded motion
+/// @retval buffer
+/// @return motion configuration
+//  ***************************************************************************
+static const motion_config_t* get_motion(uint32_t motion, motion_config_t* buffer) {
+    
+    if (current_sequence_info.packed_motion_list == NULL) {
+        return &current_sequence_info.motion_list[motion];
+    }
+    sequence_codec_decode_motion(&current_sequence_info.packed_motion_list[motion], buffer);
+    return buffer;
+}
+
+//  ***************************************************************************
+/// @brief  Get planned transition from current to next sequence
+/// @note   Bridge motion is built to bridge_motion_config
+/// @param  none
+/// @return transition flags by TRANSITION_xxx
+//  ***************************************************************************
+static uint8_t get_transition(void) {
+    
+    if (current_sequence == next_sequence) {
+        return TRANSITION_DEFAULT; // Gait change
+    }
+    uint8_t transition = transitions[current_sequence][next_sequence];
+    if (transition & TRANSITION_BRIDGE_USED) {
+        if (transition_planner_build_bridge(current_packed_sequence, next_sequence_info, sequence_walk_neutral_positions, &bridge_motion_config) == false) {
+            return TRANSITION_DEFAULT;
+        }
+    }
+    return transition;
+}
+
+//  ***************************************************************************
+/// @brief  Get first motion of next sequence after transition
+/// @param  transition: transition flags by TRANSITION_xxx
+/// @param  buffer: buffer for decoded motion
+/// @retval buffer
+/// @return motion configuration
+//  ***************************************************************************
+static const motion_config_t* get_transition_motion(uint8_t transition, motion_config_t* buffer) {
+    
+    uint32_t motion = 0;
+    if (transition & (TRANSITION_PREPARE_SKIPPED | TRANSITION_BRIDGE_USED)) {
+        motion = next_sequence_info->main_motions_begin;
+    }
+    sequence_codec_decode_motion(&next_sequence_info->motion_list[motion], buffer);
+    return buffer;
+}
+
+//  ***************************************************************************
+/// @brief  Get packed sequence by identifier
+/// @param  sequence: sequence identifier
+/// @return sequence or NULL if sequence is not packed or not uploaded
+//  ***************************************************************************
+static const packed_sequence_t* get_packed_sequence(sequence_id_t sequence) {
+    
+    switch (sequence) {
+#if ROBOT_LIMBS_COUNT == 6
+        case SEQUENCE_UP_DOWN:      return &sequence_up_down;
+        case SEQUENCE_PUSH_PULL:    return &sequence_push_pull;
+        case SEQUENCE_ATTACK_LEFT:  return &sequence_attack_left;
+        case SEQUENCE_ATTACK_RIGHT: return &sequence_attack_right;
+        case SEQUENCE_DANCE:        return &sequence_dance;
+        case SEQUENCE_ROTATE_X:     return &sequence_rotate_x;
+        case SEQUENCE_ROTATE_Z:     return &sequence_rotate_z;
+#endif
+        case SEQUENCE_USER_0:
+        case SEQUENCE_USER_1:
+        case SEQUENCE_USER_2:
+        case SEQUENCE_USER_3:       return sequences_storage_get_sequence(sequence - SEQUENCE_USER_0);
+        default:                    return NULL; // Posture and walk sequences
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Make next sequence current
+/// @note   Walk sequences are generated by gait generator, other sequences
+///         are packed (motions are decoded on start)
+/// @param  none
+/// @return true - success, false - no
+//  ***************************************************************************
+static bool load_next_sequence(void) {
+    
+    current_sequence = next_sequence;
+    current_gait = next_gait;
+    current_packed_sequence = next_sequence_info;
+    
+    if (next_sequence == SEQUENCE_DIRECT || next_sequence == SEQUENCE_REVERSE) {
+        time_dir_t direction = (next_sequence == SEQUENCE_DIRECT) ? TIME_DIR_DIRECT : TIME_DIR_REVERSE;
+        if (gait_generator_build_sequence(current_gait, direction, next_walk_curvature, next_walk_step_length, 
+                                          sequence_walk_neutral_positions, walk_motion_list) == false) {
+            return false;
+        }
+        motion_core_set_gait_params(gait_generator_get_params(current_gait));
+        
+        current_sequence_info.is_sequence_looped     = true;
+        current_sequence_info.main_motions_begin     = GAIT_PREPARE_MOTIONS_COUNT;
+        current_sequence_info.finalize_motions_begin = GAIT_PREPARE_MOTIONS_COUNT + GAIT_MAIN_MOTIONS_COUNT;
+        current_sequence_info.total_motions_count    = GAIT_TOTAL_MOTIONS_COUNT;
+        current_sequence_info.motion_list            = walk_motion_list;
+        current_sequence_info.packed_motion_list     = NULL;
+        return true;
+    }
+    
+    if (next_sequence_info == NULL) {
+        current_sequence_info.motion_list = NULL; // SEQUENCE_NONE
+        current_sequence_info.packed_motion_list = NULL;
+        return true;
+    }
+    current_sequence_info.is_sequence_looped     = next_sequence_info->is_sequence_looped;
+    current_sequence_info.main_motions_begin     = next_sequence_info->main_motions_begin;
+    current_sequence_info.finalize_motions_begin = next_sequence_info->finalize_motions_begin;
+    current_sequence_info.total_motions_count    = next_sequence_info->total_motions_count;
+    current_sequence_info.motion_list            = NULL;
+    current_sequence_info.packed_motion_list     = next_sequence_info->motion_list;
+    return true;
 }
@@ -7,6 +7,8 @@
 #define _SEQUENCES_ENGINE_H_
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "gait_generator.h"
 
 
 typedef enum {
@@ -25,6 +27,12 @@ typedef enum {
     SEQUENCE_ROTATE_X,
     SEQUENCE_ROTATE_Z,
     
+    // Uploaded sequences (sequences storage, SEQUENCE_CODEC_IMAGE_MAX_SEQUENCES items)
+    SEQUENCE_USER_0,
+    SEQUENCE_USER_1,
+    SEQUENCE_USER_2,
+    SEQUENCE_USER_3,
+    
     SUPPORT_SEQUENCE_COUNT
 } sequence_id_t;
 
@@ -32,6 +40,12 @@ typedef enum {
 extern void sequences_engine_init(void);
 extern void sequences_engine_process(void);
 extern void sequences_engine_select_sequence(sequence_id_t sequence, int32_t curvature, int32_t step_length);
+extern void sequences_engine_select_gait(gait_type_t gait);
+extern void sequences_engine_schedule_sequence(sequence_id_t sequence, int32_t curvature, int32_t step_length, float speed, uint64_t start_period, float start_offset);
+extern bool sequences_engine_is_sequence_scheduled(void);
+extern void sequences_engine_cancel_schedule(void);
+extern bool sequences_engine_is_uploaded_sequence_active(void);
+extern void sequences_engine_update_transitions(void);
 
 
 #endif /* _SEQUENCES_ENGINE_H_ */
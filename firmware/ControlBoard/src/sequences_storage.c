@@ -0,0 +1,297 @@
+//  ***************************************************************************
+/// @file    sequences_storage.c
+/// @author  NeoProg
+//  ***************************************************************************
+#include "sequences_storage.h"
+#include "project_base.h"
+#include "sequences_engine.h"
+#include "motion_core.h"
+#include "configurator.h"
+#include "system_monitor.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#define UPLOAD_CHUNK_MAX_SIZE               ((CLI_ARG_MAX_SIZE - 1) / 2)    // Max bytes count of one CLI write command
+
+
+static uint16_t upload_magic = 0xFFFF;          // Magic of image under upload. It is written to EEPROM after validation
+static bool is_upload_started = false;
+
+static sequence_image_t cache_image = {0};      // Image of stored sequences
+static packed_sequence_t cache_sequences[SEQUENCE_CODEC_IMAGE_MAX_SEQUENCES] = {0};
+static uint32_t cache_sequences_count = 0;
+
+
+static bool read_image(sequence_image_t* image);
+static bool validate_image(const sequence_image_t* image, char* response);
+static void load_image(void);
+
+
+//  ***************************************************************************
+/// @brief  Sequences storage initialization
+/// @note   Stored image is loaded to RAM cache. Image is validated on upload,
+///         format and checksum are checked only
+/// @param  none
+/// @return none
+//  ***************************************************************************
+void sequences_storage_init(void) {
+
+    cache_sequences_count = 0;
+    if (read_image(&cache_image) == false) {
+        return;
+    }
+    if (sequence_codec_check_image(&cache_image) == false) {
+        return; // No uploaded sequences
+    }
+    load_image();
+}
+
+//  ***************************************************************************
+/// @brief  Get uploaded sequence
+/// @param  index: sequence index
+/// @return sequence or NULL if sequence is not uploaded
+//  ***************************************************************************
+const packed_sequence_t* sequences_storage_get_sequence(uint32_t index) {
+
+    if (index >= cache_sequences_count) {
+        return NULL;
+    }
+    return &cache_sequences[index];
+}
+
+//  ***************************************************************************
+/// @brief  CLI command process
+/// @param  cmd: command string
+/// @param  argv: argument list
+/// @param  argc: arguments count
+/// @param  response: response
+/// @retval response
+/// @return true - success, false - fail
+//  ***************************************************************************
+bool sequences_storage_cli_command_process(const char* cmd, const char (*argv)[CLI_ARG_MAX_SIZE], uint32_t argc, char* response) {
+
+    if (strcmp(cmd, "begin") == 0 && argc == 0) {
+
+        // Image is uploaded to EEPROM section directly, stored sequences are dropped
+        if (sequences_engine_is_uploaded_sequence_active() == true) {
+            strcpy(response, CLI_ERROR("Uploaded sequence is active, select other sequence"));
+            return false;
+        }
+        upload_magic = 0xFFFF;
+        if (config_write(MM_SEQUENCES_BASE_EE_ADDRESS + offsetof(sequence_image_t, magic), (uint8_t*)&upload_magic, sizeof(upload_magic)) == false) {
+            strcpy(response, CLI_ERROR("Cannot write data to memory"));
+            return false;
+        }
+        cache_sequences_count = 0;
+        sequences_engine_update_transitions();
+        is_upload_started = true;
+    }
+    else if (strcmp(cmd, "write") == 0 && argc == 2) {
+
+        if (is_upload_started == false) {
+            strcpy(response, CLI_ERROR("Upload is not started"));
+            return false;
+        }
+
+        // Get offset and bytes count
+        uint32_t offset = strtol(argv[0], NULL, 16);
+        uint32_t data_len = strlen(argv[1]);
+        if ((data_len & 0x01) || data_len > UPLOAD_CHUNK_MAX_SIZE * 2) {
+            strcpy(response, CLI_ERROR("Wrong data array"));
+            return false;
+        }
+        uint32_t bytes_count = data_len >> 1;
+        if (offset + bytes_count > sizeof(sequence_image_t)) {
+            strcpy(response, CLI_ERROR("Offset value is out of range"));
+            return false;
+        }
+
+        // Parse data. Magic bytes are kept in RAM until image is validated
+        uint8_t chunk[UPLOAD_CHUNK_MAX_SIZE];
+        char hex_value[3] = {0, 0, '\0'};
+        const char* data = &argv[1][0];
+        for (uint32_t i = 0; i < bytes_count; ++i) {
+
+            hex_value[0] = *(data + 0);
+            hex_value[1] = *(data + 1);
+            data += 2;
+
+            chunk[i] = strtol(hex_value, NULL, 16);
+            if (offset + i < sizeof(upload_magic)) {
+                ((uint8_t*)&upload_magic)[offset + i] = chunk[i];
+                chunk[i] = 0xFF;
+            }
+        }
+        if (config_write(MM_SEQUENCES_BASE_EE_ADDRESS + offset, chunk, bytes_count) == false) {
+            strcpy(response, CLI_ERROR("Cannot write data to memory"));
+            return false;
+        }
+    }
+    else if (strcmp(cmd, "commit") == 0 && argc == 0) {
+
+        if (is_upload_started == false) {
+            strcpy(response, CLI_ERROR("Upload is not started"));
+            return false;
+        }
+
+        // Image is validated from EEPROM. RAM cache is empty until commit is success
+        bool is_image_read = read_image(&cache_image);
+        cache_image.magic = upload_magic;
+        if (is_image_read == false || sequence_codec_check_image(&cache_image) == false) {
+            strcpy(response, CLI_ERROR("Wrong image format or checksum"));
+            return false;
+        }
+        if (validate_image(&cache_image, response) == false) {
+            return false;
+        }
+        if (config_write(MM_SEQUENCES_BASE_EE_ADDRESS + offsetof(sequence_image_t, magic), (uint8_t*)&upload_magic, sizeof(upload_magic)) == false) {
+            strcpy(response, CLI_ERROR("Cannot write data to memory"));
+            return false;
+        }
+        load_image();
+        sequences_engine_update_transitions();
+        is_upload_started = false;
+        sprintf(response, CLI_OK("%lu sequences are stored"), cache_sequences_count);
+    }
+    else if (strcmp(cmd, "erase") == 0 && argc == 0) {
+
+        if (sequences_engine_is_uploaded_sequence_active() == true) {
+            strcpy(response, CLI_ERROR("Uploaded sequence is active, select other sequence"));
+            return false;
+        }
+        uint16_t magic = 0xFFFF;
+        if (config_write(MM_SEQUENCES_BASE_EE_ADDRESS + offsetof(sequence_image_t, magic), (uint8_t*)&magic, sizeof(magic)) == false) {
+            strcpy(response, CLI_ERROR("Cannot write data to memory"));
+            return false;
+        }
+        cache_sequences_count = 0;
+        sequences_engine_update_transitions();
+    }
+    else if (strcmp(cmd, "list") == 0 && argc == 0) {
+
+        response += sprintf(response, CLI_OK("uploaded sequences: %lu"), cache_sequences_count);
+        for (uint32_t i = 0; i < cache_sequences_count; ++i) {
+            const packed_sequence_t* sequence = &cache_sequences[i];
+            response += sprintf(response, CLI_OK("    - %lu: motions %u (main %u, finalize %u)%s"), i, sequence->total_motions_count,
+                                sequence->main_motions_begin, sequence->finalize_motions_begin, sequence->is_sequence_looped ? ", looped" : "");
+        }
+    }
+    else if (strcmp(cmd, "select") == 0 && argc == 1) {
+
+        uint32_t index = atoi(argv[0]);
+        if (sequences_storage_get_sequence(index) == NULL) {
+            strcpy(response, CLI_ERROR("Sequence is not uploaded"));
+            return false;
+        }
+        sequences_engine_select_sequence((sequence_id_t)(SEQUENCE_USER_0 + index), 0, 0);
+    }
+    else {
+        strcpy(response, CLI_ERROR("Unknown command or format for sequence"));
+        return false;
+    }
+    return true;
+}
+
+
+
+
+
+//  ***************************************************************************
+/// @brief  Read image from EEPROM
+/// @note   Image size is read from header, magic is not checked
+/// @param  image: sequence image. @ref sequence_image_t
+/// @retval image
+/// @return true - success, false - error or wrong image size
+//  ***************************************************************************
+static bool read_image(sequence_image_t* image) {
+
+    if (config_read(MM_SEQUENCES_BASE_EE_ADDRESS, (uint8_t*)image, SEQUENCE_CODEC_IMAGE_HEADER_SIZE) == false) {
+        return false;
+    }
+    if (image->image_size > sizeof(sequence_image_t) || image->image_size < SEQUENCE_CODEC_IMAGE_HEADER_SIZE) {
+        return false;
+    }
+
+    uint8_t* motions = (uint8_t*)image + SEQUENCE_CODEC_IMAGE_HEADER_SIZE;
+    return config_read(MM_SEQUENCES_BASE_EE_ADDRESS + SEQUENCE_CODEC_IMAGE_HEADER_SIZE, motions, image->image_size - SEQUENCE_CODEC_IMAGE_HEADER_SIZE);
+}
+
+//  ***************************************************************************
+/// @brief  Validate sequences of image
+/// @note   Destination points should be attainable by limbs. Linear paths
+///         between destination points of consecutive motions are checked by
+///         MOTION_CORE_PATH_CHECK_POINTS points. Start position of first
+///         motion is unknown (it is runtime limbs positions). Splines are not
+///         supported: them pass through neighbour motions points and can
+///         overshoot. Joints path is limited by attainable endpoints
+/// @param  image: sequence image. @ref sequence_image_t
+/// @param  response: CLI response
+/// @retval response
+/// @return true - success, false - image contains not attainable position
+//  ***************************************************************************
+static bool validate_image(const sequence_image_t* image, char* response) {
+
+    for (uint32_t s = 0; s < image->sequences_count; ++s) {
+
+        packed_sequence_t sequence;
+        sequence_codec_get_image_sequence(image, s, &sequence);
+
+        point_3d_t positions[SUPPORT_LIMBS_COUNT];
+        uint32_t known_positions_mask = 0;
+        for (uint32_t m = 0; m < sequence.total_motions_count; ++m) {
+
+            motion_config_t motion;
+            sequence_codec_decode_motion(&sequence.motion_list[m], &motion);
+            if (motion.is_need_init_start_position == false) {
+                sprintf(response, CLI_ERROR("Sequence %lu motion %lu: start positions should be initialized"), s, m);
+                return false;
+            }
+
+            for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+
+                trajectory_t trajectory = motion.trajectories[i];
+                if (trajectory == TRAJECTORY_XYZ_HOLD) {
+                    continue;
+                }
+                if (trajectory == TRAJECTORY_XZ_ADV_Y_CONST || trajectory == TRAJECTORY_XZ_ADV_Y_SINUS || trajectory == TRAJECTORY_XZ_ADV_Y_GAIT ||
+                    trajectory == TRAJECTORY_XYZ_SPLINE || trajectory == TRAJECTORY_XYZ_MIN_JERK) {
+                    sprintf(response, CLI_ERROR("Sequence %lu motion %lu limb %lu: trajectory is not supported"), s, m, i);
+                    return false;
+                }
+                if (motion_core_check_position(i, &motion.dest_positions[i]) == false) {
+                    sprintf(response, CLI_ERROR("Sequence %lu motion %lu limb %lu: position is not attainable"), s, m, i);
+                    return false;
+                }
+
+                bool is_linear = (trajectory == TRAJECTORY_XYZ_LINEAR || trajectory == TRAJECTORY_XYZ_LINEAR_LIFT);
+                if (is_linear && (known_positions_mask & (1 << i))) {
+                    if (motion_core_check_path(i, &positions[i], &motion.dest_positions[i], trajectory == TRAJECTORY_XYZ_LINEAR_LIFT) == false) {
+                        sprintf(response, CLI_ERROR("Sequence %lu motion %lu limb %lu: path is not attainable"), s, m, i);
+                        return false;
+                    }
+                }
+
+                // Limb stays in start position after reverse motion
+                if (motion.time_directions[i] == TIME_DIR_DIRECT) {
+                    positions[i] = motion.dest_positions[i];
+                    known_positions_mask |= (1 << i);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Load sequences of cached image
+/// @param  none
+/// @return none
+//  ***************************************************************************
+static void load_image(void) {
+
+    for (uint32_t i = 0; i < cache_image.sequences_count; ++i) {
+        sequence_codec_get_image_sequence(&cache_image, i, &cache_sequences[i]);
+    }
+    cache_sequences_count = cache_image.sequences_count;
+}
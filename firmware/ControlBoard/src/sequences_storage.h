@@ -0,0 +1,23 @@
+//  ***************************************************************************
+/// @file    sequences_storage.h
+/// @author  NeoProg
+/// @brief   Uploaded sequences storage
+/// @note    Sequence image is uploaded over CLI, validated once and stored
+///          to EEPROM. Sequences are cached in RAM for playback
+//  ***************************************************************************
+#ifndef _SEQUENCES_STORAGE_H_
+#define _SEQUENCES_STORAGE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sequence_codec.h"
+#include "cli.h"
+
+
+extern void sequences_storage_init(void);
+extern const packed_sequence_t* sequences_storage_get_sequence(uint32_t index);
+
+extern bool sequences_storage_cli_command_process(const char* cmd, const char (*argv)[CLI_ARG_MAX_SIZE], uint32_t argc, char* response);
+
+
+#endif // _SEQUENCES_STORAGE_H_
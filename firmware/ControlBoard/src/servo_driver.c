@@ -16,10 +16,14 @@
 
 
 #define SERVO_DS3218MG_270_ID                   (0x00)
-#define       DS3218MG_MIN_PULSE_WIDTH          (500)
-#define       DS3218MG_MAX_PULSE_WIDTH          (2500)
-#define       DS3218MG_MAX_PHYSIC_ANGLE         (270)
-#define       DS3218MG_LOGIC_ZERO               (DS3218MG_MAX_PHYSIC_ANGLE / 2)
+#define SERVO_DS3218MG_180_ID                   (0x01)
+#define SERVO_DS3225MG_270_ID                   (0x02)
+
+#define SERVO_CALIBRATION_SEGMENTS_COUNT        (MM_SERVO_CALIBRATION_POINTS_COUNT - 1)
+#define ANGLE_FRACTION_BITS                     (8)     // Physic angles are Q8 [degree]
+#define PULSE_FRACTION_BITS                     (8)     // Calibration points pulse widths are Q8 [us]
+#define SLOPE_FRACTION_BITS                     (12)    // Calibration segments slopes are Q12 [us/degree]
+#define LIMITER_FRACTION_BITS                   (16)    // Limiter state is Q16 [us], [us/period], [us/period^2]
 
 
 typedef enum {
@@ -30,6 +34,16 @@ typedef enum {
 } override_level_t;
 
 typedef struct {
+    const char* name;
+    uint16_t min_pulse_width;               // [us]
+    uint16_t max_pulse_width;               // [us]
+    uint16_t max_physic_angle;              // [degree]
+    uint16_t max_frame_rate;                // Max PWM frequency, [Hz]
+    uint16_t rated_speed;                   // Max speed, [degree/s]
+} servo_type_t;
+
+typedef struct {
+    const servo_type_t* type;
     uint8_t  config;                        // Servo mode configuration
     int16_t  zero_trim;                     // Zero trim
                                    
@@ -37,25 +51,58 @@ typedef struct {
     uint16_t min_pulse_width;               // Min pulse width
     uint16_t max_pulse_width;               // Max pulse width
     uint16_t max_physic_angle;              // Max physic angle
+
+    int32_t  segment_angle;                                         // Calibration segment width, [degree Q8]
+    int32_t  point_pulse_width[MM_SERVO_CALIBRATION_POINTS_COUNT];  // Pulse width of calibration points, [us Q8]
+    int32_t  slope[SERVO_CALIBRATION_SEGMENTS_COUNT];               // Calibration segment slope, [us/degree Q12]
+
+    int32_t  max_speed;                     // Pulse width max speed, [us/period Q16]. 0 - not limited
+    int32_t  max_acceleration;              // Pulse width max acceleration, [us/period^2 Q16]. 0 - not limited
 } servo_config_t;
 
 typedef struct {
     float logic_angle;
-    float physic_angle;
-    uint32_t pulse_width;
+    int32_t physic_angle;                   // [degree Q8]
+    uint32_t pulse_width;                   // Target pulse width
+    bool is_pulse_width_loaded;             // Pulse width is loaded by servo_driver_move_pulse_width()
+    bool is_dirty;                          // Servo state should be recalculated and loaded to PWM driver
+
+    bool is_output_valid;                   // Limiter output is initialized by first target pulse width
+    bool is_limited;                        // Limiter output is not reached target, servo should be processed next period
+    int32_t output;                         // Limiter output pulse width, [us Q16]
+    int32_t velocity;                       // Limiter output velocity, [us/period Q16]
+    uint32_t limited_periods;               // PWM periods when limiting was active
     
     override_level_t override_level;
     int32_t override_value;
 } servo_info_t;
 
 
+// Servo types by MM_SERVO_CONFIG_SERVO_TYPE_MASK value. Frame rate of all servos is limited by slowest type
+static const servo_type_t servo_types_list[] = {
+    [SERVO_DS3218MG_270_ID] = { "DS3218MG 270", 500, 2500, 270, 270, 375 },
+    [SERVO_DS3218MG_180_ID] = { "DS3218MG 180", 500, 2500, 180, 270, 375 },
+    [SERVO_DS3225MG_270_ID] = { "DS3225MG 270", 500, 2500, 270, 333, 460 },
+};
+
 static servo_config_t servo_config_list[SUPPORT_SERVO_COUNT] = {0};
 static servo_info_t   servo_info_list[SUPPORT_SERVO_COUNT] = {0};
+static uint32_t recalc_channels_count = 0;          // Channels recalculated in current statistic window
+static uint32_t recalc_channels_per_second = 0;
+static uint32_t pwm_updates_count = 0;              // PWM channels which pulse width changed in current statistic window
+static uint32_t pwm_updates_per_second = 0;
+static uint32_t limited_channels_count = 0;         // Channels limited by slew rate limiter in current statistic window
+static uint32_t limited_channels_per_second = 0;
+static uint64_t statistic_time = 0;                 // Statistic window begin time, [ms]
+static uint32_t frame_rate = PWM_FREQUENCY_HZ;      // PWM frequency selected by servo types, [Hz]
+static uint32_t max_pulse_width = 0;                // Max pulse width of all servos, [us]
 
 
 static bool read_configuration(void);
-static float calculate_physic_angle(float logic_angle, const servo_config_t* config);
-static uint32_t convert_angle_to_pulse_width(float physic_angle, const servo_config_t* config);
+static int32_t calculate_physic_angle(float logic_angle, const servo_config_t* config);
+static uint32_t convert_angle_to_pulse_width(int32_t physic_angle, const servo_config_t* config);
+static uint32_t limit_pulse_width(servo_info_t* info, const servo_config_t* config);
+static void update_statistic(uint32_t channels_count, uint32_t updates_count);
 
 
 //  ***************************************************************************
@@ -70,7 +117,12 @@ void servo_driver_init(void) {
     GPIOC->OSPEEDR |=  (0x03u << (SERVO_POWER_EN_PIN * 2u));
     GPIOC->PUPDR   &= ~(0x03u << (SERVO_POWER_EN_PIN * 2u));
     
-    if (read_configuration() == false) {
+    // All channels should be loaded to PWM driver at first period
+    for (uint32_t i = 0; i < SUPPORT_SERVO_COUNT; ++i) {
+        servo_info_list[i].is_dirty = true;
+    }
+    
+    if (read_configuration() == false || pwm_set_frequency(frame_rate, max_pulse_width) == false) {
         sysmon_set_error(SYSMON_CONFIG_ERROR);
         sysmon_disable_module(SYSMON_MODULE_SERVO_DRIVER);
         return;
@@ -81,6 +133,7 @@ void servo_driver_init(void) {
 
 //  ***************************************************************************
 /// @brief  Start move servo to new angle
+/// @note   Channel is recalculated only if angle is changed
 /// @param  ch:    servo channel
 /// @param  angle: new angle
 /// @return none
@@ -94,7 +147,54 @@ void servo_driver_move(uint32_t ch, float angle) {
     }
     
     // Set new logic angle
-    servo_info_list[ch].logic_angle = angle;
+    servo_info_t* info = &servo_info_list[ch];
+    if (info->logic_angle != angle || info->is_pulse_width_loaded == true) {
+        info->logic_angle = angle;
+        info->is_pulse_width_loaded = false;
+        info->is_dirty = true;
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Move servo to precalculated pulse width
+/// @note   Pulse width should be calculated by servo_driver_convert_angle()
+/// @param  ch: servo channel
+/// @param  pulse_width: pulse width
+/// @return none
+//  ***************************************************************************
+void servo_driver_move_pulse_width(uint32_t ch, uint32_t pulse_width) {
+
+    if (ch >= SUPPORT_SERVO_COUNT) {
+        sysmon_set_error(SYSMON_FATAL_ERROR);
+        sysmon_disable_module(SYSMON_MODULE_SERVO_DRIVER);
+        return;
+    }
+    
+    servo_info_t* info = &servo_info_list[ch];
+    if (info->pulse_width != pulse_width || info->is_pulse_width_loaded == false) {
+        info->pulse_width = pulse_width;
+        info->is_pulse_width_loaded = true;
+        info->is_dirty = true;
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Convert logic angle to pulse width
+/// @note   Override is not applied
+/// @param  ch: servo channel
+/// @param  angle: logic angle
+/// @return pulse width
+//  ***************************************************************************
+uint32_t servo_driver_convert_angle(uint32_t ch, float angle) {
+    
+    if (ch >= SUPPORT_SERVO_COUNT) {
+        sysmon_set_error(SYSMON_FATAL_ERROR);
+        sysmon_disable_module(SYSMON_MODULE_SERVO_DRIVER);
+        return 0;
+    }
+    
+    int32_t physic_angle = calculate_physic_angle(angle, &servo_config_list[ch]);
+    return convert_angle_to_pulse_width(physic_angle, &servo_config_list[ch]);
 }
 
 //  ***************************************************************************
@@ -116,7 +216,8 @@ void servo_driver_power_off(void) {
 
 //  ***************************************************************************
 /// @brief  Servo driver process
-/// @note   Call from main loop
+/// @note   Call from main loop. Only changed (dirty) and overridden channels
+///         are recalculated and loaded to PWM driver
 //  ***************************************************************************
 void servo_driver_process(void) {
 
@@ -138,32 +239,47 @@ void servo_driver_process(void) {
         //
         // Calculate servo state and update PWM driver
         //
-        pwm_set_shadow_buffer_lock_state(false);
+        uint32_t channels_count = 0;
+        uint32_t updates_count = 0;
+        pwm_set_shadow_buffer_lock_state(true);
         for (uint32_t i = 0; i < SUPPORT_SERVO_COUNT; ++i) {
 
             servo_info_t* info = &servo_info_list[i];
-
-            // Override logic angle if need
-            if (info->override_level == OVERRIDE_LEVEL_LOGIC_ANGLE) {
-                info->logic_angle = info->override_value;
+            if (info->is_dirty == false && info->is_limited == false && info->override_level == OVERRIDE_LEVEL_NO) {
+                continue;
             }
-
-            // Calculate physic angle
-            info->physic_angle = calculate_physic_angle(info->logic_angle, &servo_config_list[i]);
-            if (info->override_level == OVERRIDE_LEVEL_PHYSIC_ANGLE) {
-                info->physic_angle = info->override_value;
+            info->is_dirty = false;
+            ++channels_count;
+
+            // Pulse width already calculated by caller
+            if (info->is_pulse_width_loaded == false || info->override_level != OVERRIDE_LEVEL_NO) {
+
+                // Override logic angle if need
+                if (info->override_level == OVERRIDE_LEVEL_LOGIC_ANGLE) {
+                    info->logic_angle = info->override_value;
+                }
+
+                // Calculate physic angle
+                info->physic_angle = calculate_physic_angle(info->logic_angle, &servo_config_list[i]);
+                if (info->override_level == OVERRIDE_LEVEL_PHYSIC_ANGLE) {
+                    info->physic_angle = info->override_value << ANGLE_FRACTION_BITS;
+                }
+
+                // Calculate pulse width
+                info->pulse_width = convert_angle_to_pulse_width(info->physic_angle, &servo_config_list[i]);
+                if (info->override_level == OVERRIDE_LEVEL_PULSE_WIDTH) {
+                    info->pulse_width = info->override_value;
+                }
             }
 
-            // Calculate pulse width
-            info->pulse_width = convert_angle_to_pulse_width(info->physic_angle, &servo_config_list[i]);
-            if (info->override_level == OVERRIDE_LEVEL_PULSE_WIDTH) {
-                info->pulse_width = info->override_value;
+            // Limit speed and acceleration and load pulse width
+            uint32_t pulse_width = limit_pulse_width(info, &servo_config_list[i]);
+            if (pwm_set_width(i, pulse_width) == true) {
+                ++updates_count;
             }
-
-            // Load pulse width
-            pwm_set_width(i, info->pulse_width);
         }
         pwm_set_shadow_buffer_lock_state(false);
+        update_statistic(channels_count, updates_count);
 
         prev_synchro_value = synchro;
     }
@@ -189,6 +305,32 @@ bool servo_driver_cli_command_process(const char* cmd, const char (*argv)[CLI_AR
         servo_driver_power_on();
         return true;
     }
+    else if (strcmp(cmd, "stat") == 0 && argc == 0) {
+        uint32_t edge_max_cycles = 0;
+        uint32_t period_max_cycles = 0;
+        pwm_get_isr_statistic(&edge_max_cycles, &period_max_cycles);
+        sprintf(response, CLI_OK("servo driver statistic")
+                          CLI_OK("    - recalculated channels per second: %lu")
+                          CLI_OK("    - PWM channels updates per second: %lu")
+                          CLI_OK("    - limited channels per second: %lu")
+                          CLI_OK("    - PWM frame rate: %lu Hz")
+                          CLI_OK("    - PWM ISR worst case: edge %lu cycles, period %lu cycles (%s)"),
+                recalc_channels_per_second, pwm_updates_per_second, limited_channels_per_second, pwm_get_frequency(), edge_max_cycles, period_max_cycles,
+                PWM_DMA_WAVEFORM_ENABLE ? "DMA waveform" : (PWM_EDGE_SCHEDULE_ENABLE ? "edge schedule" : "legacy"));
+        response += strlen(response);
+        response += sprintf(response, CLI_OK("    - limited periods by servo:"));
+        for (uint32_t i = 0; i < SUPPORT_SERVO_COUNT; ++i) {
+            response += sprintf(response, CLI_OK("        [%lu] %lu"), i, servo_info_list[i].limited_periods);
+        }
+        return true;
+    }
+    else if (strcmp(cmd, "stat-reset") == 0 && argc == 0) {
+        pwm_reset_isr_statistic();
+        for (uint32_t i = 0; i < SUPPORT_SERVO_COUNT; ++i) {
+            servo_info_list[i].limited_periods = 0;
+        }
+        return true;
+    }
 
     // Get servo index
     if (argc == 0) {
@@ -203,6 +345,7 @@ bool servo_driver_cli_command_process(const char* cmd, const char (*argv)[CLI_AR
     
     // Get servo info
     servo_info_t* info = &servo_info_list[servo_index];
+    const servo_config_t* config = &servo_config_list[servo_index];
     
     //
     // Process command
@@ -210,13 +353,20 @@ bool servo_driver_cli_command_process(const char* cmd, const char (*argv)[CLI_AR
     if (strcmp(cmd, "status") == 0 && argc == 1) {
 
         sprintf(response, CLI_OK("servo status report")
+                          CLI_OK("    - type: %s")
                           CLI_OK("    - override level: %ld")
                           CLI_OK("    - override value: %ld")
                           CLI_OK("    - logic angle: %ld")
                           CLI_OK("    - physic angle: %ld")
-                          CLI_OK("    - pulse width: %lu"),
-                info->override_level, info->override_value,
-                (int32_t)info->logic_angle, (int32_t)info->physic_angle, info->pulse_width);
+                          CLI_OK("    - pulse width: %lu")
+                          CLI_OK("    - output pulse width: %ld")
+                          CLI_OK("    - limited periods: %lu")
+                          CLI_OK("    - calibration points: %ld, %ld, %ld, %ld"),
+                config->type->name, info->override_level, info->override_value,
+                (int32_t)info->logic_angle, info->physic_angle >> ANGLE_FRACTION_BITS, info->pulse_width,
+                info->output >> LIMITER_FRACTION_BITS, info->limited_periods,
+                config->point_pulse_width[0] >> PULSE_FRACTION_BITS, config->point_pulse_width[1] >> PULSE_FRACTION_BITS,
+                config->point_pulse_width[2] >> PULSE_FRACTION_BITS, config->point_pulse_width[3] >> PULSE_FRACTION_BITS);
     }
     else if (strcmp(cmd, "set-logic") == 0 && argc == 2) {
         info->override_level = OVERRIDE_LEVEL_LOGIC_ANGLE;
@@ -235,12 +385,13 @@ bool servo_driver_cli_command_process(const char* cmd, const char (*argv)[CLI_AR
     }
     else if (strcmp(cmd, "zero") == 0 && argc == 1) {
         info->override_level = OVERRIDE_LEVEL_PHYSIC_ANGLE;
-        info->override_value = (int32_t)calculate_physic_angle(0, &servo_config_list[servo_index]);
+        info->override_value = calculate_physic_angle(0, &servo_config_list[servo_index]) >> ANGLE_FRACTION_BITS;
         sprintf(response, CLI_OK("[%lu] moved to zero"), servo_index);
     }
     else if (strcmp(cmd, "reset") == 0 && argc == 1) {
         info->override_level = OVERRIDE_LEVEL_NO;
         info->override_value = 0;
+        info->is_dirty = true;
         sprintf(response, CLI_OK("[%lu] has new override level %lu"), servo_index, info->override_level);
     }
     else {
@@ -256,11 +407,15 @@ bool servo_driver_cli_command_process(const char* cmd, const char (*argv)[CLI_AR
 
 //  ***************************************************************************
 /// @brief  Read configuration
+/// @note   PWM frame rate is selected by slowest servo type, speed and
+///         acceleration limits are converted for this frame rate
 /// @param  none
 /// @return true - read success, false - fail
 //  ***************************************************************************
 static bool read_configuration(void) {
     
+    frame_rate = PWM_MAX_FREQUENCY_HZ;
+    max_pulse_width = 0;
     for (uint32_t servo_index = 0; servo_index < SUPPORT_SERVO_COUNT; ++servo_index) {
 
         servo_config_t* servo_config = &servo_config_list[servo_index];
@@ -276,45 +431,104 @@ static bool read_configuration(void) {
         
         // Load servo information
         uint8_t servo_id = (servo_config->config & MM_SERVO_CONFIG_SERVO_TYPE_MASK) >> 4;
-        if (servo_id == SERVO_DS3218MG_270_ID) {
-            servo_config->logic_zero       = DS3218MG_LOGIC_ZERO;
-            servo_config->min_pulse_width  = DS3218MG_MIN_PULSE_WIDTH;
-            servo_config->max_pulse_width  = DS3218MG_MAX_PULSE_WIDTH;
-            servo_config->max_physic_angle = DS3218MG_MAX_PHYSIC_ANGLE;
+        if (servo_id >= sizeof(servo_types_list) / sizeof(servo_types_list[0])) {
+            return false; // Unknown servo type
         }
-        else {
-            // Unknown servo type
-            return false;
+        servo_config->type             = &servo_types_list[servo_id];
+        servo_config->logic_zero       = servo_config->type->max_physic_angle / 2;
+        servo_config->min_pulse_width  = servo_config->type->min_pulse_width;
+        servo_config->max_pulse_width  = servo_config->type->max_pulse_width;
+        servo_config->max_physic_angle = servo_config->type->max_physic_angle;
+        if (frame_rate > servo_config->type->max_frame_rate) {
+            frame_rate = servo_config->type->max_frame_rate;
+        }
+        if (max_pulse_width < servo_config->type->max_pulse_width) {
+            max_pulse_width = servo_config->type->max_pulse_width;
         }
 
         // Read servo zero trim
         if (config_read_16(base_address + MM_SERVO_ZERO_TRIM_OFFSET, (uint16_t*)&servo_config->zero_trim) == false) return false;
+
+        // Read calibration table. Nominal characteristic is linear
+        int8_t corrections[MM_SERVO_CALIBRATION_POINTS_COUNT] = {0};
+        if (servo_config->config & MM_SERVO_CONFIG_CALIBRATION_TABLE_MASK) {
+            for (uint32_t i = 0; i < MM_SERVO_CALIBRATION_POINTS_COUNT; ++i) {
+                if (config_read_8(base_address + MM_SERVO_CALIBRATION_TABLE_OFFSET + i, (uint8_t*)&corrections[i]) == false) return false;
+            }
+        }
+
+        // Calculate calibration points and segments slopes
+        int32_t pulse_range = (servo_config->max_pulse_width - servo_config->min_pulse_width) << PULSE_FRACTION_BITS;
+        servo_config->segment_angle = (servo_config->max_physic_angle << ANGLE_FRACTION_BITS) / SERVO_CALIBRATION_SEGMENTS_COUNT;
+        for (uint32_t i = 0; i < MM_SERVO_CALIBRATION_POINTS_COUNT; ++i) {
+            servo_config->point_pulse_width[i] = (servo_config->min_pulse_width << PULSE_FRACTION_BITS) +
+                                                 pulse_range * (int32_t)i / SERVO_CALIBRATION_SEGMENTS_COUNT +
+                                                 corrections[i] * (1 << PULSE_FRACTION_BITS);
+        }
+        for (uint32_t i = 0; i < SERVO_CALIBRATION_SEGMENTS_COUNT; ++i) {
+            int32_t delta = servo_config->point_pulse_width[i + 1] - servo_config->point_pulse_width[i];
+            if (delta <= 0) {
+                return false; // Characteristic should be monotonic
+            }
+            servo_config->slope[i] = (delta << (SLOPE_FRACTION_BITS + ANGLE_FRACTION_BITS - PULSE_FRACTION_BITS)) / servo_config->segment_angle;
+        }
+    }
+
+    for (uint32_t servo_index = 0; servo_index < SUPPORT_SERVO_COUNT; ++servo_index) {
+
+        servo_config_t* servo_config = &servo_config_list[servo_index];
+
+        // Read speed and acceleration limits and convert to pulse width per PWM period.
+        // Speed limit is not more servo rated speed
+        uint32_t limits_address = MM_SERVO_LIMITS_BLOCK_BASE_EE_ADDRESS + servo_index * MM_SERVO_LIMITS_BLOCK_SIZE;
+        uint16_t max_speed = 0;
+        uint16_t max_acceleration = 0;
+        if (config_read_16(limits_address + MM_SERVO_MAX_SPEED_OFFSET, &max_speed) == false) return false;
+        if (config_read_16(limits_address + MM_SERVO_MAX_ACCELERATION_OFFSET, &max_acceleration) == false) return false;
+
+        uint64_t pulse_per_degree = ((uint64_t)(servo_config->max_pulse_width - servo_config->min_pulse_width) << LIMITER_FRACTION_BITS) / servo_config->max_physic_angle;
+        servo_config->max_speed = 0;
+        servo_config->max_acceleration = 0;
+        if (max_speed != 0 && max_speed != 0xFFFF) {
+            if (max_speed > servo_config->type->rated_speed) {
+                max_speed = servo_config->type->rated_speed;
+            }
+            servo_config->max_speed = (int32_t)(max_speed * pulse_per_degree / frame_rate);
+        }
+        if (max_acceleration != 0 && max_acceleration != 0xFFFF) {
+            servo_config->max_acceleration = (int32_t)(max_acceleration * pulse_per_degree / (frame_rate * frame_rate));
+            if (servo_config->max_acceleration == 0) {
+                servo_config->max_acceleration = 1;
+            }
+        }
     }
     return true;
 }
 
 //  ***************************************************************************
-/// @brief  Start move servo to new angle
-/// @param  ch:    servo channel
-/// @param  angle: new angle
-/// @return physic angle
+/// @brief  Convert logic angle to physic angle
+/// @param  logic_angle: logic angle
+/// @param  config: servo configuration. @ref servo_config_t
+/// @return physic angle, [degree Q8]
 //  ***************************************************************************
-static float calculate_physic_angle(float logic_angle, const servo_config_t* config) {
+static int32_t calculate_physic_angle(float logic_angle, const servo_config_t* config) {
 
     // Convert logic angle to physic angle
-    float physic_angle = 0;
+    int32_t angle = (int32_t)(logic_angle * (1 << ANGLE_FRACTION_BITS) + ((logic_angle < 0) ? -0.5f : 0.5f));
+    angle += config->zero_trim * (1 << ANGLE_FRACTION_BITS);
+    int32_t physic_angle = 0;
     if (config->config & MM_SERVO_CONFIG_REVERSE_DIRECTION_MASK) {
-        physic_angle = (float)config->logic_zero - (logic_angle + (float)config->zero_trim);
+        physic_angle = (config->logic_zero << ANGLE_FRACTION_BITS) - angle;
     }
     else {
-        physic_angle = (float)config->logic_zero + (logic_angle + (float)config->zero_trim);
+        physic_angle = (config->logic_zero << ANGLE_FRACTION_BITS) + angle;
     }
     
     // Check physic angle value
-    if (physic_angle < 0 || physic_angle > config->max_physic_angle) {
+    if (physic_angle < 0 || physic_angle > (config->max_physic_angle << ANGLE_FRACTION_BITS)) {
         sysmon_set_error(SYSMON_MATH_ERROR);
         sysmon_disable_module(SYSMON_MODULE_SERVO_DRIVER);
-        return config->logic_zero;
+        return config->logic_zero << ANGLE_FRACTION_BITS;
     }
 
     return physic_angle;
@@ -322,21 +536,116 @@ static float calculate_physic_angle(float logic_angle, const servo_config_t* con
 
 //  ***************************************************************************
 /// @brief  Convert servo angle to PWM pulse width
-/// @param  physic_angle: servo angle
+/// @note   Piecewise linear interpolation by calibration table
+/// @param  physic_angle: servo angle, [degree Q8]
 /// @param  config: servo configuration. @ref servo_config_t
 /// @return PWM pulse width
 //  ***************************************************************************
-static uint32_t convert_angle_to_pulse_width(float physic_angle, const servo_config_t* config) {
+static uint32_t convert_angle_to_pulse_width(int32_t physic_angle, const servo_config_t* config) {
+
+    // Find calibration segment
+    uint32_t segment = 0;
+    int32_t segment_begin = 0;
+    while (segment < SERVO_CALIBRATION_SEGMENTS_COUNT - 1 && physic_angle >= segment_begin + config->segment_angle) {
+        segment_begin += config->segment_angle;
+        ++segment;
+    }
 
-    float step = (float)(config->max_pulse_width - config->min_pulse_width) / (float)config->max_physic_angle;
-    float pulse_width = (float)config->min_pulse_width + physic_angle * step;
+    int32_t pulse_width = config->point_pulse_width[segment] +
+                          (((physic_angle - segment_begin) * config->slope[segment]) >> (SLOPE_FRACTION_BITS + ANGLE_FRACTION_BITS - PULSE_FRACTION_BITS));
+    pulse_width = (pulse_width + (1 << (PULSE_FRACTION_BITS - 1))) >> PULSE_FRACTION_BITS;
     
     // Check pulse width value
-    if (pulse_width < config->min_pulse_width || pulse_width > config->max_pulse_width) {
+    if (pulse_width < (config->point_pulse_width[0] >> PULSE_FRACTION_BITS) ||
+        pulse_width > (config->point_pulse_width[SERVO_CALIBRATION_SEGMENTS_COUNT] + (1 << PULSE_FRACTION_BITS)) >> PULSE_FRACTION_BITS) {
         sysmon_set_error(SYSMON_MATH_ERROR);
         sysmon_disable_module(SYSMON_MODULE_SERVO_DRIVER);
-        return config->min_pulse_width + (pulse_width > config->max_pulse_width - config->min_pulse_width) / 2;
+        return (config->min_pulse_width + config->max_pulse_width) / 2;
     }
     
     return (uint32_t)pulse_width;
 }
+
+//  ***************************************************************************
+/// @brief  Limit speed and acceleration of pulse width
+/// @note   Output accelerates to target and brakes to stop on target
+///         (v^2 >= 2 * a * distance). First target is loaded without limits,
+///         servo position is unknown before it
+/// @param  info: servo information. @ref servo_info_t
+/// @param  config: servo configuration. @ref servo_config_t
+/// @return limited pulse width
+//  ***************************************************************************
+static uint32_t limit_pulse_width(servo_info_t* info, const servo_config_t* config) {
+
+    int32_t target = (int32_t)info->pulse_width << LIMITER_FRACTION_BITS;
+    if (info->is_output_valid == false || (config->max_speed == 0 && config->max_acceleration == 0)) {
+        info->is_output_valid = true;
+        info->is_limited = false;
+        info->output = target;
+        info->velocity = 0;
+        return info->pulse_width;
+    }
+
+    // Calculate velocity
+    int32_t distance = target - info->output;
+    int32_t velocity = info->velocity;
+    if (config->max_acceleration == 0) {
+        velocity = distance;
+    }
+    else {
+        int32_t direction = (distance >= 0) ? 1 : -1;
+        int64_t velocity_square = (int64_t)velocity * velocity;
+        if (velocity * direction < 0 || velocity_square >= 2 * (int64_t)config->max_acceleration * abs(distance)) {
+            if (abs(velocity) <= config->max_acceleration) {
+                velocity = 0;
+            } else {
+                velocity -= (velocity > 0) ? config->max_acceleration : -config->max_acceleration;
+            }
+        }
+        else {
+            velocity += direction * config->max_acceleration;
+        }
+    }
+    if (config->max_speed != 0) {
+        if (velocity > config->max_speed)  velocity = config->max_speed;
+        if (velocity < -config->max_speed) velocity = -config->max_speed;
+    }
+
+    // Move output, stop on target
+    int32_t output = info->output + velocity;
+    if ((distance >= 0 && output >= target) || (distance <= 0 && output <= target)) {
+        output = target;
+        velocity = 0;
+    }
+    info->output = output;
+    info->velocity = velocity;
+    info->is_limited = (output != target);
+    if (info->is_limited == true) {
+        ++info->limited_periods;
+        ++limited_channels_count;
+    }
+    return (uint32_t)((output + (1 << (LIMITER_FRACTION_BITS - 1))) >> LIMITER_FRACTION_BITS);
+}
+
+//  ***************************************************************************
+/// @brief  Update recalculated channels statistic
+/// @param  channels_count: channels recalculated in current PWM period
+/// @param  updates_count: PWM channels which pulse width changed in current PWM period
+/// @return none
+//  ***************************************************************************
+static void update_statistic(uint32_t channels_count, uint32_t updates_count) {
+    
+    recalc_channels_count += channels_count;
+    pwm_updates_count += updates_count;
+    
+    uint64_t time = get_time_ms();
+    if (time - statistic_time >= 1000) {
+        recalc_channels_per_second = recalc_channels_count;
+        pwm_updates_per_second = pwm_updates_count;
+        limited_channels_per_second = limited_channels_count;
+        limited_channels_count = 0;
+        recalc_channels_count = 0;
+        pwm_updates_count = 0;
+        statistic_time = time;
+    }
+}
@@ -9,15 +9,18 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "cli.h"
+#include "robot_config.h"
 
 
-#define SUPPORT_SERVO_COUNT                        (18)
+#define SUPPORT_SERVO_COUNT                        (ROBOT_SERVO_COUNT)
 
 
 extern void servo_driver_init(void); 
 extern void servo_driver_power_on(void);
 extern void servo_driver_power_off(void);
 extern void servo_driver_move(uint32_t ch, float angle);
+extern void servo_driver_move_pulse_width(uint32_t ch, uint32_t pulse_width);
+extern uint32_t servo_driver_convert_angle(uint32_t ch, float angle);
 extern void servo_driver_process(void);
 
 extern bool servo_driver_cli_command_process(const char* cmd, const char (*argv)[CLI_ARG_MAX_SIZE], 
@@ -7,6 +7,9 @@
 #include "swlp_protocol.h"
 #include "usart2.h"
 #include "sequences_engine.h"
+#include "cue_scheduler.h"
+#include "motion_core.h"
+#include "body_pose.h"
 #include "indication.h"
 #include "camera.h"
 #include "system_monitor.h"
@@ -32,6 +35,7 @@ static void frame_received_callback(uint32_t frame_size);
 static void frame_transmitted_or_error_callback(void);
 static bool check_frame(const uint8_t* rx_buffer, uint32_t frame_size);
 static uint16_t calculate_crc16(const uint8_t* frame, uint32_t size);
+static bool get_command_sequence(uint8_t command, uint8_t* sequence);
 
 
 //  ***************************************************************************
@@ -84,6 +88,24 @@ void swlp_process(void) {
         swlp_status_payload_t* response = (swlp_status_payload_t*)swlp_tx_frame->payload;
         memset(swlp_tx_frame, 0, sizeof(swlp_frame_t));
 
+        // Update motion speed
+        if (request->speed != 0) {
+            motion_core_set_speed_multiplier((float)request->speed / 100.0f);
+        }
+        
+        // Update body pose. Zero pose is neutral
+        body_pose_t pose;
+        pose.roll     = request->pose_roll;
+        pose.pitch    = request->pose_pitch;
+        pose.yaw      = request->pose_yaw;
+        pose.offset.x = request->pose_x;
+        pose.offset.y = request->pose_y;
+        pose.offset.z = request->pose_z;
+        body_pose_set_target(&pose);
+        
+        // Update walk gait
+        sequences_engine_select_gait((gait_type_t)request->gait);
+        
         // Process command
         response->command_status = SWLP_CMD_STATUS_OK;
         switch (request->command) {
@@ -123,10 +145,41 @@ void swlp_process(void) {
             case SWLP_CMD_SELECT_SEQUENCE_ROTATE_Z:
                 sequences_engine_select_sequence(SEQUENCE_ROTATE_Z, 0, 0);
                 break;
+            case SWLP_CMD_SELECT_SEQUENCE_USER_0:
+            case SWLP_CMD_SELECT_SEQUENCE_USER_1:
+            case SWLP_CMD_SELECT_SEQUENCE_USER_2:
+            case SWLP_CMD_SELECT_SEQUENCE_USER_3:
+                sequences_engine_select_sequence((sequence_id_t)(SEQUENCE_USER_0 + request->command - SWLP_CMD_SELECT_SEQUENCE_USER_0), 0, 0);
+                break;
             case SWLP_CMD_SELECT_SEQUENCE_NONE:
                 sequences_engine_select_sequence(SEQUENCE_NONE, 0, 0);
                 break;
                 
+            case SWLP_CMD_CUE_CLEAR:
+                if (cue_scheduler_clear() == false) {
+                    response->command_status = SWLP_CMD_STATUS_ERROR;
+                }
+                break;
+            case SWLP_CMD_CUE_WRITE: {
+                cue_t cue;
+                cue.start_time = request->cue_start_time;
+                cue.distance   = request->distance;
+                cue.curvature  = request->curvature;
+                cue.speed      = request->cue_speed;
+                if (get_command_sequence(request->cue_command, &cue.sequence) == false || cue_scheduler_write_cue(request->cue_index, &cue) == false) {
+                    response->command_status = SWLP_CMD_STATUS_ERROR;
+                }
+                break;
+            }
+            case SWLP_CMD_CUE_START:
+                if (cue_scheduler_start(request->cue_start_time) == false) {
+                    response->command_status = SWLP_CMD_STATUS_ERROR;
+                }
+                break;
+            case SWLP_CMD_CUE_STOP:
+                cue_scheduler_stop();
+                break;
+                
             default:
                 response->command_status = SWLP_CMD_STATUS_ERROR;
         }
@@ -218,6 +271,38 @@ static uint16_t calculate_crc16(const uint8_t* frame, uint32_t size) {
     return crc16;
 }
 
+//  ***************************************************************************
+/// @brief  Get sequence selected by command
+/// @param  command: SWLP_CMD_SELECT_SEQUENCE_xxx command
+/// @param  sequence: sequence. @ref sequence_id_t
+/// @retval sequence
+/// @return true - success, false - command is not select sequence command
+//  ***************************************************************************
+static bool get_command_sequence(uint8_t command, uint8_t* sequence) {
+
+    switch (command) {
+        case SWLP_CMD_SELECT_SEQUENCE_UP:           *sequence = SEQUENCE_UP;            break;
+        case SWLP_CMD_SELECT_SEQUENCE_DOWN:         *sequence = SEQUENCE_DOWN;          break;
+        case SWLP_CMD_SELECT_SEQUENCE_DIRECT:       *sequence = SEQUENCE_DIRECT;        break;
+        case SWLP_CMD_SELECT_SEQUENCE_REVERSE:      *sequence = SEQUENCE_REVERSE;       break;
+        case SWLP_CMD_SELECT_SEQUENCE_UP_DOWN:      *sequence = SEQUENCE_UP_DOWN;       break;
+        case SWLP_CMD_SELECT_SEQUENCE_PUSH_PULL:    *sequence = SEQUENCE_PUSH_PULL;     break;
+        case SWLP_CMD_SELECT_SEQUENCE_ATTACK_LEFT:  *sequence = SEQUENCE_ATTACK_LEFT;   break;
+        case SWLP_CMD_SELECT_SEQUENCE_ATTACK_RIGHT: *sequence = SEQUENCE_ATTACK_RIGHT;  break;
+        case SWLP_CMD_SELECT_SEQUENCE_DANCE:        *sequence = SEQUENCE_DANCE;         break;
+        case SWLP_CMD_SELECT_SEQUENCE_ROTATE_X:     *sequence = SEQUENCE_ROTATE_X;      break;
+        case SWLP_CMD_SELECT_SEQUENCE_ROTATE_Z:     *sequence = SEQUENCE_ROTATE_Z;      break;
+        case SWLP_CMD_SELECT_SEQUENCE_USER_0:       *sequence = SEQUENCE_USER_0;        break;
+        case SWLP_CMD_SELECT_SEQUENCE_USER_1:       *sequence = SEQUENCE_USER_1;        break;
+        case SWLP_CMD_SELECT_SEQUENCE_USER_2:       *sequence = SEQUENCE_USER_2;        break;
+        case SWLP_CMD_SELECT_SEQUENCE_USER_3:       *sequence = SEQUENCE_USER_3;        break;
+        case SWLP_CMD_SELECT_SEQUENCE_NONE:         *sequence = SEQUENCE_NONE;          break;
+        default:
+            return false;
+    }
+    return true;
+}
+
 //  ***************************************************************************
 /// @brief  Frame received callback
 /// @param  frame_size: received frame size
@@ -26,15 +26,19 @@ typedef enum {
 
 static monitor_state_t monitor_state = STATE_NO_INIT;
 static uint32_t acc_adc_bins[ADC_CHANNELS_COUNT] = {0};
+static uint32_t min_adc_bins[ADC_CHANNELS_COUNT] = {0xFFFFFFFF};  // Min sample of accumulate window
 static int16_t  battery_voltage_offset = 0;
 
 uint8_t  sysmon_system_status = 0;
 uint8_t  sysmon_module_status = 0;
 uint16_t sysmon_battery_voltage = 12600; // mV
 uint8_t  sysmon_battery_charge = 99; // %
+uint16_t sysmon_voltage_droop = 0; // mV
+uint16_t sysmon_max_voltage_droop = 0; // mV
 
 
 static void calculate_battery_voltage(void);
+static uint32_t convert_bins_to_voltage(uint32_t adc_bins);
 
 
 //  ***************************************************************************
@@ -82,7 +86,12 @@ void sysmon_process(void) {
             break;
             
         case STATE_ACCUMULATE:
-            acc_adc_bins[ADC_BATTERY_VOLTAGE_CH] += adc_get_conversion_result(ADC_BATTERY_VOLTAGE_CH);
+        {
+            uint32_t adc_bins = adc_get_conversion_result(ADC_BATTERY_VOLTAGE_CH);
+            acc_adc_bins[ADC_BATTERY_VOLTAGE_CH] += adc_bins;
+            if (min_adc_bins[ADC_BATTERY_VOLTAGE_CH] > adc_bins) {
+                min_adc_bins[ADC_BATTERY_VOLTAGE_CH] = adc_bins;
+            }
             if (++accumulate_counter >= ACCUMULATE_SAMPLES_COUNT) {
                 accumulate_counter = 0;
                 monitor_state = STATE_CALCULATION;
@@ -92,10 +101,12 @@ void sysmon_process(void) {
                 monitor_state = STATE_PAUSE;
             }
             break;
+        }
 
         case STATE_CALCULATION:
             calculate_battery_voltage();
             acc_adc_bins[ADC_BATTERY_VOLTAGE_CH] = 0;
+            min_adc_bins[ADC_BATTERY_VOLTAGE_CH] = 0xFFFFFFFF;
             if (sysmon_battery_charge == 0) {
                 sysmon_set_error(SYSMON_VOLTAGE_ERROR);
             }
@@ -182,16 +193,17 @@ bool sysmon_is_module_disable(uint32_t module) {
 //  ***************************************************************************
 static void calculate_battery_voltage(void) {
     
-    // Revert voltage divisor factor (voltage_div_factor = 1 / real_factor)
-    // Voltage divisor: VIN-[10k]-OUT-[3k3]-GND
-    // * 1000 - convert V to mV
-    const float voltage_div_factor = ((10000.0f + 3300.0f) / 3300.0f) * 1000.0f;
-    const float bins_to_voltage_factor = 3.3f / 4096.0f;
-    
     // Battery voltage (max voltage 12.6V)
     uint32_t avr_adc_bins = acc_adc_bins[ADC_BATTERY_VOLTAGE_CH] / ACCUMULATE_SAMPLES_COUNT;
-    float input_voltage = avr_adc_bins * bins_to_voltage_factor;
-    int32_t battery_voltage = (uint32_t)(input_voltage * voltage_div_factor);
+    uint32_t average_voltage = convert_bins_to_voltage(avr_adc_bins);
+    int32_t battery_voltage = average_voltage;
+
+    // Voltage droop: min sample below average of window (servo current peaks)
+    uint32_t min_voltage = convert_bins_to_voltage(min_adc_bins[ADC_BATTERY_VOLTAGE_CH]);
+    sysmon_voltage_droop = (average_voltage > min_voltage) ? (average_voltage - min_voltage) : 0;
+    if (sysmon_max_voltage_droop < sysmon_voltage_droop) {
+        sysmon_max_voltage_droop = sysmon_voltage_droop;
+    }
 
     // Offset battery voltage
     battery_voltage += battery_voltage_offset;
@@ -209,3 +221,20 @@ static void calculate_battery_voltage(void) {
     }
     sysmon_battery_charge = (uint8_t)battery_charge;
 }
+
+//  ***************************************************************************
+/// @brief  Convert ADC bins to battery voltage
+/// @param  adc_bins: ADC bins
+/// @return battery voltage without offset, [mV]
+//  ***************************************************************************
+static uint32_t convert_bins_to_voltage(uint32_t adc_bins) {
+
+    // Revert voltage divisor factor (voltage_div_factor = 1 / real_factor)
+    // Voltage divisor: VIN-[10k]-OUT-[3k3]-GND
+    // * 1000 - convert V to mV
+    const float voltage_div_factor = ((10000.0f + 3300.0f) / 3300.0f) * 1000.0f;
+    const float bins_to_voltage_factor = 3.3f / 4096.0f;
+
+    float input_voltage = adc_bins * bins_to_voltage_factor;
+    return (uint32_t)(input_voltage * voltage_div_factor);
+}
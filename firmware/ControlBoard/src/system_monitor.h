@@ -39,6 +39,8 @@ extern uint8_t  sysmon_system_status;
 extern uint8_t  sysmon_module_status;
 extern uint16_t sysmon_battery_voltage;
 extern uint8_t  sysmon_battery_charge;
+extern uint16_t sysmon_voltage_droop;       // Min sample below average of last measure window, [mV]
+extern uint16_t sysmon_max_voltage_droop;   // Max voltage droop from power on, [mV]
 
 
 extern void sysmon_init(void);
@@ -0,0 +1,79 @@
+//  ***************************************************************************
+/// @file    fast_math.h
+/// @author  NeoProg
+/// @brief   Polynomial approximations of libm functions for the IK kernel
+/// @note    Host compilable. Errors are given for the whole input range
+//  ***************************************************************************
+#ifndef _FAST_MATH_H_
+#define _FAST_MATH_H_
+
+#include <stdbool.h>
+#include <math.h>
+
+#define FAST_MATH_PI                        (3.14159265f)
+#define FAST_MATH_PI_2                      (1.57079633f)
+
+
+//  ***************************************************************************
+/// @brief  Square root
+/// @note   sqrtf() is translated to VSQRT.F32 on Cortex-M4F. Do not use sqrt(),
+///         double precision is emulated in software
+/// @param  x: value
+/// @return sqrt(x)
+//  ***************************************************************************
+static inline float fast_sqrtf(float x) {
+    return sqrtf(x);
+}
+
+//  ***************************************************************************
+/// @brief  Arc tangent of two variables
+/// @note   9th order minimax polynomial on [0; 1] with octant reduction.
+///         Max error 1e-5 rad
+/// @param  y: y coordinate
+/// @param  x: x coordinate
+/// @return angle [-PI; PI]
+//  ***************************************************************************
+static inline float fast_atan2f(float y, float x) {
+
+    float abs_x = fabsf(x);
+    float abs_y = fabsf(y);
+    if (abs_x == 0.0f && abs_y == 0.0f) {
+        return 0.0f;
+    }
+
+    // Reduce to [0; 1]
+    bool is_swapped = abs_y > abs_x;
+    float t  = is_swapped ? (abs_x / abs_y) : (abs_y / abs_x);
+    float t2 = t * t;
+    float angle = t * (0.9998660f + t2 * (-0.3302995f + t2 * (0.1801410f + t2 * (-0.0851330f + t2 * 0.0208351f))));
+
+    // Restore octant
+    if (is_swapped) angle = FAST_MATH_PI_2 - angle;
+    if (x < 0.0f)   angle = FAST_MATH_PI - angle;
+    if (y < 0.0f)   angle = -angle;
+    return angle;
+}
+
+//  ***************************************************************************
+/// @brief  Arc cosine
+/// @note   Abramowitz & Stegun 4.4.46. Input is saturated to [-1; 1].
+///         Max error 2e-8 rad (float rounding dominates)
+/// @param  x: value
+/// @return angle [0; PI]
+//  ***************************************************************************
+static inline float fast_acosf(float x) {
+
+    float abs_x = fabsf(x);
+    if (abs_x > 1.0f) {
+        abs_x = 1.0f;
+    }
+
+    float poly = 1.5707963050f + abs_x * (-0.2145988016f + abs_x * (0.0889789874f + abs_x * (-0.0501743046f +
+                 abs_x * (0.0308918810f + abs_x * (-0.0170881256f + abs_x * (0.0066700901f + abs_x * -0.0012624911f))))));
+    float angle = fast_sqrtf(1.0f - abs_x) * poly;
+
+    return (x < 0.0f) ? (FAST_MATH_PI - angle) : angle;
+}
+
+
+#endif // _FAST_MATH_H_
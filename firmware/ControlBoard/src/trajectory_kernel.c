@@ -0,0 +1,110 @@
+//  ***************************************************************************
+/// @file    trajectory_kernel.c
+/// @author  NeoProg
+/// @note    Linear limb position is P(t) = base + t * slope for all linear
+///          trajectory types: time inversion is folded to base and slope
+///          (base = dest, slope = start - dest), hold trajectory has zero
+///          slope. Lift height sin(pi * t) is same for both time directions,
+///          so it is calculated once per tick for all limbs. Motion time is
+///          stretched to last evaluated tick t_last (motion ends before
+///          time_stop): t = time / t_last, then limb reaches destination and
+///          foot touches ground on last tick. Joint space trajectory limbs
+///          get nominal (linear) positions
+//  ***************************************************************************
+#include "trajectory_kernel.h"
+#include <math.h>
+
+#define M_PI_F                              (3.14159265f)
+
+
+//  ***************************************************************************
+/// @brief  Build packed coefficients of linear trajectories
+/// @note   Call on motion start, after start positions initialization
+/// @param  motion_config: motion configuration. @ref motion_config_t
+/// @param  last_tick_time: motion time of last motion tick [0; 1]
+/// @param  kernel: kernel coefficients. @ref linear_kernel_t
+/// @retval kernel
+/// @return none
+//  ***************************************************************************
+void trajectory_kernel_build_linear(const motion_config_t* motion_config, float last_tick_time, linear_kernel_t* kernel) {
+
+    kernel->count = 0;
+    kernel->is_lift_used = false;
+    kernel->time_scale = (last_tick_time > 0.0f && last_tick_time < 1.0f) ? 1.0f / last_tick_time : 1.0f;
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+
+        trajectory_t trajectory = motion_config->trajectories[i];
+        if (trajectory != TRAJECTORY_XYZ_LINEAR && trajectory != TRAJECTORY_XYZ_LINEAR_LIFT && trajectory != TRAJECTORY_XYZ_HOLD && 
+            trajectory != TRAJECTORY_JOINT_LINEAR) {
+            continue;
+        }
+
+        const point_3d_t* start = &motion_config->start_positions[i];
+        const point_3d_t* dest  = &motion_config->dest_positions[i];
+        uint32_t k = kernel->count++;
+        kernel->limbs[k] = i;
+        kernel->lift[k]  = (trajectory == TRAJECTORY_XYZ_LINEAR_LIFT) ? (float)LIMB_STEP_HEIGHT : 0.0f;
+        kernel->is_lift_used |= (trajectory == TRAJECTORY_XYZ_LINEAR_LIFT);
+
+        if (trajectory == TRAJECTORY_XYZ_HOLD) {
+            kernel->base_x[k]  = start->x;
+            kernel->base_y[k]  = start->y;
+            kernel->base_z[k]  = start->z;
+            kernel->slope_x[k] = 0;
+            kernel->slope_y[k] = 0;
+            kernel->slope_z[k] = 0;
+        }
+        else if (motion_config->time_directions[i] == TIME_DIR_REVERSE) {
+            kernel->base_x[k]  = dest->x;
+            kernel->base_y[k]  = dest->y;
+            kernel->base_z[k]  = dest->z;
+            kernel->slope_x[k] = start->x - dest->x;
+            kernel->slope_y[k] = start->y - dest->y;
+            kernel->slope_z[k] = start->z - dest->z;
+        }
+        else {
+            kernel->base_x[k]  = start->x;
+            kernel->base_y[k]  = start->y;
+            kernel->base_z[k]  = start->z;
+            kernel->slope_x[k] = dest->x - start->x;
+            kernel->slope_y[k] = dest->y - start->y;
+            kernel->slope_z[k] = dest->z - start->z;
+        }
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Calculate limbs positions of linear trajectories
+/// @note   Packed items are calculated by one branchless loop, after that
+///         positions are scattered to limbs
+/// @param  kernel: kernel coefficients. @ref linear_kernel_t
+/// @param  motion_time: current motion time [0; 1]
+/// @param  x, y, z: limbs positions (indexed by limb)
+/// @retval x, y, z
+/// @return none
+//  ***************************************************************************
+void trajectory_kernel_process_linear(const linear_kernel_t* kernel, float motion_time, float* x, float* y, float* z) {
+
+    uint32_t count = kernel->count;
+    if (count == 0) {
+        return;
+    }
+
+    float px[SUPPORT_LIMBS_COUNT];
+    float py[SUPPORT_LIMBS_COUNT];
+    float pz[SUPPORT_LIMBS_COUNT];
+    float t = fminf(motion_time * kernel->time_scale, 1.0f);
+    float height = kernel->is_lift_used ? sinf(t * M_PI_F) : 0.0f;
+    for (uint32_t k = 0; k < count; ++k) {
+        px[k] = kernel->base_x[k] + t * kernel->slope_x[k];
+        py[k] = kernel->base_y[k] + t * kernel->slope_y[k] + kernel->lift[k] * height;
+        pz[k] = kernel->base_z[k] + t * kernel->slope_z[k];
+    }
+
+    for (uint32_t k = 0; k < count; ++k) {
+        uint32_t i = kernel->limbs[k];
+        x[i] = px[k];
+        y[i] = py[k];
+        z[i] = pz[k];
+    }
+}
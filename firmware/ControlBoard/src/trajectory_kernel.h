@@ -0,0 +1,34 @@
+//  ***************************************************************************
+/// @file    trajectory_kernel.h
+/// @author  NeoProg
+/// @brief   Batched kernel for linear trajectories
+/// @note    Host compilable (no hardware dependencies)
+//  ***************************************************************************
+#ifndef _TRAJECTORY_KERNEL_H_
+#define _TRAJECTORY_KERNEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "motion_core.h"
+
+
+typedef struct {
+    uint32_t count;                                 // Packed limbs count
+    bool     is_lift_used;                          // At least one packed limb has lift
+    uint32_t limbs[SUPPORT_LIMBS_COUNT];            // Limb index of packed item
+    float    base_x[SUPPORT_LIMBS_COUNT];           // Position at motion time 0 (time direction is folded in)
+    float    base_y[SUPPORT_LIMBS_COUNT];
+    float    base_z[SUPPORT_LIMBS_COUNT];
+    float    slope_x[SUPPORT_LIMBS_COUNT];          // Position change for motion time [0; 1]
+    float    slope_y[SUPPORT_LIMBS_COUNT];
+    float    slope_z[SUPPORT_LIMBS_COUNT];
+    float    lift[SUPPORT_LIMBS_COUNT];             // Lift height: LIMB_STEP_HEIGHT for TRAJECTORY_XYZ_LINEAR_LIFT, 0 - other
+    float    time_scale;                            // 1 / motion time of last tick. Destination is reached on last tick
+} linear_kernel_t;
+
+
+extern void trajectory_kernel_build_linear(const motion_config_t* motion_config, float last_tick_time, linear_kernel_t* kernel);
+extern void trajectory_kernel_process_linear(const linear_kernel_t* kernel, float motion_time, float* x, float* y, float* z);
+
+
+#endif // _TRAJECTORY_KERNEL_H_
@@ -0,0 +1,320 @@
+//  ***************************************************************************
+/// @file    transition_planner.c
+/// @author  NeoProg
+//  ***************************************************************************
+#include "transition_planner.h"
+#include <string.h>
+
+
+typedef struct {
+    point_3d_t main_exit[SUPPORT_LIMBS_COUNT];      // Pose after main motions of source sequence
+    point_3d_t finalize_exit[SUPPORT_LIMBS_COUNT];  // Pose after finalize motions of source sequence
+    point_3d_t prepare_exit[SUPPORT_LIMBS_COUNT];   // Pose after prepare motions of destination sequence
+} transition_poses_t;
+
+
+static bool is_sequence_plannable(const packed_sequence_t* sequence);
+static void calculate_poses(const packed_sequence_t* from, const packed_sequence_t* to, const point_3d_t* start_positions, transition_poses_t* poses);
+static void move_pose(const packed_sequence_t* sequence, uint32_t begin, uint32_t end, point_3d_t* pose);
+static uint32_t calculate_duration(const packed_sequence_t* sequence, uint32_t begin, uint32_t end);
+static bool is_entry_compatible(const point_3d_t* pose, const point_3d_t* expected, const motion_config_t* motion);
+static bool merge_motions(const motion_config_t* finalize, const motion_config_t* prepare, const transition_poses_t* poses, motion_config_t* bridge);
+static bool is_point_equal(const point_3d_t* a, const point_3d_t* b);
+static bool is_footprint_equal(const point_3d_t* a, const point_3d_t* b);
+
+
+//  ***************************************************************************
+/// @brief  Plan transition between sequences
+/// @note   Transition starts after main motions of source sequence. Path cost
+///         is motions duration in motion ticks. Sequences which use advanced
+///         trajectories or motions without initialization of start positions
+///         are not planned (their poses depend on runtime configuration)
+/// @param  from: source sequence (NULL - sequence is not packed)
+/// @param  to: destination sequence (NULL - sequence is not packed)
+/// @param  start_positions: limbs positions before prepare motions of any sequence
+/// @return transition flags by TRANSITION_xxx
+//  ***************************************************************************
+uint8_t transition_planner_plan(const packed_sequence_t* from, const packed_sequence_t* to, const point_3d_t* start_positions) {
+
+    if (from == to || is_sequence_plannable(from) == false || is_sequence_plannable(to) == false) {
+        return TRANSITION_DEFAULT;
+    }
+
+    transition_poses_t poses;
+    calculate_poses(from, to, start_positions, &poses);
+
+    uint32_t finalize_cost = calculate_duration(from, from->finalize_motions_begin, from->total_motions_count);
+    uint32_t prepare_cost = calculate_duration(to, 0, to->main_motions_begin);
+
+    motion_config_t prepare_motion;
+    motion_config_t main_motion;
+    sequence_codec_decode_motion(&to->motion_list[0], &prepare_motion);
+    sequence_codec_decode_motion(&to->motion_list[to->main_motions_begin], &main_motion);
+
+    uint8_t best_transition = TRANSITION_DEFAULT;
+    uint32_t best_cost = finalize_cost + prepare_cost;
+
+    // Prepare motions start from main exit pose
+    if (finalize_cost != 0 && prepare_cost != 0 && prepare_cost < best_cost &&
+        is_entry_compatible(poses.main_exit, poses.finalize_exit, &prepare_motion) == true) {
+        best_transition = TRANSITION_FINALIZE_SKIPPED;
+        best_cost = prepare_cost;
+    }
+
+    // Main motions start from finalize exit pose
+    if (prepare_cost != 0 && finalize_cost < best_cost &&
+        is_entry_compatible(poses.finalize_exit, poses.prepare_exit, &main_motion) == true) {
+        best_transition = TRANSITION_PREPARE_SKIPPED;
+        best_cost = finalize_cost;
+    }
+
+    // Main motions start from main exit pose
+    if (finalize_cost != 0 && best_cost != 0 &&
+        is_entry_compatible(poses.main_exit, poses.prepare_exit, &main_motion) == true) {
+        best_transition = TRANSITION_FINALIZE_SKIPPED | TRANSITION_PREPARE_SKIPPED;
+        best_cost = 0;
+    }
+
+    // Single finalize and prepare motions are merged
+    uint32_t finalize_count = from->total_motions_count - from->finalize_motions_begin;
+    if (finalize_count == 1 && to->main_motions_begin == 1 && best_cost != 0) {
+
+        motion_config_t finalize_motion;
+        motion_config_t bridge;
+        sequence_codec_decode_motion(&from->motion_list[from->finalize_motions_begin], &finalize_motion);
+        if (merge_motions(&finalize_motion, &prepare_motion, &poses, &bridge) == true) {
+            uint32_t bridge_cost = (bridge.time_stop - bridge.motion_time + bridge.time_step - 1) / bridge.time_step;
+            if (bridge_cost < best_cost) {
+                best_transition = TRANSITION_BRIDGE_USED;
+                best_cost = bridge_cost;
+            }
+        }
+    }
+    return best_transition;
+}
+
+//  ***************************************************************************
+/// @brief  Build bridge motion for transition
+/// @param  from: source sequence
+/// @param  to: destination sequence
+/// @param  start_positions: limbs positions before prepare motions of any sequence
+/// @param  bridge: bridge motion. @ref motion_config_t
+/// @retval bridge
+/// @return true - success, false - motions can not be merged
+//  ***************************************************************************
+bool transition_planner_build_bridge(const packed_sequence_t* from, const packed_sequence_t* to, const point_3d_t* start_positions, motion_config_t* bridge) {
+
+    if (from == NULL || to == NULL || from->finalize_motions_begin >= from->total_motions_count || to->main_motions_begin == 0) {
+        return false;
+    }
+
+    transition_poses_t poses;
+    calculate_poses(from, to, start_positions, &poses);
+
+    motion_config_t finalize_motion;
+    motion_config_t prepare_motion;
+    sequence_codec_decode_motion(&from->motion_list[from->finalize_motions_begin], &finalize_motion);
+    sequence_codec_decode_motion(&to->motion_list[0], &prepare_motion);
+    return merge_motions(&finalize_motion, &prepare_motion, &poses, bridge);
+}
+
+
+
+
+
+//  ***************************************************************************
+/// @brief  Check sequence poses are known before start
+/// @param  sequence: sequence. @ref packed_sequence_t
+/// @return true - sequence can be planned, false - no
+//  ***************************************************************************
+static bool is_sequence_plannable(const packed_sequence_t* sequence) {
+
+    if (sequence == NULL || sequence->main_motions_begin >= sequence->finalize_motions_begin) {
+        return false;
+    }
+    for (uint32_t m = 0; m < sequence->total_motions_count; ++m) {
+
+        motion_config_t motion;
+        sequence_codec_decode_motion(&sequence->motion_list[m], &motion);
+        if (motion.is_need_init_start_position == false) {
+            return false;
+        }
+        for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+            if (motion.trajectories[i] == TRAJECTORY_XZ_ADV_Y_CONST || motion.trajectories[i] == TRAJECTORY_XZ_ADV_Y_SINUS ||
+                motion.trajectories[i] == TRAJECTORY_XZ_ADV_Y_GAIT) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Calculate poses of transition
+/// @param  from: source sequence
+/// @param  to: destination sequence
+/// @param  start_positions: limbs positions before prepare motions of any sequence
+/// @param  poses: transition poses. @ref transition_poses_t
+/// @retval poses
+/// @return none
+//  ***************************************************************************
+static void calculate_poses(const packed_sequence_t* from, const packed_sequence_t* to, const point_3d_t* start_positions, transition_poses_t* poses) {
+
+    memcpy(poses->main_exit, start_positions, sizeof(poses->main_exit));
+    move_pose(from, 0, from->finalize_motions_begin, poses->main_exit);
+
+    memcpy(poses->finalize_exit, poses->main_exit, sizeof(poses->finalize_exit));
+    move_pose(from, from->finalize_motions_begin, from->total_motions_count, poses->finalize_exit);
+
+    memcpy(poses->prepare_exit, poses->finalize_exit, sizeof(poses->prepare_exit));
+    move_pose(to, 0, to->main_motions_begin, poses->prepare_exit);
+}
+
+//  ***************************************************************************
+/// @brief  Move pose by sequence motions
+/// @note   Limb stays in start position after reverse motion
+/// @param  sequence: sequence. @ref packed_sequence_t
+/// @param  begin: first motion index
+/// @param  end: motion index after last motion
+/// @param  pose: limbs positions
+/// @retval pose
+/// @return none
+//  ***************************************************************************
+static void move_pose(const packed_sequence_t* sequence, uint32_t begin, uint32_t end, point_3d_t* pose) {
+
+    for (uint32_t m = begin; m < end; ++m) {
+
+        motion_config_t motion;
+        sequence_codec_decode_motion(&sequence->motion_list[m], &motion);
+        for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+            if (motion.trajectories[i] != TRAJECTORY_XYZ_HOLD && motion.time_directions[i] == TIME_DIR_DIRECT) {
+                pose[i] = motion.dest_positions[i];
+            }
+        }
+    }
+}
+
+//  ***************************************************************************
+/// @brief  Calculate motions duration
+/// @param  sequence: sequence. @ref packed_sequence_t
+/// @param  begin: first motion index
+/// @param  end: motion index after last motion
+/// @return duration, [motion ticks]
+//  ***************************************************************************
+static uint32_t calculate_duration(const packed_sequence_t* sequence, uint32_t begin, uint32_t end) {
+
+    uint32_t duration = 0;
+    for (uint32_t m = begin; m < end; ++m) {
+        const packed_motion_t* motion = &sequence->motion_list[m];
+        duration += (motion->time_stop - motion->motion_time + motion->time_step - 1) / motion->time_step;
+    }
+    return duration;
+}
+
+//  ***************************************************************************
+/// @brief  Check motion can be started from other pose
+/// @note   Motion should move all limbs which positions are differ from
+///         expected pose. Feet on ground can not be moved (limb X and Z
+///         should be same), body height and tilt can be changed
+/// @param  pose: limbs positions
+/// @param  expected: limbs positions expected by motion
+/// @param  motion: motion configuration. @ref motion_config_t
+/// @return true - motion can be started from pose, false - no
+//  ***************************************************************************
+static bool is_entry_compatible(const point_3d_t* pose, const point_3d_t* expected, const motion_config_t* motion) {
+
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+
+        if (is_point_equal(&pose[i], &expected[i]) == true) {
+            continue;
+        }
+        if (is_footprint_equal(&pose[i], &expected[i]) == false) {
+            return false;
+        }
+        trajectory_t trajectory = motion->trajectories[i];
+        if (trajectory == TRAJECTORY_XYZ_HOLD || motion->time_directions[i] != TIME_DIR_DIRECT) {
+            return false;
+        }
+        if (motion_core_check_path(i, &pose[i], &motion->dest_positions[i], trajectory == TRAJECTORY_XYZ_LINEAR_LIFT) == false) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//  ***************************************************************************
+/// @brief  Merge finalize and prepare motions to bridge motion
+/// @note   Each limb should be moved by one motion only, limb keeps own
+///         trajectory. Other limbs are moved linear to own pose, so bridge
+///         motion can be started from any limbs positions (preemption).
+///         Not more than half of limbs can change footprint
+/// @param  finalize: finalize motion of source sequence
+/// @param  prepare: prepare motion of destination sequence
+/// @param  poses: transition poses. @ref transition_poses_t
+/// @param  bridge: bridge motion. @ref motion_config_t
+/// @retval bridge
+/// @return true - success, false - motions can not be merged
+//  ***************************************************************************
+static bool merge_motions(const motion_config_t* finalize, const motion_config_t* prepare, const transition_poses_t* poses, motion_config_t* bridge) {
+
+    if (finalize->motion_time != MTIME_MIN_VALUE || finalize->time_stop != MTIME_MAX_VALUE ||
+        prepare->motion_time != MTIME_MIN_VALUE || prepare->time_stop != MTIME_MAX_VALUE) {
+        return false;
+    }
+
+    memset(bridge, 0, sizeof(motion_config_t));
+    uint32_t swing_limbs_count = 0;
+    for (uint32_t i = 0; i < SUPPORT_LIMBS_COUNT; ++i) {
+
+        bool is_finalize_moved = is_point_equal(&poses->main_exit[i], &poses->finalize_exit[i]) == false;
+        bool is_prepare_moved = is_point_equal(&poses->finalize_exit[i], &poses->prepare_exit[i]) == false;
+        if (is_finalize_moved && is_prepare_moved) {
+            return false;
+        }
+        if (finalize->time_directions[i] != TIME_DIR_DIRECT || prepare->time_directions[i] != TIME_DIR_DIRECT) {
+            return false;
+        }
+
+        bridge->time_directions[i] = TIME_DIR_DIRECT;
+        bridge->dest_positions[i] = poses->prepare_exit[i];
+        bridge->trajectories[i] = TRAJECTORY_XYZ_LINEAR;
+        if (is_finalize_moved == false && is_prepare_moved == false) {
+            continue;
+        }
+
+        const motion_config_t* source = is_prepare_moved ? prepare : finalize;
+        trajectory_t trajectory = source->trajectories[i];
+        if (trajectory != TRAJECTORY_XYZ_LINEAR && trajectory != TRAJECTORY_XYZ_LINEAR_LIFT && trajectory != TRAJECTORY_JOINT_LINEAR) {
+            return false;
+        }
+        bridge->trajectories[i] = trajectory;
+        if (is_footprint_equal(&poses->main_exit[i], &poses->prepare_exit[i]) == false) {
+            ++swing_limbs_count;
+        }
+    }
+
+    bridge->motion_time = MTIME_MIN_VALUE;
+    bridge->time_stop   = MTIME_MAX_VALUE;
+    bridge->time_update = MTIME_NO_UPDATE;
+    bridge->time_step   = (finalize->time_step < prepare->time_step) ? finalize->time_step : prepare->time_step;
+    bridge->is_need_init_start_position = true;
+    return swing_limbs_count <= SUPPORT_LIMBS_COUNT / 2;
+}
+
+//  ***************************************************************************
+/// @brief  Compare limbs positions
+/// @param  a, b: limb positions
+/// @return true - positions are equal, false - no
+//  ***************************************************************************
+static bool is_point_equal(const point_3d_t* a, const point_3d_t* b) {
+    return a->x == b->x && a->y == b->y && a->z == b->z;
+}
+
+//  ***************************************************************************
+/// @brief  Compare limbs footprints (positions without height)
+/// @param  a, b: limb positions
+/// @return true - footprints are equal, false - no
+//  ***************************************************************************
+static bool is_footprint_equal(const point_3d_t* a, const point_3d_t* b) {
+    return a->x == b->x && a->z == b->z;
+}
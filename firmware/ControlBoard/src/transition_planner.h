@@ -0,0 +1,31 @@
+//  ***************************************************************************
+/// @file    transition_planner.h
+/// @author  NeoProg
+/// @brief   Transition planner between packed sequences
+/// @note    Transition from main motions of one sequence to main motions of
+///          other is a path over poses graph: main exit pose -> finalize exit
+///          pose -> prepare exit pose. Finalize and prepare edges are motions
+///          of sequences, pose can be skipped if next motion re-targets all
+///          differing limbs without moving feet on ground (X and Z are same),
+///          single finalize and prepare motions which move different limbs
+///          are merged to bridge motion. Shortest path is selected
+//  ***************************************************************************
+#ifndef _TRANSITION_PLANNER_H_
+#define _TRANSITION_PLANNER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "motion_core.h"
+#include "sequence_codec.h"
+
+#define TRANSITION_DEFAULT                  (0x00)      // Finalize motions, then prepare motions
+#define TRANSITION_FINALIZE_SKIPPED         (0x01)
+#define TRANSITION_PREPARE_SKIPPED          (0x02)
+#define TRANSITION_BRIDGE_USED              (0x04)      // Finalize and prepare motions are replaced by bridge motion
+
+
+extern uint8_t transition_planner_plan(const packed_sequence_t* from, const packed_sequence_t* to, const point_3d_t* start_positions);
+extern bool transition_planner_build_bridge(const packed_sequence_t* from, const packed_sequence_t* to, const point_3d_t* start_positions, motion_config_t* bridge);
+
+
+#endif // _TRANSITION_PLANNER_H_
@@ -22,7 +22,15 @@
 #define SWLP_CMD_SELECT_SEQUENCE_DANCE                  (0x09)
 #define SWLP_CMD_SELECT_SEQUENCE_ROTATE_X               (0x10)
 #define SWLP_CMD_SELECT_SEQUENCE_ROTATE_Z               (0x11)
+#define SWLP_CMD_SELECT_SEQUENCE_USER_0                 (0x20)
+#define SWLP_CMD_SELECT_SEQUENCE_USER_1                 (0x21)
+#define SWLP_CMD_SELECT_SEQUENCE_USER_2                 (0x22)
+#define SWLP_CMD_SELECT_SEQUENCE_USER_3                 (0x23)
 #define SWLP_CMD_SELECT_SEQUENCE_NONE                   (0x90)
+#define SWLP_CMD_CUE_CLEAR                              (0xA0)
+#define SWLP_CMD_CUE_WRITE                              (0xA1)  // Write cue to cue_index (cue command, curvature, distance, cue speed)
+#define SWLP_CMD_CUE_START                              (0xA2)  // Start show after cue_start_time
+#define SWLP_CMD_CUE_STOP                               (0xA3)
 
 //
 // SWLP command status
@@ -42,7 +50,19 @@ struct swlp_command_payload_t {
     uint8_t command;
     uint8_t step_length;
     int16_t curvature;
-    uint8_t reserved[22];
+    uint16_t speed;         // Motion speed [%]. 0 - do not change
+    int8_t  pose_roll;      // Body pose [degree]
+    int8_t  pose_pitch;
+    int8_t  pose_yaw;
+    int8_t  pose_x;         // Body pose [mm]
+    int8_t  pose_y;
+    int8_t  pose_z;
+    uint8_t gait;           // Walk gait: 0 - tripod, 1 - ripple, 2 - wave
+    uint8_t cue_index;      // Cue queue commands
+    uint32_t cue_start_time;// Cue start time from show start [ms]
+    uint8_t cue_command;    // SWLP_CMD_SELECT_SEQUENCE_xxx
+    uint16_t cue_speed;     // Cue motion speed [%]. 0 - do not change
+    uint8_t reserved[5];
 };
 
 struct swlp_status_payload_t {